@@ -0,0 +1,47 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+/* Includes */
+#include <SDL2/SDL.h>
+#include <pong_bool.h>
+
+/* Defines */
+#define ASSET_LOADER_MAX_ASSETS (32)
+#define ASSET_LOADER_MAX_WORKERS (4)
+#define ASSET_LOADER_MAX_PATH_LENGTH (512)
+#define ASSET_LOADER_INVALID_HANDLE (-1)
+
+/* Datatypes */
+enum asset_loader_asset_type {
+	ASSET_LOADER_ASSET_TYPE_IMAGE,
+	ASSET_LOADER_ASSET_TYPE_SOUND
+};
+
+enum asset_loader_state {
+	ASSET_LOADER_STATE_PENDING,
+	ASSET_LOADER_STATE_READY,
+	ASSET_LOADER_STATE_FAILED
+};
+
+/* Invoked on the thread polling the loader - The one owning the GL context */
+typedef void (* asset_loader_completion_tf)(int asset_handle, void * p_user_data);
+
+/* Interface function definitions */
+pong_bool_te asset_loader_initialize(void);
+int asset_loader_load
+(
+	enum asset_loader_asset_type asset_type,
+	const char * p_resource_path,
+	asset_loader_completion_tf completion,
+	void * p_user_data
+);
+void asset_loader_poll(void);
+enum asset_loader_state asset_loader_wait(int asset_handle);
+enum asset_loader_state asset_loader_state(int asset_handle);
+SDL_Surface * asset_loader_image(int asset_handle);
+pong_bool_te asset_loader_find_resource(const char * p_resource_path, const Uint8 ** pp_data, size_t * p_length);
+pong_bool_te asset_loader_sound(int asset_handle, Uint8 ** pp_samples, Uint32 * p_samples_length);
+void asset_loader_release(int asset_handle);
+void asset_loader_cleanup(void);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef AUDIO_BANK_H
+#define AUDIO_BANK_H
+
+/* Includes */
+#include <SDL2/SDL.h>
+#include <pong_bool.h>
+
+/* Defines */
+#define AUDIO_BANK_MAGIC (0x4b4e4250u)
+#define AUDIO_BANK_VERSION (1u)
+#define AUDIO_BANK_ALIGNMENT (64u)
+#define AUDIO_BANK_MAX_NAME_LENGTH (32)
+
+/* Sample format of every bank - Interleaved stereo at 44.1 kHz */
+#define AUDIO_BANK_FREQUENCY (44100)
+#define AUDIO_BANK_FORMAT (AUDIO_S16SYS)
+#define AUDIO_BANK_CHANNELS (2)
+
+/* Datatypes */
+
+/*
+	Bank file layout - Header, entry table, then the sample data of every entry
+	at an AUDIO_BANK_ALIGNMENT aligned offset, already in the mixer output format
+*/
+struct audio_bank_header {
+	Uint32 magic;
+	Uint32 version;
+	Sint32 frequency;
+	Uint16 format;
+	Uint16 channels;
+	Uint32 entry_count;
+	Uint32 reserved;
+};
+
+struct audio_bank_entry {
+	char name[AUDIO_BANK_MAX_NAME_LENGTH];
+	Uint32 offset;
+	Uint32 length;
+};
+
+/* Memory-mapped bank - Or a view into memory owned by someone else */
+struct audio_bank {
+	Uint8 * p_mapping;
+	size_t mapping_size;
+	pong_bool_te owns_mapping;
+	const struct audio_bank_header * p_header;
+	const struct audio_bank_entry * p_entries;
+};
+
+/* Interface function definitions */
+pong_bool_te audio_bank_open(const char * p_path, struct audio_bank * p_out_bank);
+pong_bool_te audio_bank_open_memory(const Uint8 * p_data, size_t length, struct audio_bank * p_out_bank);
+pong_bool_te audio_bank_matches_format(const struct audio_bank * p_bank, int frequency, Uint16 format, int channels);
+pong_bool_te audio_bank_find(const struct audio_bank * p_bank, const char * p_name, Uint8 ** p_out_samples, Uint32 * p_out_length);
+void audio_bank_close(struct audio_bank * p_bank);
+pong_bool_te audio_bank_load_converted_wav(const char * p_path, Uint8 ** p_out_samples, Uint32 * p_out_length);
+pong_bool_te audio_bank_load_converted_wav_memory(const Uint8 * p_data, size_t length, const char * p_name, Uint8 ** p_out_samples, Uint32 * p_out_length);
+
+#endif
\ No newline at end of file
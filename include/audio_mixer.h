@@ -0,0 +1,58 @@
+#ifndef AUDIO_MIXER_H
+#define AUDIO_MIXER_H
+
+/* Includes */
+#include <SDL2/SDL.h>
+#include <pong_bool.h>
+
+/* Defines */
+#define AUDIO_MIXER_FREQUENCY (44100)
+#define AUDIO_MIXER_FORMAT (AUDIO_S16SYS)
+#define AUDIO_MIXER_CHANNELS (2)
+#define AUDIO_MIXER_MIN_BUFFER_FRAMES (256)
+#define AUDIO_MIXER_MAX_BUFFER_FRAMES (512)
+#define AUDIO_MIXER_MAX_VOICES (16)
+#define AUDIO_MIXER_COMMAND_QUEUE_CAPACITY (64)
+#define AUDIO_MIXER_CHECKSUM_SEED (0xcbf29ce484222325ULL)
+
+/* Datatypes */
+enum audio_mixer_priority {
+	AUDIO_MIXER_PRIORITY_LOW,
+	AUDIO_MIXER_PRIORITY_NORMAL,
+	AUDIO_MIXER_PRIORITY_HIGH
+};
+
+/* Interleaved stereo frames in the mixer format - Owned by the caller */
+struct audio_mixer_sound {
+	const Sint16 * p_frames;
+	Uint32 frame_count;
+
+	/* Voice policy - Instances beyond the limit restart the oldest one */
+	int max_instances;
+	enum audio_mixer_priority priority;
+};
+
+struct audio_mixer_latency {
+	double sum_in_milliseconds;
+	double max_in_milliseconds;
+	int samples;
+};
+
+struct audio_mixer_voice_stats {
+	int started;
+	int merged;
+	int stolen;
+	int dropped;
+};
+
+/* Interface function definitions */
+pong_bool_te audio_mixer_open(int buffer_frames);
+pong_bool_te audio_mixer_open_offline(int buffer_frames);
+int audio_mixer_render(double dt, Sint16 * p_output, int max_frames);
+Uint64 audio_mixer_checksum(Uint64 checksum, const Sint16 * p_samples, int sample_count);
+pong_bool_te audio_mixer_play(const struct audio_mixer_sound * p_sound, float gain, float pan);
+struct audio_mixer_latency audio_mixer_take_latency(void);
+struct audio_mixer_voice_stats audio_mixer_take_voice_stats(void);
+void audio_mixer_close(void);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,19 @@
+#ifndef AUDIO_MUSIC_H
+#define AUDIO_MUSIC_H
+
+/* Includes */
+#include <SDL2/SDL.h>
+#include <pong_bool.h>
+
+/* Defines */
+#define AUDIO_MUSIC_RING_FRAMES (16384)
+#define AUDIO_MUSIC_MAX_PATH_LENGTH (1024)
+
+/* Interface function definitions */
+pong_bool_te audio_music_initialize(void);
+void audio_music_play(const char * p_track_path, pong_bool_te loop);
+void audio_music_stop(void);
+void audio_music_mix(float * p_mix_buffer, int frame_count);
+void audio_music_cleanup(void);
+
+#endif
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 /* Includes */
 #include <pong_bool.h>
+#include <SDL2/SDL.h>
 
 /* Datatypes */
 enum audio_player_sfx_type {
@@ -14,9 +15,18 @@ enum audio_player_sfx_type {
 	AUDIO_PLAYER_SFX_TYPE_COUNT
 };
 
+enum audio_player_music_type {
+	AUDIO_PLAYER_MUSIC_TYPE_MENU,
+	AUDIO_PLAYER_MUSIC_TYPE_COUNT
+};
+
 /* Interface function definitions */
-pong_bool_te audio_player_initialize(void);
+pong_bool_te audio_player_initialize(pong_bool_te offline);
+void audio_player_advance(double dt);
+Uint64 audio_player_offline_checksum(void);
 pong_bool_te audio_player_play_sound_effect(enum audio_player_sfx_type sfx_type);
+pong_bool_te audio_player_play_music(enum audio_player_music_type music_type);
+void audio_player_stop_music(void);
 void audio_player_cleanup(void);
 
 #endif
\ No newline at end of file
@@ -4,9 +4,13 @@
 /* Includes */
 #include <pong_bool.h>
 #include <region2Di.h>
+#include <color4ub.h>
+
+/* Defines */
+#define BATCHER_INVALID_BLOCK (-1)
 
 /* Batcher function definitions */
-pong_bool_te batcher_initialize(void);
+pong_bool_te batcher_initialize(pong_bool_te core_profile);
 void batcher_cleanup(void);
 void batcher_color
 (
@@ -29,7 +33,24 @@ void batcher_quadf
   float max_x,
   float max_y
 );
+void batcher_sprite
+(
+  int sprite_handle,
+  float min_x,
+  float min_y,
+  float max_x,
+  float max_y
+);
+void batcher_particles
+(
+  int particle_count,
+  const float * p_positions_x,
+  const float * p_positions_y,
+  const float * p_sizes,
+  const struct color4ub * p_colors
+);
 void batcher_render(void);
+void batcher_canvas(int canvas_width, int canvas_height);
 pong_bool_te batcher_text_region
 (
   const char * p_text,
@@ -39,4 +60,17 @@ pong_bool_te batcher_text_region
   struct region2Di * p_out_region
 );
 
+/* Retained blocks - Static layers recorded once, uploaded to the GPU and drawn until invalidated, destroyed by their creator */
+int batcher_block_create(const char * p_name);
+void batcher_block_destroy(int block_handle);
+pong_bool_te batcher_block_record_begin(int block_handle);
+pong_bool_te batcher_block_record_end(void);
+pong_bool_te batcher_block_emit(int block_handle);
+void batcher_block_invalidate(int block_handle);
+
+/* Backdrops - Frozen copies of the frame rendered up to the capture, drawn as one textured quad */
+pong_bool_te batcher_backdrop_capture(int backdrop_index);
+pong_bool_te batcher_backdrop(int backdrop_index);
+void batcher_backdrop_invalidate(int backdrop_index);
+
 #endif
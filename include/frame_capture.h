@@ -0,0 +1,43 @@
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+/* Includes */
+#include <SDL2/SDL.h>
+#include <pong_bool.h>
+
+/* Defines */
+#define FRAME_CAPTURE_PIXEL_BUFFER_COUNT (3)
+#define FRAME_CAPTURE_QUEUE_LENGTH (8)
+#define FRAME_CAPTURE_MAX_PATH_LENGTH (256)
+
+/*
+  Frame capture - Reads the rendered frame back into a ring of pixel buffer objects
+  and maps each one only once it is frames behind, so the GPU never has to catch up
+  on the spot. Mapped frames are copied into a queue for the writer thread which
+  converts and writes them to disk. Frames are dropped rather than waited for when
+  the writer falls behind.
+*/
+
+/* Datatypes */
+enum frame_capture_format {
+  FRAME_CAPTURE_FORMAT_Y4M,
+  FRAME_CAPTURE_FORMAT_PNG
+};
+
+struct frame_capture_stats {
+  double sum_in_milliseconds;
+  double max_in_milliseconds;
+  int frames;
+  int dropped;
+};
+
+/* Function prototypes */
+pong_bool_te frame_capture_initialize(enum frame_capture_format format, const char * p_path_prefix, int frame_rate);
+pong_bool_te frame_capture_start(void);
+pong_bool_te frame_capture_recording(void);
+void frame_capture_read(int x, int y, int width, int height);
+void frame_capture_stop(void);
+struct frame_capture_stats frame_capture_take_stats(void);
+void frame_capture_cleanup(void);
+
+#endif
\ No newline at end of file
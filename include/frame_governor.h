@@ -0,0 +1,22 @@
+#ifndef FRAME_GOVERNOR_H
+#define FRAME_GOVERNOR_H
+
+/* Includes */
+#include <pong_bool.h>
+
+/*
+  Frame governor - Watches rolling frame cost percentiles against a target frame time
+  and steps through quality levels, 0 being the highest. The cost of a frame is the
+  larger of its CPU work up to the buffer swap and its GPU time, so waiting on vsync
+  never reads as load.
+*/
+
+/* Function prototypes */
+void frame_governor_initialize(double target_frame_ms, int level_count, pong_bool_te gpu_timing);
+void frame_governor_gpu_begin(void);
+void frame_governor_gpu_end(void);
+pong_bool_te frame_governor_frame(double cpu_frame_ms, int * p_out_level);
+int frame_governor_level(void);
+void frame_governor_cleanup(void);
+
+#endif
\ No newline at end of file
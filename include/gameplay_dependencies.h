@@ -13,10 +13,23 @@ struct gameplay_dependencies_batcher {
 	void (* text)(const char * p_text, int base_x, int base_y, int font_height);
 	pong_bool_te (* text_region)(const char * p_text,int base_x,int base_y, int font_height, struct region2Di * p_out_region);
 	void (* quadf)(float min_x, float min_y, float max_x, float max_y);
+	void (* sprite)(int sprite_handle, float min_x, float min_y, float max_x, float max_y);
+	void (* particles)(int particle_count, const float * p_positions_x, const float * p_positions_y, const float * p_sizes, const struct color4ub * p_colors);
+	int (* block_create)(const char * p_name);
+	void (* block_destroy)(int block_handle);
+	pong_bool_te (* block_record_begin)(int block_handle);
+	pong_bool_te (* block_record_end)(void);
+	pong_bool_te (* block_emit)(int block_handle);
+	void (* block_invalidate)(int block_handle);
+	pong_bool_te (* backdrop_capture)(int backdrop_index);
+	pong_bool_te (* backdrop)(int backdrop_index);
+	void (* backdrop_invalidate)(int backdrop_index);
 };
 
 struct gameplay_dependencies_audio {
 	pong_bool_te (* play_sound_effect)(enum audio_player_sfx_type sfx_type);
+	pong_bool_te (* play_music)(enum audio_player_music_type music_type);
+	void (* stop_music)(void);
 };
 
 struct gameplay_dependencies_input {
@@ -24,9 +37,12 @@ struct gameplay_dependencies_input {
 	pong_bool_te (* key_pressed)(enum input_mapper_key_type custom_key_type);
 	pong_bool_te (* key_held)(enum input_mapper_key_type custom_key_type);
 	pong_bool_te (* key_released)(enum input_mapper_key_type custom_key_type);
+	float (* key_held_fraction)(enum input_mapper_key_type custom_key_type);
+	float (* key_amount)(enum input_mapper_key_type custom_key_type);
 };
 
 struct gameplay_dependencies_windowing {
+	/* Virtual canvas size - Fixed no matter the window size or display mode */
 	int window_width;
 	int window_height;
 	void (* hook_close_window)(void);
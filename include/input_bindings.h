@@ -0,0 +1,12 @@
+#ifndef INPUT_BINDINGS_H
+#define INPUT_BINDINGS_H
+
+/* Includes */
+#include <pong_bool.h>
+#include <input_mapper.h>
+
+/* Interface function definitions */
+pong_bool_te input_bindings_load(struct input_mapper_instance * p_instance, const char * p_config_filename);
+pong_bool_te input_bindings_save(const struct input_mapper_instance * p_instance, const char * p_config_filename);
+
+#endif
\ No newline at end of file
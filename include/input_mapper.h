@@ -5,6 +5,17 @@
 #include <SDL2/SDL.h>
 #include <pong_bool.h>
 
+/* Defines */
+#define INPUT_MAPPER_MAX_KEY_TRANSITIONS (16)
+#define INPUT_MAPPER_MAX_BINDINGS_PER_KEY (4)
+#define INPUT_MAPPER_MAX_CONTROLLERS (4)
+#define INPUT_MAPPER_AXIS_DIRECTION_COUNT (2 * SDL_CONTROLLER_AXIS_MAX)
+
+/* Physical inputs - Scancodes followed by controller buttons and both directions of every controller axis */
+#define INPUT_MAPPER_PHYSICAL_INPUT_FIRST_BUTTON (SDL_NUM_SCANCODES)
+#define INPUT_MAPPER_PHYSICAL_INPUT_FIRST_AXIS (INPUT_MAPPER_PHYSICAL_INPUT_FIRST_BUTTON + SDL_CONTROLLER_BUTTON_MAX)
+#define INPUT_MAPPER_PHYSICAL_INPUT_COUNT (INPUT_MAPPER_PHYSICAL_INPUT_FIRST_AXIS + 2 * SDL_CONTROLLER_AXIS_MAX)
+
 /* Datatypes */
 enum input_mapper_key_type {
 	INPUT_MAPPER_KEY_TYPE_LEFT_PADDLE_UP,
@@ -24,51 +35,186 @@ enum input_mapper_key_type {
 	INPUT_MAPPER_KEY_TYPE_COUNT
 };
 
-enum input_mapper_key_state {
-	INPUT_MAPPER_KEY_STATE_NONE,
-	INPUT_MAPPER_KEY_STATE_PRESSED,
-	INPUT_MAPPER_KEY_STATE_HELD,
-	INPUT_MAPPER_KEY_STATE_RELEASED
+enum input_mapper_binding_type {
+	INPUT_MAPPER_BINDING_TYPE_NONE,
+	INPUT_MAPPER_BINDING_TYPE_KEY,
+	INPUT_MAPPER_BINDING_TYPE_CONTROLLER_BUTTON,
+	INPUT_MAPPER_BINDING_TYPE_CONTROLLER_AXIS_NEGATIVE,
+	INPUT_MAPPER_BINDING_TYPE_CONTROLLER_AXIS_POSITIVE
+};
+
+struct input_mapper_binding {
+	enum input_mapper_binding_type type;
+	int code;
+};
+
+struct input_mapper_key_transition {
+	Uint32 timestamp;
+	pong_bool_te down;
+};
+
+struct input_mapper_key_input {
+	pong_bool_te down;
+	pong_bool_te down_at_tick_begin;
+	int transition_count;
+	struct input_mapper_key_transition transitions[INPUT_MAPPER_MAX_KEY_TRANSITIONS];
+	float held_fraction;
+};
+
+struct input_mapper_controller {
+	SDL_GameController * p_controller;
+	SDL_JoystickID instance_id;
+	Uint32 buttons_down;
+	Sint16 axes[SDL_CONTROLLER_AXIS_MAX];
+};
+
+/* Shaped axis direction amount and its average over the current tick */
+struct input_mapper_axis_direction {
+	float amount;
+	float amount_integral;
+	Uint32 amount_timestamp;
+	float tick_amount;
 };
 
-struct input_mapper_key_mapping {
-	enum input_mapper_key_type custom_key_type;
-	SDL_Scancode associated_scancode;
-	pong_bool_te usable;
+struct input_mapper_latency {
+	Uint32 sum;
+	Uint32 max;
+	int samples;
 };
 
+/* One bit per custom key in every mask */
 struct input_mapper_instance {
-	struct input_mapper_key_mapping * p_mappings;
-	enum input_mapper_key_state * p_states;
+	struct input_mapper_binding bindings[INPUT_MAPPER_KEY_TYPE_COUNT][INPUT_MAPPER_MAX_BINDINGS_PER_KEY];
+	Uint64 physical_input_bindings[INPUT_MAPPER_PHYSICAL_INPUT_COUNT];
+	Uint64 physical_inputs_down[(INPUT_MAPPER_PHYSICAL_INPUT_COUNT + 63) / 64];
+	struct input_mapper_controller controllers[INPUT_MAPPER_MAX_CONTROLLERS];
+	struct input_mapper_axis_direction axis_directions[INPUT_MAPPER_AXIS_DIRECTION_COUNT];
+	float axis_deadzone;
+	float axis_response_exponent;
+	Uint64 keys_down;
+	Uint64 keys_current;
+	Uint64 keys_previous;
+	Uint64 keys_pressed;
+	struct input_mapper_key_input * p_inputs;
+	Uint32 tick_begin_timestamp;
+	struct input_mapper_latency latency;
 };
 
 /* Function prototypes */
 pong_bool_te input_mapper_create(struct input_mapper_instance * p_out_instance);
 void input_mapper_destroy(const struct input_mapper_instance * p_instance);
-void input_mapper_set_intermediate_state
+void input_mapper_process_event
 (
 	struct input_mapper_instance * p_instance,
-	const uint8_t * p_keyboard_state
+	const SDL_Event * p_event
 );
-pong_bool_te input_mapper_custom_key_state_none
+int input_mapper_physical_input(struct input_mapper_binding binding);
+pong_bool_te input_mapper_bind
 (
 	struct input_mapper_instance * p_instance,
-	enum input_mapper_key_type custom_key_type
+	enum input_mapper_key_type custom_key_type,
+	struct input_mapper_binding binding
 );
-pong_bool_te input_mapper_custom_key_state_pressed
+void input_mapper_unbind_all
 (
 	struct input_mapper_instance * p_instance,
 	enum input_mapper_key_type custom_key_type
 );
-pong_bool_te input_mapper_custom_key_state_held
+void input_mapper_bind_defaults(struct input_mapper_instance * p_instance);
+Uint64 input_mapper_gather_keyboard_state
+(
+	const struct input_mapper_instance * p_instance,
+	const Uint8 * p_keyboard_state
+);
+void input_mapper_sync_keyboard_state
 (
 	struct input_mapper_instance * p_instance,
-	enum input_mapper_key_type custom_key_type
+	const Uint8 * p_keyboard_state,
+	Uint32 timestamp
 );
-pong_bool_te input_mapper_custom_key_state_released
+void input_mapper_process_physical_input
 (
 	struct input_mapper_instance * p_instance,
+	int physical_input,
+	pong_bool_te down,
+	Uint32 timestamp
+);
+void input_mapper_set_intermediate_state
+(
+	struct input_mapper_instance * p_instance,
+	Uint32 tick_end_timestamp
+);
+float input_mapper_custom_key_held_fraction
+(
+	struct input_mapper_instance * p_instance,
+	enum input_mapper_key_type custom_key_type
+);
+float input_mapper_custom_key_amount
+(
+	const struct input_mapper_instance * p_instance,
 	enum input_mapper_key_type custom_key_type
 );
+struct input_mapper_latency input_mapper_take_latency(struct input_mapper_instance * p_instance);
+
+/* Inline key state queries - Invalid custom key types read as zero */
+static inline pong_bool_te input_mapper_physical_input_down
+(
+	const struct input_mapper_instance * p_instance,
+	int physical_input
+)
+{
+	return (pong_bool_te)((p_instance->physical_inputs_down[physical_input >> 6] >> (physical_input & 63)) & 1u);
+}
+
+static inline Uint64 input_mapper_key_bit(Uint64 keys, enum input_mapper_key_type custom_key_type)
+{
+	const unsigned int key_index = (unsigned int)custom_key_type;
+	return (keys >> (key_index & 63u)) & (Uint64)(key_index < INPUT_MAPPER_KEY_TYPE_COUNT);
+}
+
+static inline pong_bool_te input_mapper_custom_key_down
+(
+	const struct input_mapper_instance * p_instance,
+	enum input_mapper_key_type custom_key_type
+)
+{
+	return (pong_bool_te)input_mapper_key_bit(p_instance->keys_down, custom_key_type);
+}
+
+static inline pong_bool_te input_mapper_custom_key_state_none
+(
+	const struct input_mapper_instance * p_instance,
+	enum input_mapper_key_type custom_key_type
+)
+{
+	return (pong_bool_te)input_mapper_key_bit(~(p_instance->keys_current | p_instance->keys_previous), custom_key_type);
+}
+
+static inline pong_bool_te input_mapper_custom_key_state_pressed
+(
+	const struct input_mapper_instance * p_instance,
+	enum input_mapper_key_type custom_key_type
+)
+{
+	return (pong_bool_te)input_mapper_key_bit(p_instance->keys_pressed, custom_key_type);
+}
+
+static inline pong_bool_te input_mapper_custom_key_state_held
+(
+	const struct input_mapper_instance * p_instance,
+	enum input_mapper_key_type custom_key_type
+)
+{
+	return (pong_bool_te)input_mapper_key_bit(p_instance->keys_current & ~p_instance->keys_pressed, custom_key_type);
+}
+
+static inline pong_bool_te input_mapper_custom_key_state_released
+(
+	const struct input_mapper_instance * p_instance,
+	enum input_mapper_key_type custom_key_type
+)
+{
+	return (pong_bool_te)input_mapper_key_bit(p_instance->keys_previous & ~p_instance->keys_current, custom_key_type);
+}
 
 #endif
\ No newline at end of file
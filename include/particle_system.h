@@ -0,0 +1,56 @@
+#ifndef PARTICLE_SYSTEM_H
+#define PARTICLE_SYSTEM_H
+
+/* Includes */
+#include <pong_bool.h>
+#include <color4ub.h>
+#include <SDL2/SDL.h>
+
+/* Defines */
+#define PARTICLE_SYSTEM_CAPACITY (65536)
+#define PARTICLE_SYSTEM_ALIGNMENT (16)
+
+/* Datatypes */
+struct particle_system_emitter {
+  float speed_min;
+  float speed_max;
+  float spread_radians;
+  float lifetime_min;
+  float lifetime_max;
+  float size;
+  struct color4ub color;
+};
+
+/*
+  Fixed-capacity particle pool - One array per attribute so the update runs four
+  particles per instruction. Live particles are always packed at the front, the
+  arrays are handed to the batcher as they are.
+*/
+struct particle_system {
+  _Alignas(PARTICLE_SYSTEM_ALIGNMENT) float positions_x[PARTICLE_SYSTEM_CAPACITY];
+  _Alignas(PARTICLE_SYSTEM_ALIGNMENT) float positions_y[PARTICLE_SYSTEM_CAPACITY];
+  _Alignas(PARTICLE_SYSTEM_ALIGNMENT) float velocities_x[PARTICLE_SYSTEM_CAPACITY];
+  _Alignas(PARTICLE_SYSTEM_ALIGNMENT) float velocities_y[PARTICLE_SYSTEM_CAPACITY];
+  _Alignas(PARTICLE_SYSTEM_ALIGNMENT) float lifetimes[PARTICLE_SYSTEM_CAPACITY];
+  _Alignas(PARTICLE_SYSTEM_ALIGNMENT) float sizes[PARTICLE_SYSTEM_CAPACITY];
+  _Alignas(PARTICLE_SYSTEM_ALIGNMENT) float shrink_rates[PARTICLE_SYSTEM_CAPACITY];
+  struct color4ub colors[PARTICLE_SYSTEM_CAPACITY];
+  int count;
+  Uint32 random_state;
+};
+
+/* Function prototypes */
+void particle_system_reset(struct particle_system * p_system, Uint32 random_seed);
+int particle_system_emit
+(
+  struct particle_system * p_system,
+  const struct particle_system_emitter * p_emitter,
+  float origin_x,
+  float origin_y,
+  float direction_x,
+  float direction_y,
+  int particle_count
+);
+void particle_system_update(struct particle_system * p_system, float dt);
+
+#endif
\ No newline at end of file
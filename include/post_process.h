@@ -0,0 +1,37 @@
+#ifndef POST_PROCESS_H
+#define POST_PROCESS_H
+
+/* Includes */
+#include <pong_bool.h>
+
+/* Datatypes */
+enum post_process_filter {
+  POST_PROCESS_FILTER_NEAREST,
+  POST_PROCESS_FILTER_SHARP_BILINEAR
+};
+
+/* Function prototypes */
+pong_bool_te post_process_initialize
+(
+  int internal_width,
+  int internal_height,
+  enum post_process_filter filter,
+  pong_bool_te scanlines,
+  pong_bool_te core_profile
+);
+void post_process_set_scanlines(pong_bool_te scanlines);
+pong_bool_te post_process_active(void);
+void post_process_frame_size(int * p_out_width, int * p_out_height);
+void post_process_begin(void);
+void post_process_present
+(
+  int window_width,
+  int window_height,
+  int viewport_x,
+  int viewport_y,
+  int viewport_width,
+  int viewport_height
+);
+void post_process_cleanup(void);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef RAW_TEXTURE_H
+#define RAW_TEXTURE_H
+
+/* Includes */
+#include <SDL2/SDL.h>
+#include <pong_bool.h>
+
+/* Defines */
+#define RAW_TEXTURE_MAGIC (0x58455452u)
+#define RAW_TEXTURE_VERSION (2u)
+
+/* Datatypes */
+enum raw_texture_format {
+  RAW_TEXTURE_FORMAT_ALPHA8 = 1,
+  RAW_TEXTURE_FORMAT_RGBA8 = 2
+};
+
+/*
+  Raw texture file layout - Header, then the tightly packed pixel rows of the
+  single full size level in source image row order and ready for glTexImage2D
+  as-is. No mip chain - Textures end up in the atlas which is never minified.
+  Alpha-only textures keep one byte per pixel.
+*/
+struct raw_texture_header {
+  Uint32 magic;
+  Uint32 version;
+  Uint32 width;
+  Uint32 height;
+  Uint32 format;
+};
+
+/* Memory-mapped texture - Or a view into memory owned by someone else */
+struct raw_texture {
+  Uint8 * p_mapping;
+  size_t mapping_size;
+  pong_bool_te owns_mapping;
+  const struct raw_texture_header * p_header;
+  const Uint8 * p_pixels;
+};
+
+/* Interface function definitions */
+pong_bool_te raw_texture_open(const char * p_path, struct raw_texture * p_out_texture);
+pong_bool_te raw_texture_open_memory(const Uint8 * p_data, size_t length, struct raw_texture * p_out_texture);
+const Uint8 * raw_texture_pixels(const struct raw_texture * p_texture);
+size_t raw_texture_size(const struct raw_texture * p_texture);
+void raw_texture_close(struct raw_texture * p_texture);
+pong_bool_te raw_texture_build(SDL_Surface * p_surface, Uint8 ** p_out_data, size_t * p_out_length);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef RESOURCE_PACK_H
+#define RESOURCE_PACK_H
+
+/* Includes */
+#include <SDL2/SDL.h>
+#include <pong_bool.h>
+
+/* Defines */
+#define RESOURCE_PACK_MAGIC (0x4b415052u)
+#define RESOURCE_PACK_VERSION (1u)
+#define RESOURCE_PACK_ALIGNMENT (4096u)
+#define RESOURCE_PACK_MAX_NAME_LENGTH (64)
+#define RESOURCE_PACK_EMPTY_BUCKET (0u)
+
+/* Datatypes */
+
+/*
+	Pack file layout - Header, table of contents, then every resource at a
+	RESOURCE_PACK_ALIGNMENT aligned offset. The table of contents is an open
+	addressing hash table of bucket_count entries keyed by the hashed name
+	relative to resources/, probed linearly from hash & (bucket_count - 1).
+*/
+struct resource_pack_header {
+	Uint32 magic;
+	Uint32 version;
+	Uint32 bucket_count;
+	Uint32 entry_count;
+};
+
+struct resource_pack_entry {
+	Uint64 name_hash;
+	Uint64 offset;
+	Uint64 length;
+	char name[RESOURCE_PACK_MAX_NAME_LENGTH];
+};
+
+/* Memory-mapped pack */
+struct resource_pack {
+	Uint8 * p_mapping;
+	size_t mapping_size;
+	const struct resource_pack_header * p_header;
+	const struct resource_pack_entry * p_buckets;
+};
+
+/* Interface function definitions */
+Uint64 resource_pack_hash(const char * p_name);
+pong_bool_te resource_pack_open(const char * p_path, struct resource_pack * p_out_pack);
+pong_bool_te resource_pack_find(const struct resource_pack * p_pack, const char * p_name, const Uint8 ** p_out_data, size_t * p_out_length);
+void resource_pack_close(struct resource_pack * p_pack);
+
+#endif
\ No newline at end of file
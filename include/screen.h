@@ -9,13 +9,23 @@ enum screen_type {
 	SCREEN_TYPE_MAIN_MENU,
 	SCREEN_TYPE_OPTIONS,
 	SCREEN_TYPE_PONG,
+	SCREEN_TYPE_PAUSE,
 	SCREEN_TYPE_QUIT, /* To signal quitting the screen state machine */
+	SCREEN_TYPE_RESUME, /* To signal closing an overlay and resuming the suspended screen below */
 	SCREEN_TYPE_COUNT
 };
 
 /* Screen callback types */
 typedef void (* screen_callback_change_request_tf)(enum screen_type requested_screen_type);
-typedef void (* screen_callback_initialize_tf)
+/* Prepare - Runs on a worker thread while the previous screen keeps rendering, no rendering or windowing calls
+   The windowing dependencies are a snapshot and the seed replaces rand() which is not thread safe */
+typedef void (* screen_callback_prepare_tf)
+(
+	const struct gameplay_dependencies_windowing * p_windowing,
+	Uint32 random_seed
+);
+/* Activate - Runs on the main thread at the frame boundary the screen becomes active */
+typedef void (* screen_callback_activate_tf)
 (
 	const struct gameplay_dependencies_windowing * p_windowing
 );
@@ -33,25 +43,32 @@ typedef void (* screen_callback_render_tf)
 	const struct gameplay_dependencies_batcher * p_batcher,
 	const struct gameplay_dependencies_windowing * p_windowing
 );
-typedef void (* screen_callback_cleanup_tf)(void);
+/* Deactivate and release - Run on the main thread when the screen is swapped out */
+typedef void (* screen_callback_deactivate_tf)(void);
+typedef void (* screen_callback_release_tf)(void);
 
 /* Datatypes */
 struct screen {
 	enum screen_type type;
-	screen_callback_initialize_tf p_initialize;
+	pong_bool_te overlay; /* Overlays are pushed over the active screen, which is suspended instead of released */
+	screen_callback_prepare_tf p_prepare;
+	screen_callback_activate_tf p_activate;
 	screen_callback_integrate_tf p_integrate;
 	screen_callback_render_tf p_render;
-	screen_callback_cleanup_tf p_cleanup;
+	screen_callback_deactivate_tf p_deactivate;
+	screen_callback_release_tf p_release;
 };
 
 /* Function prototypes */
 struct screen screen_make
 (
 	enum screen_type type,
-	screen_callback_initialize_tf p_initialize,
+	screen_callback_prepare_tf p_prepare,
+	screen_callback_activate_tf p_activate,
 	screen_callback_integrate_tf p_integrate,
 	screen_callback_render_tf p_render,
-	screen_callback_cleanup_tf p_cleanup
+	screen_callback_deactivate_tf p_deactivate,
+	screen_callback_release_tf p_release
 );
 
 #endif
\ No newline at end of file
@@ -0,0 +1,10 @@
+#ifndef SCREEN_PAUSE_H
+#define SCREEN_PAUSE_H
+
+/* Includes */
+#include <screen.h>
+
+/* Function prototypes */
+struct screen screen_pause_make(void);
+
+#endif
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <vec2i.h>
 #include <region2Di.h>
 #include <region2Df.h>
+#include <raw_texture.h>
 #include <SDL2/SDL.h>
 
 /* Defines */
@@ -24,7 +25,8 @@ struct text_renderer_cache {
 
 /* Function prototypes*/
 pong_bool_te text_renderer_initialize(void);
-const SDL_Surface * text_renderer_texture_info(void);
+const struct raw_texture * text_renderer_texture_info(void);
+const struct raw_texture * text_renderer_use_distance_field(void);
 void text_renderer_text_info(
   const char * p_text,
   int base_x,
@@ -0,0 +1,37 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+/* Includes */
+#include <pong_bool.h>
+#include <region2Df.h>
+#include <SDL2/SDL.h>
+
+/* Defines */
+#define TEXTURE_ATLAS_PAGE_SIZE (512)
+#define TEXTURE_ATLAS_MAX_PAGES (4)
+#define TEXTURE_ATLAS_MAX_REGIONS (64)
+#define TEXTURE_ATLAS_MAX_SKYLINE_NODES (128)
+#define TEXTURE_ATLAS_PADDING (1)
+#define TEXTURE_ATLAS_INVALID_REGION (-1)
+
+/* Datatypes */
+enum texture_atlas_filter {
+  TEXTURE_ATLAS_FILTER_NEAREST, /* Crisp pixel art and bitmap glyphs */
+  TEXTURE_ATLAS_FILTER_LINEAR /* Distance fields which are reconstructed from interpolated texels */
+};
+
+struct texture_atlas_region {
+  unsigned int texture_handle;
+  int width;
+  int height;
+  struct region2Df texcoords_region;
+};
+
+/* Function prototypes - Pages are OpenGL textures, use from the thread owning the GL context */
+pong_bool_te texture_atlas_initialize(void);
+int texture_atlas_add(int width, int height, int channels, const Uint8 * p_pixels, enum texture_atlas_filter filter);
+const struct texture_atlas_region * texture_atlas_region(int region_handle);
+void texture_atlas_upload(void);
+void texture_atlas_cleanup(void);
+
+#endif
\ No newline at end of file
@@ -4,14 +4,19 @@
 /* Includes */
 #include <pong_bool.h>
 #include <SDL2/SDL.h>
+#include <asset_loader.h>
+#include <raw_texture.h>
 
 /* Function prototypes */
 pong_bool_te texture_loader_initialize(void);
-SDL_Surface * texture_loader_load_texture
+int texture_loader_load_texture
 (
-  const char * p_texture_name_with_extension
+  const char * p_texture_name_with_extension,
+  asset_loader_completion_tf completion,
+  void * p_user_data
 );
-void texture_loader_destroy_texture(SDL_Surface * p_texture);
-void texture_loader_cleanup(void);
+SDL_Surface * texture_loader_texture(int texture_handle);
+pong_bool_te texture_loader_open_raw_texture(const char * p_texture_name_with_extension, struct raw_texture * p_out_texture);
+void texture_loader_destroy_texture(int texture_handle);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,420 @@
+/* Includes */
+#include <asset_loader.h>
+#include <audio_bank.h>
+#include <resource_pack.h>
+#include <SDL2/SDL_image.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Datatypes */
+struct asset_loader_asset {
+	pong_bool_te in_use;
+	enum asset_loader_asset_type type;
+	char path[ASSET_LOADER_MAX_PATH_LENGTH];
+	asset_loader_completion_tf completion;
+	void * p_user_data;
+
+	/* Written by the decoding worker - The state under the loader mutex, the results are read once delivered */
+	enum asset_loader_state state;
+	SDL_Surface * p_image;
+	Uint8 * p_samples;
+	Uint32 samples_length;
+
+	/* Only touched by the polling thread */
+	pong_bool_te completion_delivered;
+	pong_bool_te released;
+
+	/* Startup timing */
+	Uint64 queued_counter;
+	Uint64 decode_begin_counter;
+	Uint64 decode_end_counter;
+};
+
+/* Private state */
+static pong_bool_te loader_initialized = PONG_FALSE;
+static char resource_directory[ASSET_LOADER_MAX_PATH_LENGTH];
+static struct resource_pack pack;
+static struct asset_loader_asset assets[ASSET_LOADER_MAX_ASSETS];
+
+/* Workers and their queues - Every live asset is in at most one queue at a time so neither can overflow */
+static SDL_Thread * p_workers[ASSET_LOADER_MAX_WORKERS];
+static int worker_count = 0;
+static pong_bool_te workers_running = PONG_FALSE;
+static SDL_mutex * p_loader_mutex = NULL;
+static SDL_cond * p_job_available = NULL;
+static SDL_cond * p_job_completed = NULL;
+static int job_queue[ASSET_LOADER_MAX_ASSETS];
+static int job_queue_head = 0;
+static int job_queue_count = 0;
+static int completed_queue[ASSET_LOADER_MAX_ASSETS];
+static int completed_queue_head = 0;
+static int completed_queue_count = 0;
+
+/* Private helper functions */
+static double counter_to_milliseconds(Uint64 counter_delta)
+{
+	return ((double)counter_delta * 1000.0) / (double)SDL_GetPerformanceFrequency();
+}
+
+static struct asset_loader_asset * asset_from_handle(int asset_handle)
+{
+	if (asset_handle < 0 || asset_handle >= ASSET_LOADER_MAX_ASSETS || !assets[asset_handle].in_use)
+		return NULL;
+
+	return assets + asset_handle;
+}
+
+static void free_asset(struct asset_loader_asset * p_asset)
+{
+	if (p_asset->p_image != NULL)
+		SDL_FreeSurface(p_asset->p_image);
+	free(p_asset->p_samples);
+
+	p_asset->p_image = NULL;
+	p_asset->p_samples = NULL;
+	p_asset->samples_length = 0;
+	p_asset->in_use = PONG_FALSE;
+}
+
+static void decode_asset(struct asset_loader_asset * p_asset, enum asset_loader_state * p_state)
+{
+	SDL_Surface * p_image = NULL;
+	Uint8 * p_samples = NULL;
+	Uint32 samples_length = 0;
+
+	/* Decode straight out of the mapped pack - Loose files only when it lacks the resource */
+	const Uint8 * p_packed_data = NULL;
+	size_t packed_length = 0;
+	const pong_bool_te packed = resource_pack_find(&pack, p_asset->path + strlen(resource_directory), &p_packed_data, &packed_length);
+
+	pong_bool_te decoded = PONG_FALSE;
+	switch (p_asset->type)
+	{
+		case ASSET_LOADER_ASSET_TYPE_IMAGE:
+			p_image = packed ? IMG_Load_RW(SDL_RWFromConstMem(p_packed_data, (int)packed_length), 1) : IMG_Load(p_asset->path);
+			decoded = (p_image != NULL) ? PONG_TRUE : PONG_FALSE;
+			if (!decoded)
+				fprintf(stderr, "\n[Asset loader] Could not load image '%s' - Error: %s", p_asset->path, IMG_GetError());
+			break;
+		case ASSET_LOADER_ASSET_TYPE_SOUND:
+			decoded = packed
+				? audio_bank_load_converted_wav_memory(p_packed_data, packed_length, p_asset->path, &p_samples, &samples_length)
+				: audio_bank_load_converted_wav(p_asset->path, &p_samples, &samples_length);
+			break;
+	}
+
+	p_asset->p_image = p_image;
+	p_asset->p_samples = p_samples;
+	p_asset->samples_length = samples_length;
+	*p_state = decoded ? ASSET_LOADER_STATE_READY : ASSET_LOADER_STATE_FAILED;
+}
+
+static void complete_job(int asset_handle, enum asset_loader_state state)
+{
+	/* Caller holds the loader mutex */
+	assets[asset_handle].state = state;
+	completed_queue[(completed_queue_head + completed_queue_count++) % ASSET_LOADER_MAX_ASSETS] = asset_handle;
+	SDL_CondBroadcast(p_job_completed);
+}
+
+static int worker_run(void * p_data)
+{
+	SDL_LockMutex(p_loader_mutex);
+	while (workers_running)
+	{
+		if (job_queue_count == 0)
+		{
+			SDL_CondWait(p_job_available, p_loader_mutex);
+			continue;
+		}
+
+		/* Take the oldest job */
+		const int asset_handle = job_queue[job_queue_head];
+		job_queue_head = (job_queue_head + 1) % ASSET_LOADER_MAX_ASSETS;
+		job_queue_count--;
+		SDL_UnlockMutex(p_loader_mutex);
+
+		/* File IO and decode run in parallel on every worker */
+		struct asset_loader_asset * const p_asset = assets + asset_handle;
+		enum asset_loader_state state;
+		p_asset->decode_begin_counter = SDL_GetPerformanceCounter();
+		decode_asset(p_asset, &state);
+		p_asset->decode_end_counter = SDL_GetPerformanceCounter();
+
+		SDL_LockMutex(p_loader_mutex);
+		complete_job(asset_handle, state);
+	}
+	SDL_UnlockMutex(p_loader_mutex);
+
+	return 0;
+}
+
+/* Function definitions */
+pong_bool_te asset_loader_initialize(void)
+{
+	if (loader_initialized)
+		return PONG_TRUE;
+
+	/* Resolve the resource directory once - Jobs carry their own copy of the full path */
+	char * const p_base_path = SDL_GetBasePath();
+	snprintf(resource_directory, ASSET_LOADER_MAX_PATH_LENGTH, "%s%s", p_base_path ? p_base_path : "", "../resources/");
+
+	/* Every resource in one mapping next to the executable - Built with: make resource_pack */
+	char pack_path[ASSET_LOADER_MAX_PATH_LENGTH];
+	snprintf(pack_path, ASSET_LOADER_MAX_PATH_LENGTH, "%s%s", p_base_path ? p_base_path : "", "resources.pack");
+	SDL_free(p_base_path);
+	if (resource_pack_open(pack_path, &pack))
+		printf("\n[Asset loader] Mapped %u resources from: %s", pack.p_header->entry_count, pack_path);
+	else
+		fprintf(stderr, "\n[Asset loader] No resource pack at: %s - Loading the resource files", pack_path);
+
+	for (int asset_handle = 0; asset_handle < ASSET_LOADER_MAX_ASSETS; asset_handle++)
+		assets[asset_handle] = (struct asset_loader_asset){ 0 };
+	job_queue_head = job_queue_count = 0;
+	completed_queue_head = completed_queue_count = 0;
+
+	/* Image decoders have to be initialized before workers use them */
+	const int required_image_flags = IMG_INIT_PNG;
+	if (!(IMG_Init(required_image_flags) & required_image_flags))
+	{
+		fprintf(stderr, "\n[Asset loader] Could not initialize image decoding - Error: %s", IMG_GetError());
+		return PONG_FALSE;
+	}
+
+	p_loader_mutex = SDL_CreateMutex();
+	p_job_available = SDL_CreateCond();
+	p_job_completed = SDL_CreateCond();
+	if (p_loader_mutex == NULL || p_job_available == NULL || p_job_completed == NULL)
+	{
+		fprintf(stderr, "\n[Asset loader] Could not create synchronization primitives - Error: %s", SDL_GetError());
+		loader_initialized = PONG_TRUE;
+		asset_loader_cleanup();
+		return PONG_FALSE;
+	}
+
+	/* Leave a core to the main thread - Without workers every load decodes synchronously */
+	int desired_workers = SDL_GetCPUCount() - 1;
+	desired_workers = (desired_workers < 1) ? 1 : (desired_workers > ASSET_LOADER_MAX_WORKERS) ? ASSET_LOADER_MAX_WORKERS : desired_workers;
+	workers_running = PONG_TRUE;
+	worker_count = 0;
+	for (int worker_index = 0; worker_index < desired_workers; worker_index++)
+	{
+		SDL_Thread * const p_worker = SDL_CreateThread(worker_run, "asset_loader", NULL);
+		if (p_worker == NULL)
+		{
+			fprintf(stderr, "\n[Asset loader] Could not create worker thread - Error: %s", SDL_GetError());
+			break;
+		}
+		p_workers[worker_count++] = p_worker;
+	}
+
+	loader_initialized = PONG_TRUE;
+	return PONG_TRUE;
+}
+
+int asset_loader_load
+(
+	enum asset_loader_asset_type asset_type,
+	const char * p_resource_path,
+	asset_loader_completion_tf completion,
+	void * p_user_data
+)
+{
+	if (!loader_initialized || p_resource_path == NULL)
+		return ASSET_LOADER_INVALID_HANDLE;
+
+	/* Find a free slot */
+	int asset_handle = 0;
+	while (asset_handle < ASSET_LOADER_MAX_ASSETS && assets[asset_handle].in_use)
+		asset_handle++;
+	if (asset_handle >= ASSET_LOADER_MAX_ASSETS)
+	{
+		fprintf(stderr, "\n[Asset loader] All %d asset slots in use - Cannot load '%s'", ASSET_LOADER_MAX_ASSETS, p_resource_path);
+		return ASSET_LOADER_INVALID_HANDLE;
+	}
+
+	struct asset_loader_asset * const p_asset = assets + asset_handle;
+	*p_asset = (struct asset_loader_asset){ 0 };
+	p_asset->in_use = PONG_TRUE;
+	p_asset->type = asset_type;
+	p_asset->completion = completion;
+	p_asset->p_user_data = p_user_data;
+	p_asset->state = ASSET_LOADER_STATE_PENDING;
+	p_asset->queued_counter = SDL_GetPerformanceCounter();
+	snprintf(p_asset->path, ASSET_LOADER_MAX_PATH_LENGTH, "%s%s", resource_directory, p_resource_path);
+
+	/* No workers - Decode right away, the completion still runs from the next poll */
+	if (worker_count == 0)
+	{
+		enum asset_loader_state state;
+		p_asset->decode_begin_counter = SDL_GetPerformanceCounter();
+		decode_asset(p_asset, &state);
+		p_asset->decode_end_counter = SDL_GetPerformanceCounter();
+
+		SDL_LockMutex(p_loader_mutex);
+		complete_job(asset_handle, state);
+		SDL_UnlockMutex(p_loader_mutex);
+		return asset_handle;
+	}
+
+	SDL_LockMutex(p_loader_mutex);
+	job_queue[(job_queue_head + job_queue_count++) % ASSET_LOADER_MAX_ASSETS] = asset_handle;
+	SDL_CondSignal(p_job_available);
+	SDL_UnlockMutex(p_loader_mutex);
+
+	return asset_handle;
+}
+
+void asset_loader_poll(void)
+{
+	if (!loader_initialized)
+		return;
+
+	for (;;)
+	{
+		SDL_LockMutex(p_loader_mutex);
+		if (completed_queue_count == 0)
+		{
+			SDL_UnlockMutex(p_loader_mutex);
+			return;
+		}
+		const int asset_handle = completed_queue[completed_queue_head];
+		completed_queue_head = (completed_queue_head + 1) % ASSET_LOADER_MAX_ASSETS;
+		completed_queue_count--;
+		SDL_UnlockMutex(p_loader_mutex);
+
+		/* Released while loading - Nobody is waiting for it */
+		struct asset_loader_asset * const p_asset = assets + asset_handle;
+		p_asset->completion_delivered = PONG_TRUE;
+		if (p_asset->released)
+		{
+			free_asset(p_asset);
+			continue;
+		}
+
+		/* Finish on this thread - GPU uploads go here */
+		const Uint64 finalize_begin_counter = SDL_GetPerformanceCounter();
+		if (p_asset->completion != NULL)
+			p_asset->completion(asset_handle, p_asset->p_user_data);
+
+		printf(
+			"\n[Asset loader] %s '%s' after %.2f ms - Queued %.2f ms - Decode %.2f ms - Finalize %.2f ms",
+			(p_asset->state == ASSET_LOADER_STATE_READY) ? "Loaded" : "Failed",
+			p_asset->path + strlen(resource_directory),
+			counter_to_milliseconds(SDL_GetPerformanceCounter() - p_asset->queued_counter),
+			counter_to_milliseconds(p_asset->decode_begin_counter - p_asset->queued_counter),
+			counter_to_milliseconds(p_asset->decode_end_counter - p_asset->decode_begin_counter),
+			counter_to_milliseconds(SDL_GetPerformanceCounter() - finalize_begin_counter)
+		);
+	}
+}
+
+enum asset_loader_state asset_loader_wait(int asset_handle)
+{
+	struct asset_loader_asset * const p_asset = asset_from_handle(asset_handle);
+	if (p_asset == NULL)
+		return ASSET_LOADER_STATE_FAILED;
+
+	/* Block until decoded, then deliver its completion along with any other */
+	SDL_LockMutex(p_loader_mutex);
+	while (p_asset->state == ASSET_LOADER_STATE_PENDING)
+		SDL_CondWait(p_job_completed, p_loader_mutex);
+	const enum asset_loader_state state = p_asset->state;
+	SDL_UnlockMutex(p_loader_mutex);
+
+	asset_loader_poll();
+	return state;
+}
+
+enum asset_loader_state asset_loader_state(int asset_handle)
+{
+	struct asset_loader_asset * const p_asset = asset_from_handle(asset_handle);
+	if (p_asset == NULL)
+		return ASSET_LOADER_STATE_FAILED;
+
+	/* Ready once the completion ran - Results are not touched by workers anymore */
+	return p_asset->completion_delivered ? p_asset->state : ASSET_LOADER_STATE_PENDING;
+}
+
+SDL_Surface * asset_loader_image(int asset_handle)
+{
+	if (asset_loader_state(asset_handle) != ASSET_LOADER_STATE_READY)
+		return NULL;
+
+	return assets[asset_handle].p_image;
+}
+
+pong_bool_te asset_loader_find_resource(const char * p_resource_path, const Uint8 ** pp_data, size_t * p_length)
+{
+	if (!loader_initialized)
+		return PONG_FALSE;
+
+	return resource_pack_find(&pack, p_resource_path, pp_data, p_length);
+}
+
+pong_bool_te asset_loader_sound(int asset_handle, Uint8 ** pp_samples, Uint32 * p_samples_length)
+{
+	if (asset_loader_state(asset_handle) != ASSET_LOADER_STATE_READY || assets[asset_handle].p_samples == NULL)
+		return PONG_FALSE;
+
+	*pp_samples = assets[asset_handle].p_samples;
+	*p_samples_length = assets[asset_handle].samples_length;
+	return PONG_TRUE;
+}
+
+void asset_loader_release(int asset_handle)
+{
+	struct asset_loader_asset * const p_asset = asset_from_handle(asset_handle);
+	if (p_asset == NULL)
+		return;
+
+	/* Still owned by a worker or the completed queue - Freed once polled */
+	if (!p_asset->completion_delivered)
+	{
+		p_asset->released = PONG_TRUE;
+		return;
+	}
+
+	free_asset(p_asset);
+}
+
+void asset_loader_cleanup(void)
+{
+	if (!loader_initialized)
+		return;
+
+	/* Stop the workers - Queued jobs are dropped, running ones finish first */
+	if (p_loader_mutex != NULL)
+	{
+		SDL_LockMutex(p_loader_mutex);
+		workers_running = PONG_FALSE;
+		SDL_CondBroadcast(p_job_available);
+		SDL_UnlockMutex(p_loader_mutex);
+	}
+	for (int worker_index = 0; worker_index < worker_count; worker_index++)
+		SDL_WaitThread(p_workers[worker_index], NULL);
+	worker_count = 0;
+
+	/* Free whatever was never released */
+	for (int asset_handle = 0; asset_handle < ASSET_LOADER_MAX_ASSETS; asset_handle++)
+	{
+		if (assets[asset_handle].in_use)
+			free_asset(assets + asset_handle);
+	}
+
+	if (p_job_completed != NULL)
+		SDL_DestroyCond(p_job_completed);
+	if (p_job_available != NULL)
+		SDL_DestroyCond(p_job_available);
+	if (p_loader_mutex != NULL)
+		SDL_DestroyMutex(p_loader_mutex);
+	p_job_completed = p_job_available = NULL;
+	p_loader_mutex = NULL;
+
+	/* Resources found in the pack are invalid from here on */
+	resource_pack_close(&pack);
+
+	IMG_Quit();
+	loader_initialized = PONG_FALSE;
+}
@@ -0,0 +1,192 @@
+/* Includes */
+#include <audio_bank.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Private helper functions */
+static pong_bool_te audio_bank_valid(const struct audio_bank * p_bank)
+{
+	/* Header and entry table must fit */
+	if (p_bank->mapping_size < sizeof(struct audio_bank_header))
+		return PONG_FALSE;
+
+	const struct audio_bank_header * const p_header = p_bank->p_header;
+	if (p_header->magic != AUDIO_BANK_MAGIC || p_header->version != AUDIO_BANK_VERSION)
+		return PONG_FALSE;
+
+	const size_t table_size = sizeof(struct audio_bank_header) + (size_t)p_header->entry_count * sizeof(struct audio_bank_entry);
+	if (table_size > p_bank->mapping_size)
+		return PONG_FALSE;
+
+	/* Every entry must lie within the mapping */
+	for (Uint32 entry_index = 0; entry_index < p_header->entry_count; entry_index++)
+	{
+		const struct audio_bank_entry * const p_entry = p_bank->p_entries + entry_index;
+		if (
+			p_entry->offset < table_size ||
+			(size_t)p_entry->offset + p_entry->length > p_bank->mapping_size ||
+			memchr(p_entry->name, '\0', AUDIO_BANK_MAX_NAME_LENGTH) == NULL
+		)
+			return PONG_FALSE;
+	}
+
+	return PONG_TRUE;
+}
+
+/* Function definitions */
+pong_bool_te audio_bank_open(const char * p_path, struct audio_bank * p_out_bank)
+{
+	p_out_bank->p_mapping = NULL;
+	p_out_bank->mapping_size = 0;
+
+	const int file_descriptor = open(p_path, O_RDONLY);
+	if (file_descriptor < 0)
+		return PONG_FALSE;
+
+	struct stat file_stat;
+	if (fstat(file_descriptor, &file_stat) != 0 || file_stat.st_size <= 0)
+	{
+		close(file_descriptor);
+		return PONG_FALSE;
+	}
+
+	/* Samples are paged in by the mixer on first use - The mapping stays valid after closing the file */
+	void * const p_mapping = mmap(NULL, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+	close(file_descriptor);
+	if (p_mapping == MAP_FAILED)
+	{
+		fprintf(stderr, "\n[Audio bank] Could not map bank: %s", p_path);
+		return PONG_FALSE;
+	}
+
+	p_out_bank->p_mapping = p_mapping;
+	p_out_bank->mapping_size = (size_t)file_stat.st_size;
+	p_out_bank->owns_mapping = PONG_TRUE;
+	p_out_bank->p_header = p_mapping;
+	p_out_bank->p_entries = (const struct audio_bank_entry *)(p_out_bank->p_header + 1);
+
+	if (!audio_bank_valid(p_out_bank))
+	{
+		fprintf(stderr, "\n[Audio bank] Invalid bank: %s", p_path);
+		audio_bank_close(p_out_bank);
+		return PONG_FALSE;
+	}
+
+	return PONG_TRUE;
+}
+
+pong_bool_te audio_bank_open_memory(const Uint8 * p_data, size_t length, struct audio_bank * p_out_bank)
+{
+	/* Entries point straight into the memory - It has to outlive the bank */
+	p_out_bank->p_mapping = (Uint8 *)p_data;
+	p_out_bank->mapping_size = length;
+	p_out_bank->owns_mapping = PONG_FALSE;
+	p_out_bank->p_header = (const struct audio_bank_header *)p_data;
+	p_out_bank->p_entries = (const struct audio_bank_entry *)(p_out_bank->p_header + 1);
+
+	if (p_data == NULL || !audio_bank_valid(p_out_bank))
+	{
+		fprintf(stderr, "\n[Audio bank] Invalid bank in memory");
+		audio_bank_close(p_out_bank);
+		return PONG_FALSE;
+	}
+
+	return PONG_TRUE;
+}
+
+pong_bool_te audio_bank_matches_format(const struct audio_bank * p_bank, int frequency, Uint16 format, int channels)
+{
+	return (
+		p_bank->p_mapping != NULL &&
+		p_bank->p_header->frequency == frequency &&
+		p_bank->p_header->format == format &&
+		p_bank->p_header->channels == channels
+	) ? PONG_TRUE : PONG_FALSE;
+}
+
+pong_bool_te audio_bank_find(const struct audio_bank * p_bank, const char * p_name, Uint8 ** p_out_samples, Uint32 * p_out_length)
+{
+	if (p_bank->p_mapping == NULL)
+		return PONG_FALSE;
+
+	for (Uint32 entry_index = 0; entry_index < p_bank->p_header->entry_count; entry_index++)
+	{
+		const struct audio_bank_entry * const p_entry = p_bank->p_entries + entry_index;
+		if (strcmp(p_entry->name, p_name) != 0)
+			continue;
+
+		*p_out_samples = p_bank->p_mapping + p_entry->offset;
+		*p_out_length = p_entry->length;
+		return PONG_TRUE;
+	}
+
+	return PONG_FALSE;
+}
+
+void audio_bank_close(struct audio_bank * p_bank)
+{
+	if (p_bank->p_mapping != NULL && p_bank->owns_mapping)
+		munmap(p_bank->p_mapping, p_bank->mapping_size);
+
+	p_bank->p_mapping = NULL;
+	p_bank->mapping_size = 0;
+	p_bank->owns_mapping = PONG_FALSE;
+}
+
+static pong_bool_te load_converted_wav_rw(SDL_RWops * p_source, const char * p_path, Uint8 ** p_out_samples, Uint32 * p_out_length)
+{
+	SDL_AudioSpec spec;
+	Uint8 * p_wav_samples = NULL;
+	Uint32 wav_length = 0;
+	if (p_source == NULL || SDL_LoadWAV_RW(p_source, 1, &spec, &p_wav_samples, &wav_length) == NULL)
+	{
+		fprintf(stderr, "\n[Audio bank] Could not load: %s - Error: %s", p_path, SDL_GetError());
+		return PONG_FALSE;
+	}
+
+	/* Resample and convert into the bank format */
+	SDL_AudioCVT conversion;
+	if (SDL_BuildAudioCVT(&conversion, spec.format, spec.channels, spec.freq, AUDIO_BANK_FORMAT, AUDIO_BANK_CHANNELS, AUDIO_BANK_FREQUENCY) < 0)
+	{
+		fprintf(stderr, "\n[Audio bank] Unsupported conversion for: %s - Error: %s", p_path, SDL_GetError());
+		SDL_FreeWAV(p_wav_samples);
+		return PONG_FALSE;
+	}
+
+	conversion.len = (int)wav_length;
+	conversion.buf = malloc((size_t)wav_length * (size_t)conversion.len_mult);
+	if (conversion.buf == NULL)
+	{
+		SDL_FreeWAV(p_wav_samples);
+		return PONG_FALSE;
+	}
+	memcpy(conversion.buf, p_wav_samples, wav_length);
+	SDL_FreeWAV(p_wav_samples);
+
+	if (SDL_ConvertAudio(&conversion) < 0)
+	{
+		fprintf(stderr, "\n[Audio bank] Could not convert: %s - Error: %s", p_path, SDL_GetError());
+		free(conversion.buf);
+		return PONG_FALSE;
+	}
+
+	*p_out_samples = conversion.buf;
+	*p_out_length = (Uint32)conversion.len_cvt;
+	return PONG_TRUE;
+}
+
+pong_bool_te audio_bank_load_converted_wav(const char * p_path, Uint8 ** p_out_samples, Uint32 * p_out_length)
+{
+	return load_converted_wav_rw(SDL_RWFromFile(p_path, "rb"), p_path, p_out_samples, p_out_length);
+}
+
+pong_bool_te audio_bank_load_converted_wav_memory(const Uint8 * p_data, size_t length, const char * p_name, Uint8 ** p_out_samples, Uint32 * p_out_length)
+{
+	/* Decoded straight from the memory - No file IO */
+	return load_converted_wav_rw(SDL_RWFromConstMem(p_data, (int)length), p_name, p_out_samples, p_out_length);
+}
\ No newline at end of file
@@ -0,0 +1,436 @@
+/* Includes */
+#include <audio_mixer.h>
+#include <audio_music.h>
+#include <stdio.h>
+#include <math.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* Constants */
+static const float AUDIO_MIXER_MERGE_GAIN_TOLERANCE = 0.001f;
+
+/* Datatypes */
+struct audio_mixer_command {
+	const struct audio_mixer_sound * p_sound;
+	float gain_left;
+	float gain_right;
+	Uint64 requested_counter;
+};
+
+struct audio_mixer_voice {
+	const struct audio_mixer_sound * p_sound;
+	Uint32 frame_position;
+	float gain_left;
+	float gain_right;
+};
+
+/* Private state */
+static SDL_AudioDeviceID audio_device = 0;
+static int device_buffer_frames = 0;
+static pong_bool_te mixer_open = PONG_FALSE;
+
+/* Offline mode - No device, buffers are rendered on demand at the simulation rate */
+static pong_bool_te mixer_offline = PONG_FALSE;
+static double offline_frames_due = 0.0;
+static struct audio_mixer_voice voices[AUDIO_MIXER_MAX_VOICES];
+
+/* Interleaved float accumulation buffer - Only touched by the audio callback */
+static float mix_buffer[AUDIO_MIXER_MAX_BUFFER_FRAMES * AUDIO_MIXER_CHANNELS] __attribute__((aligned(16)));
+
+/* Single producer single consumer command queue - The game thread writes the tail, the audio callback the head */
+static struct audio_mixer_command command_queue[AUDIO_MIXER_COMMAND_QUEUE_CAPACITY];
+static SDL_atomic_t command_queue_head;
+static SDL_atomic_t command_queue_tail;
+
+/* Request to audible latency - Written by the audio callback, taken by the game thread */
+static SDL_atomic_t latency_sum_in_microseconds;
+static SDL_atomic_t latency_max_in_microseconds;
+static SDL_atomic_t latency_samples;
+
+/* Voice allocation outcomes - Written by the audio callback, taken by the game thread */
+static SDL_atomic_t voices_started;
+static SDL_atomic_t voices_stolen;
+static SDL_atomic_t voices_dropped;
+
+/* Requests merged into a pending one of the same sound - Only touched by the game thread */
+static int voices_merged = 0;
+
+/* Private helper functions */
+static void record_latency(Uint64 requested_counter, Uint64 callback_counter)
+{
+	/* Waited for the callback plus the time until the mixed buffer starts playing */
+	const double waited_in_microseconds = ((double)(callback_counter - requested_counter) * 1000000.0) / (double)SDL_GetPerformanceFrequency();
+	const double buffer_in_microseconds = ((double)device_buffer_frames * 1000000.0) / (double)AUDIO_MIXER_FREQUENCY;
+	const int latency_in_microseconds = (int)(waited_in_microseconds + buffer_in_microseconds);
+
+	SDL_AtomicAdd(&latency_sum_in_microseconds, latency_in_microseconds);
+	SDL_AtomicAdd(&latency_samples, 1);
+
+	int latency_max = SDL_AtomicGet(&latency_max_in_microseconds);
+	while (latency_in_microseconds > latency_max && !SDL_AtomicCAS(&latency_max_in_microseconds, latency_max, latency_in_microseconds))
+		latency_max = SDL_AtomicGet(&latency_max_in_microseconds);
+}
+
+static void assign_voice(struct audio_mixer_voice * p_voice, const struct audio_mixer_command * p_command)
+{
+	p_voice->p_sound = p_command->p_sound;
+	p_voice->frame_position = 0;
+	p_voice->gain_left = p_command->gain_left;
+	p_voice->gain_right = p_command->gain_right;
+}
+
+static pong_bool_te voice_is_better_victim(const struct audio_mixer_voice * p_candidate, const struct audio_mixer_voice * p_victim)
+{
+	/* Lowest priority first, then the quietest, then the one closest to its end */
+	if (p_candidate->p_sound->priority != p_victim->p_sound->priority)
+		return (p_candidate->p_sound->priority < p_victim->p_sound->priority) ? PONG_TRUE : PONG_FALSE;
+
+	const float candidate_gain = p_candidate->gain_left + p_candidate->gain_right;
+	const float victim_gain = p_victim->gain_left + p_victim->gain_right;
+	if (candidate_gain != victim_gain)
+		return (candidate_gain < victim_gain) ? PONG_TRUE : PONG_FALSE;
+
+	return (p_candidate->frame_position > p_victim->frame_position) ? PONG_TRUE : PONG_FALSE;
+}
+
+static void start_voice(const struct audio_mixer_command * p_command)
+{
+	const struct audio_mixer_sound * const p_sound = p_command->p_sound;
+	struct audio_mixer_voice * p_free_voice = NULL;
+	struct audio_mixer_voice * p_oldest_instance = NULL;
+	struct audio_mixer_voice * p_victim = NULL;
+	int instance_count = 0;
+
+	for (int voice_index = 0; voice_index < AUDIO_MIXER_MAX_VOICES; voice_index++)
+	{
+		struct audio_mixer_voice * const p_voice = voices + voice_index;
+		if (p_voice->p_sound == NULL)
+		{
+			if (p_free_voice == NULL)
+				p_free_voice = p_voice;
+			continue;
+		}
+
+		/* Instances of the same sound */
+		if (p_voice->p_sound == p_sound)
+		{
+			instance_count++;
+			if (p_oldest_instance == NULL || p_voice->frame_position > p_oldest_instance->frame_position)
+				p_oldest_instance = p_voice;
+		}
+
+		/* Only voices of equal or lower priority can be stolen */
+		if (p_voice->p_sound->priority <= p_sound->priority && (p_victim == NULL || voice_is_better_victim(p_voice, p_victim)))
+			p_victim = p_voice;
+	}
+
+	/* Instance limit reached - Restart the oldest instance */
+	if (p_sound->max_instances > 0 && instance_count >= p_sound->max_instances)
+	{
+		assign_voice(p_oldest_instance, p_command);
+		SDL_AtomicAdd(&voices_stolen, 1);
+		return;
+	}
+
+	if (p_free_voice != NULL)
+	{
+		assign_voice(p_free_voice, p_command);
+		SDL_AtomicAdd(&voices_started, 1);
+		return;
+	}
+
+	/* Every voice busy - Steal from a less important sound or drop this one */
+	if (p_victim != NULL)
+	{
+		assign_voice(p_victim, p_command);
+		SDL_AtomicAdd(&voices_stolen, 1);
+		return;
+	}
+
+	SDL_AtomicAdd(&voices_dropped, 1);
+}
+
+static void drain_command_queue(Uint64 callback_counter)
+{
+	const int tail = SDL_AtomicGet(&command_queue_tail);
+	SDL_MemoryBarrierAcquire();
+
+	int head = SDL_AtomicGet(&command_queue_head);
+	while (head != tail)
+	{
+		const struct audio_mixer_command * const p_command = command_queue + head;
+		start_voice(p_command);
+		if (!mixer_offline)
+			record_latency(p_command->requested_counter, callback_counter);
+		head = (head + 1) % AUDIO_MIXER_COMMAND_QUEUE_CAPACITY;
+	}
+
+	/* Hand the slots back to the producer */
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet(&command_queue_head, head);
+}
+
+static void mix_voice(struct audio_mixer_voice * p_voice, int frame_count)
+{
+	const Uint32 remaining_frames = p_voice->p_sound->frame_count - p_voice->frame_position;
+	const int mixed_frames = ((Uint32)frame_count < remaining_frames) ? frame_count : (int)remaining_frames;
+	const Sint16 * const p_samples = p_voice->p_sound->p_frames + (size_t)p_voice->frame_position * AUDIO_MIXER_CHANNELS;
+
+	int frame_index = 0;
+#if defined(__SSE2__)
+	/* Two stereo frames per step */
+	const __m128 gains = _mm_setr_ps(p_voice->gain_left, p_voice->gain_right, p_voice->gain_left, p_voice->gain_right);
+	for (; frame_index + 2 <= mixed_frames; frame_index += 2)
+	{
+		const __m128i samples_16 = _mm_loadl_epi64((const __m128i *)(p_samples + frame_index * AUDIO_MIXER_CHANNELS));
+		const __m128i samples_32 = _mm_srai_epi32(_mm_unpacklo_epi16(samples_16, samples_16), 16);
+		float * const p_mix = mix_buffer + frame_index * AUDIO_MIXER_CHANNELS;
+		_mm_store_ps(p_mix, _mm_add_ps(_mm_load_ps(p_mix), _mm_mul_ps(_mm_cvtepi32_ps(samples_32), gains)));
+	}
+#endif
+	for (; frame_index < mixed_frames; frame_index++)
+	{
+		mix_buffer[frame_index * AUDIO_MIXER_CHANNELS] += (float)p_samples[frame_index * AUDIO_MIXER_CHANNELS] * p_voice->gain_left;
+		mix_buffer[frame_index * AUDIO_MIXER_CHANNELS + 1] += (float)p_samples[frame_index * AUDIO_MIXER_CHANNELS + 1] * p_voice->gain_right;
+	}
+
+	/* Free the voice once the sound played out */
+	p_voice->frame_position += mixed_frames;
+	if (p_voice->frame_position >= p_voice->p_sound->frame_count)
+		p_voice->p_sound = NULL;
+}
+
+static void write_output(Sint16 * p_output, int sample_count)
+{
+	int sample_index = 0;
+#if defined(__SSE2__)
+	/* Round and saturate eight samples per step */
+	for (; sample_index + 8 <= sample_count; sample_index += 8)
+	{
+		const __m128i low = _mm_cvtps_epi32(_mm_load_ps(mix_buffer + sample_index));
+		const __m128i high = _mm_cvtps_epi32(_mm_load_ps(mix_buffer + sample_index + 4));
+		_mm_storeu_si128((__m128i *)(p_output + sample_index), _mm_packs_epi32(low, high));
+	}
+#endif
+	for (; sample_index < sample_count; sample_index++)
+	{
+		const float sample = mix_buffer[sample_index];
+		p_output[sample_index] = (sample > 32767.0f) ? 32767 : (sample < -32768.0f) ? -32768 : (Sint16)lrintf(sample);
+	}
+}
+
+static void mix_frames(Sint16 * p_output, int frame_count)
+{
+	drain_command_queue(SDL_GetPerformanceCounter());
+
+	/* Accumulate every active voice */
+	for (int sample_index = 0; sample_index < frame_count * AUDIO_MIXER_CHANNELS; sample_index++)
+		mix_buffer[sample_index] = 0.0f;
+
+	/* Music streamed in from the decode thread */
+	audio_music_mix(mix_buffer, frame_count);
+
+	for (int voice_index = 0; voice_index < AUDIO_MIXER_MAX_VOICES; voice_index++)
+	{
+		if (voices[voice_index].p_sound != NULL)
+			mix_voice(voices + voice_index, frame_count);
+	}
+
+	write_output(p_output, frame_count * AUDIO_MIXER_CHANNELS);
+}
+
+static void audio_callback(void * p_user_data, Uint8 * p_stream, int stream_length)
+{
+	/* The device may hand out more than the accumulation buffer holds */
+	const int frame_count = stream_length / (int)(AUDIO_MIXER_CHANNELS * sizeof(Sint16));
+	for (int mixed_frames = 0; mixed_frames < frame_count; mixed_frames += AUDIO_MIXER_MAX_BUFFER_FRAMES)
+	{
+		const int buffer_frames = (frame_count - mixed_frames < AUDIO_MIXER_MAX_BUFFER_FRAMES) ? frame_count - mixed_frames : AUDIO_MIXER_MAX_BUFFER_FRAMES;
+		mix_frames((Sint16 *)p_stream + (size_t)mixed_frames * AUDIO_MIXER_CHANNELS, buffer_frames);
+	}
+}
+
+static pong_bool_te reset_mixer(int buffer_frames)
+{
+	if (buffer_frames < AUDIO_MIXER_MIN_BUFFER_FRAMES || buffer_frames > AUDIO_MIXER_MAX_BUFFER_FRAMES)
+	{
+		fprintf(stderr, "\n[Audio mixer] Buffer of %d frames outside %d - %d", buffer_frames, AUDIO_MIXER_MIN_BUFFER_FRAMES, AUDIO_MIXER_MAX_BUFFER_FRAMES);
+		return PONG_FALSE;
+	}
+
+	/* Start silent with an empty queue */
+	for (int voice_index = 0; voice_index < AUDIO_MIXER_MAX_VOICES; voice_index++)
+		voices[voice_index].p_sound = NULL;
+	SDL_AtomicSet(&command_queue_head, 0);
+	SDL_AtomicSet(&command_queue_tail, 0);
+	audio_mixer_take_latency();
+	audio_mixer_take_voice_stats();
+
+	device_buffer_frames = buffer_frames;
+	offline_frames_due = 0.0;
+	return PONG_TRUE;
+}
+
+/* Function definitions */
+pong_bool_te audio_mixer_open(int buffer_frames)
+{
+	if (mixer_open || !reset_mixer(buffer_frames))
+		return PONG_FALSE;
+
+	/* SDL converts behind the callback should the device not support the mixer format */
+	SDL_AudioSpec desired_spec;
+	SDL_zero(desired_spec);
+	desired_spec.freq = AUDIO_MIXER_FREQUENCY;
+	desired_spec.format = AUDIO_MIXER_FORMAT;
+	desired_spec.channels = AUDIO_MIXER_CHANNELS;
+	desired_spec.samples = (Uint16)buffer_frames;
+	desired_spec.callback = audio_callback;
+
+	SDL_AudioSpec obtained_spec;
+	audio_device = SDL_OpenAudioDevice(NULL, 0, &desired_spec, &obtained_spec, 0);
+	if (audio_device == 0)
+	{
+		fprintf(stderr, "\n[Audio mixer] Could not open audio device - Error: %s", SDL_GetError());
+		return PONG_FALSE;
+	}
+
+	device_buffer_frames = obtained_spec.samples;
+	mixer_open = PONG_TRUE;
+	mixer_offline = PONG_FALSE;
+	SDL_PauseAudioDevice(audio_device, 0);
+	printf(
+		"\n[Audio mixer] Opened with %d frame buffer - %.2f ms",
+		device_buffer_frames,
+		((double)device_buffer_frames * 1000.0) / (double)AUDIO_MIXER_FREQUENCY
+	);
+
+	return PONG_TRUE;
+}
+
+pong_bool_te audio_mixer_open_offline(int buffer_frames)
+{
+	if (mixer_open || !reset_mixer(buffer_frames))
+		return PONG_FALSE;
+
+	mixer_open = PONG_TRUE;
+	mixer_offline = PONG_TRUE;
+	return PONG_TRUE;
+}
+
+int audio_mixer_render(double dt, Sint16 * p_output, int max_frames)
+{
+	if (!mixer_open || !mixer_offline)
+		return 0;
+
+	/* Frames owed for the simulated time - Rounded so whole frame steps survive float error, the rest carries over */
+	offline_frames_due += dt * AUDIO_MIXER_FREQUENCY;
+	int frame_count = (offline_frames_due > 0.5) ? (int)(offline_frames_due + 0.5) : 0;
+	if (frame_count > max_frames)
+		frame_count = max_frames;
+	offline_frames_due -= frame_count;
+
+	/* In device sized buffers - Queued sounds start at the same buffer boundary as they would on a device */
+	for (int rendered_frames = 0; rendered_frames < frame_count; rendered_frames += device_buffer_frames)
+	{
+		const int buffer_frames = (frame_count - rendered_frames < device_buffer_frames) ? frame_count - rendered_frames : device_buffer_frames;
+		mix_frames(p_output + (size_t)rendered_frames * AUDIO_MIXER_CHANNELS, buffer_frames);
+	}
+
+	return frame_count;
+}
+
+Uint64 audio_mixer_checksum(Uint64 checksum, const Sint16 * p_samples, int sample_count)
+{
+	/* FNV-1a over the little endian sample bytes */
+	for (int sample_index = 0; sample_index < sample_count; sample_index++)
+	{
+		const Uint16 sample = (Uint16)p_samples[sample_index];
+		checksum = (checksum ^ (sample & 0xFF)) * 0x100000001b3ULL;
+		checksum = (checksum ^ (sample >> 8)) * 0x100000001b3ULL;
+	}
+
+	return checksum;
+}
+
+pong_bool_te audio_mixer_play(const struct audio_mixer_sound * p_sound, float gain, float pan)
+{
+	if (!mixer_open || p_sound == NULL || p_sound->frame_count == 0)
+		return PONG_FALSE;
+
+	/* Equal power pan from -1 left to 1 right */
+	const float pan_angle = ((pan < -1.0f ? -1.0f : pan > 1.0f ? 1.0f : pan) + 1.0f) * (float)M_PI * 0.25f;
+	const float gain_left = gain * cosf(pan_angle);
+	const float gain_right = gain * sinf(pan_angle);
+
+	/* The same sound is still waiting for the audio callback - Identical requests within one buffer play once */
+	const int tail = SDL_AtomicGet(&command_queue_tail);
+	for (int pending = SDL_AtomicGet(&command_queue_head); pending != tail; pending = (pending + 1) % AUDIO_MIXER_COMMAND_QUEUE_CAPACITY)
+	{
+		const struct audio_mixer_command * const p_pending = command_queue + pending;
+		if (
+			p_pending->p_sound == p_sound &&
+			fabsf(p_pending->gain_left - gain_left) <= AUDIO_MIXER_MERGE_GAIN_TOLERANCE &&
+			fabsf(p_pending->gain_right - gain_right) <= AUDIO_MIXER_MERGE_GAIN_TOLERANCE
+		)
+		{
+			voices_merged++;
+			return PONG_TRUE;
+		}
+	}
+
+	/* Queue full - The audio callback is behind */
+	const int next_tail = (tail + 1) % AUDIO_MIXER_COMMAND_QUEUE_CAPACITY;
+	if (next_tail == SDL_AtomicGet(&command_queue_head))
+		return PONG_FALSE;
+
+	struct audio_mixer_command * const p_command = command_queue + tail;
+	p_command->p_sound = p_sound;
+	p_command->gain_left = gain_left;
+	p_command->gain_right = gain_right;
+	p_command->requested_counter = SDL_GetPerformanceCounter();
+
+	/* Publish the command after it is written */
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet(&command_queue_tail, next_tail);
+	return PONG_TRUE;
+}
+
+struct audio_mixer_latency audio_mixer_take_latency(void)
+{
+	/* Counters are swapped out individually - A callback in between lands in the next report */
+	const int samples = SDL_AtomicSet(&latency_samples, 0);
+	const int sum_in_microseconds = SDL_AtomicSet(&latency_sum_in_microseconds, 0);
+	const int max_in_microseconds = SDL_AtomicSet(&latency_max_in_microseconds, 0);
+
+	return (struct audio_mixer_latency){
+		sum_in_microseconds / 1000.0,
+		max_in_microseconds / 1000.0,
+		samples
+	};
+}
+
+struct audio_mixer_voice_stats audio_mixer_take_voice_stats(void)
+{
+	const int merged = voices_merged;
+	voices_merged = 0;
+
+	return (struct audio_mixer_voice_stats){
+		SDL_AtomicSet(&voices_started, 0),
+		merged,
+		SDL_AtomicSet(&voices_stolen, 0),
+		SDL_AtomicSet(&voices_dropped, 0)
+	};
+}
+
+void audio_mixer_close(void)
+{
+	if (audio_device != 0)
+	{
+		SDL_CloseAudioDevice(audio_device);
+		audio_device = 0;
+	}
+
+	mixer_open = PONG_FALSE;
+	mixer_offline = PONG_FALSE;
+}
@@ -0,0 +1,382 @@
+/* Includes */
+#include <audio_music.h>
+#include <audio_mixer.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Defines */
+#define AUDIO_MUSIC_READ_CHUNK_BYTES (4096)
+#define AUDIO_MUSIC_RING_MASK (AUDIO_MUSIC_RING_FRAMES - 1)
+
+/* Constants */
+static const Uint32 AUDIO_MUSIC_DECODE_INTERVAL_MS = 10;
+static const float AUDIO_MUSIC_GAIN = 0.5f;
+static const int AUDIO_MUSIC_FRAME_BYTES = AUDIO_MIXER_CHANNELS * sizeof(Sint16);
+
+/* Datatypes */
+struct audio_music_track {
+	SDL_RWops * p_file;
+	SDL_AudioStream * p_stream;
+	Sint64 data_offset;
+	Uint32 data_length;
+	Uint32 data_remaining;
+	Uint32 pass_bytes;
+	pong_bool_te loop;
+	pong_bool_te flushed;
+};
+
+struct audio_music_request {
+	pong_bool_te pending;
+	char track_path[AUDIO_MUSIC_MAX_PATH_LENGTH];
+	pong_bool_te loop;
+};
+
+/* Private state */
+static SDL_Thread * p_decode_thread = NULL;
+static SDL_atomic_t decode_thread_running;
+static SDL_sem * p_decode_wakeup = NULL;
+
+/* Track requests - The game thread only copies the path, the decode thread opens the file */
+static SDL_mutex * p_request_mutex = NULL;
+static struct audio_music_request request;
+
+/* Only touched by the decode thread */
+static struct audio_music_track track;
+
+/* Single producer single consumer ring - The decode thread writes, the audio callback reads */
+_Static_assert((AUDIO_MUSIC_RING_FRAMES & AUDIO_MUSIC_RING_MASK) == 0, "Music ring frames must be a power of two");
+static Sint16 ring_frames[AUDIO_MUSIC_RING_FRAMES * AUDIO_MIXER_CHANNELS];
+static SDL_atomic_t ring_write_position;
+static SDL_atomic_t ring_read_position;
+
+/* Everything written before this position belongs to a replaced track - The audio callback skips it */
+static SDL_atomic_t ring_flush_position;
+
+/* Private helper functions */
+static pong_bool_te wav_source_format(Uint16 format_tag, Uint16 bits_per_sample, SDL_AudioFormat * p_format)
+{
+	if (format_tag == 1 && bits_per_sample == 8)
+		*p_format = AUDIO_U8;
+	else if (format_tag == 1 && bits_per_sample == 16)
+		*p_format = AUDIO_S16LSB;
+	else if (format_tag == 1 && bits_per_sample == 32)
+		*p_format = AUDIO_S32LSB;
+	else if (format_tag == 3 && bits_per_sample == 32)
+		*p_format = AUDIO_F32LSB;
+	else
+		return PONG_FALSE;
+
+	return PONG_TRUE;
+}
+
+static void close_track(void)
+{
+	if (track.p_stream != NULL)
+		SDL_FreeAudioStream(track.p_stream);
+	if (track.p_file != NULL)
+		SDL_RWclose(track.p_file);
+
+	track = (struct audio_music_track){ NULL, NULL, 0, 0, 0, 0, PONG_FALSE, PONG_FALSE };
+}
+
+static pong_bool_te open_track(const char * p_track_path, pong_bool_te loop)
+{
+	SDL_RWops * const p_file = SDL_RWFromFile(p_track_path, "rb");
+	if (p_file == NULL)
+	{
+		fprintf(stderr, "\n[Audio music] Could not open track: %s - Error: %s", p_track_path, SDL_GetError());
+		return PONG_FALSE;
+	}
+
+	/* Walk the RIFF chunks up to the samples - Only the header is read here, the samples are streamed */
+	char chunk_id[4];
+	if (SDL_RWread(p_file, chunk_id, 4, 1) != 1 || memcmp(chunk_id, "RIFF", 4) != 0)
+	{
+		fprintf(stderr, "\n[Audio music] Track is not a RIFF file: %s", p_track_path);
+		SDL_RWclose(p_file);
+		return PONG_FALSE;
+	}
+	SDL_ReadLE32(p_file);
+	if (SDL_RWread(p_file, chunk_id, 4, 1) != 1 || memcmp(chunk_id, "WAVE", 4) != 0)
+	{
+		fprintf(stderr, "\n[Audio music] Track is not a WAVE file: %s", p_track_path);
+		SDL_RWclose(p_file);
+		return PONG_FALSE;
+	}
+
+	pong_bool_te format_found = PONG_FALSE;
+	SDL_AudioFormat source_format = 0;
+	Uint16 source_channels = 0;
+	Uint32 source_frequency = 0;
+	while (SDL_RWread(p_file, chunk_id, 4, 1) == 1)
+	{
+		const Uint32 chunk_length = SDL_ReadLE32(p_file);
+		const Sint64 chunk_end = SDL_RWtell(p_file) + chunk_length + (chunk_length & 1);
+
+		if (memcmp(chunk_id, "fmt ", 4) == 0)
+		{
+			const Uint16 format_tag = SDL_ReadLE16(p_file);
+			source_channels = SDL_ReadLE16(p_file);
+			source_frequency = SDL_ReadLE32(p_file);
+			SDL_ReadLE32(p_file);
+			SDL_ReadLE16(p_file);
+			const Uint16 bits_per_sample = SDL_ReadLE16(p_file);
+			format_found = wav_source_format(format_tag, bits_per_sample, &source_format);
+			if (!format_found)
+			{
+				fprintf(stderr, "\n[Audio music] Unsupported sample format %u with %u bits in: %s", format_tag, bits_per_sample, p_track_path);
+				break;
+			}
+		}
+		else if (memcmp(chunk_id, "data", 4) == 0 && format_found)
+		{
+			/* Convert to the mixer format while streaming */
+			SDL_AudioStream * const p_stream = SDL_NewAudioStream(
+				source_format,
+				(Uint8)source_channels,
+				(int)source_frequency,
+				AUDIO_MIXER_FORMAT,
+				AUDIO_MIXER_CHANNELS,
+				AUDIO_MIXER_FREQUENCY
+			);
+			if (p_stream == NULL)
+			{
+				fprintf(stderr, "\n[Audio music] Could not create conversion stream for: %s - Error: %s", p_track_path, SDL_GetError());
+				break;
+			}
+
+			track.p_file = p_file;
+			track.p_stream = p_stream;
+			track.data_offset = SDL_RWtell(p_file);
+			track.data_length = chunk_length;
+			track.data_remaining = chunk_length;
+			track.pass_bytes = 0;
+			track.loop = loop;
+			track.flushed = PONG_FALSE;
+			return PONG_TRUE;
+		}
+
+		if (SDL_RWseek(p_file, chunk_end, RW_SEEK_SET) < 0)
+			break;
+	}
+
+	fprintf(stderr, "\n[Audio music] No playable samples in track: %s", p_track_path);
+	SDL_RWclose(p_file);
+	return PONG_FALSE;
+}
+
+static pong_bool_te feed_track(void)
+{
+	/* More samples from the file */
+	if (track.data_remaining > 0)
+	{
+		Uint8 chunk[AUDIO_MUSIC_READ_CHUNK_BYTES];
+		const size_t chunk_bytes = (track.data_remaining < sizeof(chunk)) ? track.data_remaining : sizeof(chunk);
+		const size_t read_bytes = SDL_RWread(track.p_file, chunk, 1, chunk_bytes);
+		if (read_bytes > 0 && SDL_AudioStreamPut(track.p_stream, chunk, (int)read_bytes) == 0)
+		{
+			track.data_remaining -= (Uint32)read_bytes;
+			track.pass_bytes += (Uint32)read_bytes;
+			return PONG_TRUE;
+		}
+
+		/* Truncated file - Treat as its end */
+		track.data_remaining = 0;
+	}
+
+	/* Start over without draining the converter - The loop point stays seamless
+	   A pass that read nothing would loop forever, it ends the track instead */
+	if (track.loop && track.pass_bytes > 0 && SDL_RWseek(track.p_file, track.data_offset, RW_SEEK_SET) >= 0)
+	{
+		track.data_remaining = track.data_length;
+		track.pass_bytes = 0;
+		return PONG_TRUE;
+	}
+
+	/* Release what the converter still holds back once */
+	if (!track.flushed)
+	{
+		SDL_AudioStreamFlush(track.p_stream);
+		track.flushed = PONG_TRUE;
+		return PONG_TRUE;
+	}
+
+	return PONG_FALSE;
+}
+
+static void fill_ring(void)
+{
+	Uint32 write_position = (Uint32)SDL_AtomicGet(&ring_write_position);
+
+	while (track.p_stream != NULL)
+	{
+		const Uint32 free_frames = AUDIO_MUSIC_RING_FRAMES - (write_position - (Uint32)SDL_AtomicGet(&ring_read_position));
+		if (free_frames == 0)
+			return;
+
+		/* Decode more once the converted samples ran out */
+		const int available_frames = SDL_AudioStreamAvailable(track.p_stream) / AUDIO_MUSIC_FRAME_BYTES;
+		if (available_frames == 0)
+		{
+			if (!feed_track())
+				close_track();
+			continue;
+		}
+
+		/* Up to the end of the ring - The rest wraps around on the next pass */
+		const Uint32 ring_index = write_position & AUDIO_MUSIC_RING_MASK;
+		Uint32 frames = (free_frames < (Uint32)available_frames) ? free_frames : (Uint32)available_frames;
+		if (frames > AUDIO_MUSIC_RING_FRAMES - ring_index)
+			frames = AUDIO_MUSIC_RING_FRAMES - ring_index;
+
+		const int read_bytes = SDL_AudioStreamGet(track.p_stream, ring_frames + ring_index * AUDIO_MIXER_CHANNELS, (int)frames * AUDIO_MUSIC_FRAME_BYTES);
+		if (read_bytes <= 0)
+		{
+			close_track();
+			return;
+		}
+
+		/* Publish the frames after they are written */
+		write_position += (Uint32)read_bytes / AUDIO_MUSIC_FRAME_BYTES;
+		SDL_MemoryBarrierRelease();
+		SDL_AtomicSet(&ring_write_position, (int)write_position);
+	}
+}
+
+static void handle_request(void)
+{
+	struct audio_music_request taken_request;
+
+	SDL_LockMutex(p_request_mutex);
+	taken_request = request;
+	request.pending = PONG_FALSE;
+	SDL_UnlockMutex(p_request_mutex);
+
+	if (!taken_request.pending)
+		return;
+
+	/* Drop the previous track including what is still buffered */
+	close_track();
+	SDL_AtomicSet(&ring_flush_position, SDL_AtomicGet(&ring_write_position));
+
+	if (taken_request.track_path[0] != '\0')
+		open_track(taken_request.track_path, taken_request.loop);
+}
+
+static int decode_thread_run(void * p_data)
+{
+	while (SDL_AtomicGet(&decode_thread_running))
+	{
+		handle_request();
+		fill_ring();
+
+		/* Woken early for new requests */
+		SDL_SemWaitTimeout(p_decode_wakeup, AUDIO_MUSIC_DECODE_INTERVAL_MS);
+	}
+
+	close_track();
+	return 0;
+}
+
+static void post_request(const char * p_track_path, pong_bool_te loop)
+{
+	if (p_decode_thread == NULL)
+		return;
+
+	SDL_LockMutex(p_request_mutex);
+	request.pending = PONG_TRUE;
+	snprintf(request.track_path, AUDIO_MUSIC_MAX_PATH_LENGTH, "%s", p_track_path);
+	request.loop = loop;
+	SDL_UnlockMutex(p_request_mutex);
+
+	SDL_SemPost(p_decode_wakeup);
+}
+
+/* Function definitions */
+pong_bool_te audio_music_initialize(void)
+{
+	close_track();
+	request = (struct audio_music_request){ PONG_FALSE, "", PONG_FALSE };
+	SDL_AtomicSet(&ring_write_position, 0);
+	SDL_AtomicSet(&ring_read_position, 0);
+	SDL_AtomicSet(&ring_flush_position, 0);
+
+	p_request_mutex = SDL_CreateMutex();
+	p_decode_wakeup = SDL_CreateSemaphore(0);
+	if (p_request_mutex == NULL || p_decode_wakeup == NULL)
+	{
+		fprintf(stderr, "\n[Audio music] Could not create synchronization primitives - Error: %s", SDL_GetError());
+		audio_music_cleanup();
+		return PONG_FALSE;
+	}
+
+	SDL_AtomicSet(&decode_thread_running, 1);
+	p_decode_thread = SDL_CreateThread(decode_thread_run, "audio_music_decode", NULL);
+	if (p_decode_thread == NULL)
+	{
+		fprintf(stderr, "\n[Audio music] Could not create decode thread - Error: %s", SDL_GetError());
+		audio_music_cleanup();
+		return PONG_FALSE;
+	}
+
+	return PONG_TRUE;
+}
+
+void audio_music_play(const char * p_track_path, pong_bool_te loop)
+{
+	post_request(p_track_path, loop);
+}
+
+void audio_music_stop(void)
+{
+	post_request("", PONG_FALSE);
+}
+
+void audio_music_mix(float * p_mix_buffer, int frame_count)
+{
+	Uint32 read_position = (Uint32)SDL_AtomicGet(&ring_read_position);
+
+	/* Skip what is left of a replaced track */
+	const Uint32 flush_position = (Uint32)SDL_AtomicGet(&ring_flush_position);
+	if ((Sint32)(flush_position - read_position) > 0)
+		read_position = flush_position;
+
+	const Uint32 write_position = (Uint32)SDL_AtomicGet(&ring_write_position);
+	SDL_MemoryBarrierAcquire();
+
+	/* An underrun plays silence for the missing frames */
+	const Uint32 available_frames = write_position - read_position;
+	const int mixed_frames = ((Uint32)frame_count < available_frames) ? frame_count : (int)available_frames;
+	for (int frame_index = 0; frame_index < mixed_frames; frame_index++)
+	{
+		const Sint16 * const p_frame = ring_frames + ((read_position + frame_index) & AUDIO_MUSIC_RING_MASK) * AUDIO_MIXER_CHANNELS;
+		p_mix_buffer[frame_index * AUDIO_MIXER_CHANNELS] += (float)p_frame[0] * AUDIO_MUSIC_GAIN;
+		p_mix_buffer[frame_index * AUDIO_MIXER_CHANNELS + 1] += (float)p_frame[1] * AUDIO_MUSIC_GAIN;
+	}
+
+	/* Hand the frames back to the decode thread */
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet(&ring_read_position, (int)(read_position + mixed_frames));
+}
+
+void audio_music_cleanup(void)
+{
+	if (p_decode_thread != NULL)
+	{
+		SDL_AtomicSet(&decode_thread_running, 0);
+		SDL_SemPost(p_decode_wakeup);
+		SDL_WaitThread(p_decode_thread, NULL);
+		p_decode_thread = NULL;
+	}
+
+	if (p_decode_wakeup != NULL)
+	{
+		SDL_DestroySemaphore(p_decode_wakeup);
+		p_decode_wakeup = NULL;
+	}
+	if (p_request_mutex != NULL)
+	{
+		SDL_DestroyMutex(p_request_mutex);
+		p_request_mutex = NULL;
+	}
+}
@@ -1,76 +1,224 @@
 /* Includes */
 #include <audio_player.h>
-#include <SDL2/SDL_mixer.h>
 #include <SDL2/SDL.h>
+#include <audio_bank.h>
+#include <audio_mixer.h>
+#include <audio_music.h>
+#include <asset_loader.h>
 
 /* Defines */
 #define MAX_AUDIO_PATH_LENGTH (1024)
+#define AUDIO_PLAYER_OFFLINE_RENDER_FRAMES (4096)
+
+/* Constants */
+static const int AUDIO_PLAYER_BUFFER_FRAMES = 256;
+
+/* Voice policy per effect */
+struct audio_player_sound_effect_policy {
+	int max_instances;
+	enum audio_mixer_priority priority;
+};
+
+static const struct audio_player_sound_effect_policy sound_effect_policies[AUDIO_PLAYER_SFX_TYPE_COUNT] = {
+	[AUDIO_PLAYER_SFX_TYPE_PADDLE_HIT] = { 4, AUDIO_MIXER_PRIORITY_LOW },
+	[AUDIO_PLAYER_SFX_TYPE_SCORE] = { 1, AUDIO_MIXER_PRIORITY_HIGH },
+	[AUDIO_PLAYER_SFX_TYPE_MENU_SELECT] = { 2, AUDIO_MIXER_PRIORITY_NORMAL },
+	[AUDIO_PLAYER_SFX_TYPE_MENU_CHOOSE] = { 1, AUDIO_MIXER_PRIORITY_NORMAL },
+	[AUDIO_PLAYER_SFX_TYPE_MENU_RETURN] = { 1, AUDIO_MIXER_PRIORITY_NORMAL }
+};
+
+/* Music tracks are streamed from disk while playing - Not part of the repository, drop them into
+   resources/audio/music as PCM WAV files. The game plays without music when a track is missing */
+static const char * music_track_filenames[AUDIO_PLAYER_MUSIC_TYPE_COUNT] = {
+	[AUDIO_PLAYER_MUSIC_TYPE_MENU] = "menu.wav"
+};
+
+/* Music track availability - Checked once on the first request */
+enum audio_player_music_track_state {
+	AUDIO_PLAYER_MUSIC_TRACK_UNCHECKED,
+	AUDIO_PLAYER_MUSIC_TRACK_AVAILABLE,
+	AUDIO_PLAYER_MUSIC_TRACK_MISSING
+};
 
 /* Private audio player state */
-Mix_Chunk ** p_sound_effects;
+static struct audio_mixer_sound sound_effects[AUDIO_PLAYER_SFX_TYPE_COUNT];
+static int sound_effect_asset_handles[AUDIO_PLAYER_SFX_TYPE_COUNT];
+static struct audio_bank sound_effect_bank;
+static pong_bool_te music_playing = PONG_FALSE;
+static enum audio_player_music_type music_type_playing;
+static enum audio_player_music_track_state music_track_states[AUDIO_PLAYER_MUSIC_TYPE_COUNT];
+
+/* Offline rendering - Mixed output only feeds the checksum */
+static pong_bool_te offline_rendering = PONG_FALSE;
+static Uint64 offline_checksum = AUDIO_MIXER_CHECKSUM_SEED;
+static Uint64 offline_rendered_frames = 0;
 
 /* Private helper functions */
-static void audio_player_register_sound_effect
+static void audio_player_open_sound_effect_bank(void)
+{
+	/* Bank samples are played in place from the mapped resource pack */
+	const Uint8 * p_packed_bank = NULL;
+	size_t packed_bank_length = 0;
+	if (
+		asset_loader_find_resource("audio/effects.bank", &p_packed_bank, &packed_bank_length) &&
+		audio_bank_open_memory(p_packed_bank, packed_bank_length, &sound_effect_bank)
+	)
+	{
+		if (!audio_bank_matches_format(&sound_effect_bank, AUDIO_MIXER_FREQUENCY, AUDIO_MIXER_FORMAT, AUDIO_MIXER_CHANNELS))
+		{
+			fprintf(stderr, "\n[Audio player] Packed sound effect bank does not match the mixer format - Loading the effect files");
+			audio_bank_close(&sound_effect_bank);
+		}
+		return;
+	}
+
+	static char absolute_bank_path[MAX_AUDIO_PATH_LENGTH];
+	snprintf(
+		absolute_bank_path,
+		MAX_AUDIO_PATH_LENGTH,
+		"%s%s",
+		SDL_GetBasePath(),
+		"../resources/audio/effects.bank"
+	);
+
+	/* No bank - Every effect is decoded from its file */
+	if (!audio_bank_open(absolute_bank_path, &sound_effect_bank))
+	{
+		fprintf(stderr, "\n[Audio player] No sound effect bank at: %s - Loading the effect files", absolute_bank_path);
+		return;
+	}
+
+	/* The samples are only usable as-is in the mixer format */
+	if (!audio_bank_matches_format(&sound_effect_bank, AUDIO_MIXER_FREQUENCY, AUDIO_MIXER_FORMAT, AUDIO_MIXER_CHANNELS))
+	{
+		fprintf(stderr, "\n[Audio player] Sound effect bank does not match the mixer format - Loading the effect files");
+		audio_bank_close(&sound_effect_bank);
+	}
+}
+
+static void audio_player_set_sound_effect
 (
 	enum audio_player_sfx_type sfx_type,
-	const char * p_sound_effect_filename
+	Uint8 * p_samples,
+	Uint32 samples_length
 )
 {
-	/* Get the absolute path for the sound effect file */
-  static char absolute_sound_effect_path[MAX_AUDIO_PATH_LENGTH];
-  snprintf(
-    absolute_sound_effect_path,
-    MAX_AUDIO_PATH_LENGTH,
-    "%s%s/%s",
-    SDL_GetBasePath(),
-    "../resources/audio/effects",
-    p_sound_effect_filename
-  );
-
-  /* Attempt to load the sound effect */
-  p_sound_effects[sfx_type] = Mix_LoadWAV(absolute_sound_effect_path);
-  if (p_sound_effects[sfx_type] == NULL)
-  {
-  	fprintf(
-  		stderr, 
-  		"\n[Audio player] Could not register sound effect: %s in directory: %s",
-  		p_sound_effect_filename,
-  		absolute_sound_effect_path
-  	);
-  }
+	struct audio_mixer_sound * const p_sound_effect = sound_effects + sfx_type;
+	p_sound_effect->p_frames = (const Sint16 *)p_samples;
+	p_sound_effect->frame_count = samples_length / (AUDIO_MIXER_CHANNELS * sizeof(Sint16));
+	p_sound_effect->max_instances = sound_effect_policies[sfx_type].max_instances;
+	p_sound_effect->priority = sound_effect_policies[sfx_type].priority;
 }
 
-/* Function definitions */
-pong_bool_te audio_player_initialize(void)
+static void audio_player_sound_effect_loaded(int asset_handle, void * p_user_data)
 {
-	/* Initialize audio library */
-	if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0)
+	const enum audio_player_sfx_type sfx_type = (enum audio_player_sfx_type)(intptr_t)p_user_data;
+
+	/* Playable from now on - Requests before simply found it unregistered */
+	Uint8 * p_samples = NULL;
+	Uint32 samples_length = 0;
+	if (!asset_loader_sound(asset_handle, &p_samples, &samples_length))
 	{
-		fprintf(stderr, "\n[Audio player] Could not initialize SDL2 mixer - Error: %s", Mix_GetError());
-		return PONG_FALSE;
+		fprintf(stderr, "\n[Audio player] Could not register sound effect type %d", sfx_type);
+		return;
 	}
 
-	/* Allocate a list for registering sounds */
-	p_sound_effects = malloc(sizeof(Mix_Chunk *) * AUDIO_PLAYER_SFX_TYPE_COUNT);
-	if (p_sound_effects == NULL)
+	audio_player_set_sound_effect(sfx_type, p_samples, samples_length);
+}
+
+static void audio_player_register_sound_effect
+(
+	enum audio_player_sfx_type sfx_type,
+	const char * p_sound_effect_filename
+)
+{
+	/* Play the pre-converted samples straight from the mapped bank - No decode, resample or copy */
+	Uint8 * p_samples = NULL;
+	Uint32 samples_length = 0;
+	if (audio_bank_find(&sound_effect_bank, p_sound_effect_filename, &p_samples, &samples_length))
 	{
-		fprintf(stderr, "\n[Audio player] Could not allocate storage for sound effect pointers");
-		return PONG_FALSE;
+		audio_player_set_sound_effect(sfx_type, p_samples, samples_length);
+		return;
 	}
 
-	/* Initialize sound effects pointers so we know which ones are registered at runtime */
+	/* Decode and convert the sound effect file in the background - Local path so requests do not clash */
+	char sound_effect_path[MAX_AUDIO_PATH_LENGTH];
+	snprintf(sound_effect_path, MAX_AUDIO_PATH_LENGTH, "%s/%s", "audio/effects", p_sound_effect_filename);
+	sound_effect_asset_handles[sfx_type] = asset_loader_load(
+		ASSET_LOADER_ASSET_TYPE_SOUND,
+		sound_effect_path,
+		audio_player_sound_effect_loaded,
+		(void *)(intptr_t)sfx_type
+	);
+	if (sound_effect_asset_handles[sfx_type] == ASSET_LOADER_INVALID_HANDLE)
+	{
+		fprintf(stderr, "\n[Audio player] Could not request sound effect: %s", p_sound_effect_filename);
+		return;
+	}
+
+	/* Offline renders must not depend on how fast the decode finished */
+	if (offline_rendering)
+		asset_loader_wait(sound_effect_asset_handles[sfx_type]);
+}
+
+/* Function definitions */
+pong_bool_te audio_player_initialize(pong_bool_te offline)
+{
+	const Uint64 initialize_start_counter = SDL_GetPerformanceCounter();
+	offline_rendering = offline;
+
+	/* Initialize sound effects so we know which ones are registered at runtime */
 	for (int sfx_index = 0; sfx_index < AUDIO_PLAYER_SFX_TYPE_COUNT; sfx_index++)
 	{
-		p_sound_effects[sfx_index] = NULL;
+		sound_effects[sfx_index] = (struct audio_mixer_sound){ NULL, 0, 0, AUDIO_MIXER_PRIORITY_LOW };
+		sound_effect_asset_handles[sfx_index] = ASSET_LOADER_INVALID_HANDLE;
 	}
+	for (int music_index = 0; music_index < AUDIO_PLAYER_MUSIC_TYPE_COUNT; music_index++)
+		music_track_states[music_index] = AUDIO_PLAYER_MUSIC_TRACK_UNCHECKED;
 
-	/* Register music and sound effects */
+	/* Register music and sound effects - Preferably from the pre-converted bank */
+	audio_player_open_sound_effect_bank();
   audio_player_register_sound_effect(AUDIO_PLAYER_SFX_TYPE_PADDLE_HIT, "paddle_hit.wav");
   audio_player_register_sound_effect(AUDIO_PLAYER_SFX_TYPE_SCORE, "score.wav");
   audio_player_register_sound_effect(AUDIO_PLAYER_SFX_TYPE_MENU_SELECT, "menu_select.wav");
   audio_player_register_sound_effect(AUDIO_PLAYER_SFX_TYPE_MENU_CHOOSE, "menu_choose.wav");
   audio_player_register_sound_effect(AUDIO_PLAYER_SFX_TYPE_MENU_RETURN, "menu_return.wav");
 
+	/* Render into memory at the simulation rate - Music decodes asynchronously so it stays off for reproducible output */
+	music_playing = PONG_FALSE;
+	offline_checksum = AUDIO_MIXER_CHECKSUM_SEED;
+	offline_rendered_frames = 0;
+	if (offline_rendering)
+	{
+		if (!audio_mixer_open_offline(AUDIO_PLAYER_BUFFER_FRAMES))
+		{
+			fprintf(stderr, "\n[Audio player] Could not open the offline audio mixer");
+			return PONG_FALSE;
+		}
+
+		printf("\n[Audio player] Rendering offline without an audio device");
+		return PONG_TRUE;
+	}
+
+	/* Music is decoded in the background - Start the decoder before the callback reads from it */
+	if (!audio_music_initialize())
+	{
+		fprintf(stderr, "\n[Audio player] Could not initialize music streaming");
+		return PONG_FALSE;
+	}
+
+	/* Mix in the audio callback with a small buffer */
+	if (!audio_mixer_open(AUDIO_PLAYER_BUFFER_FRAMES))
+	{
+		fprintf(stderr, "\n[Audio player] Could not open the audio mixer");
+		return PONG_FALSE;
+	}
+
+	printf(
+		"\n[Audio player] Initialized in %.2f ms",
+		((double)(SDL_GetPerformanceCounter() - initialize_start_counter) * 1000.0) / (double)SDL_GetPerformanceFrequency()
+	);
+
 	/* Success */
 	return PONG_TRUE;
 }
@@ -80,30 +228,112 @@ pong_bool_te audio_player_play_sound_effect(enum audio_player_sfx_type sfx_type)
 	if (sfx_type < 0 || sfx_type >= AUDIO_PLAYER_SFX_TYPE_COUNT)
 		return PONG_FALSE;
 
-	if (Mix_PlayChannel(-1, p_sound_effects[sfx_type], 0) < 0)
-	{
-		fprintf(
-			stderr,
-			"\n[Audio player] Could not player sound effect with id: %d - Error: %s",
-			sfx_type,
-			Mix_GetError()
-		);
+	/* Not registered */
+	if (sound_effects[sfx_type].p_frames == NULL)
+		return PONG_FALSE;
+
+	/* Queued for the audio callback - Voice limits are applied there so any event rate stays bounded */
+	return audio_mixer_play(sound_effects + sfx_type, 1.0f, 0.0f);
+}
+
+pong_bool_te audio_player_play_music(enum audio_player_music_type music_type)
+{
+	if (music_type < 0 || music_type >= AUDIO_PLAYER_MUSIC_TYPE_COUNT || offline_rendering)
 		return PONG_FALSE;
+
+	/* Keep playing without restarting the track */
+	if (music_playing && music_type_playing == music_type)
+		return PONG_TRUE;
+
+	/* Missing tracks were reported on the first request - Play on without music */
+	if (music_track_states[music_type] == AUDIO_PLAYER_MUSIC_TRACK_MISSING)
+		return PONG_FALSE;
+
+	/* Get the absolute path for the track */
+	static char absolute_music_path[MAX_AUDIO_PATH_LENGTH];
+	char * const p_base_path = SDL_GetBasePath();
+	snprintf(
+		absolute_music_path,
+		MAX_AUDIO_PATH_LENGTH,
+		"%s%s/%s",
+		p_base_path ? p_base_path : "",
+		"../resources/audio/music",
+		music_track_filenames[music_type]
+	);
+	SDL_free(p_base_path);
+
+	/* Only the first request touches the disk on this thread */
+	if (music_track_states[music_type] == AUDIO_PLAYER_MUSIC_TRACK_UNCHECKED)
+	{
+		SDL_RWops * const p_track_file = SDL_RWFromFile(absolute_music_path, "rb");
+		if (p_track_file == NULL)
+		{
+			fprintf(stderr, "\n[Audio player] No music track at: %s - Playing without music", absolute_music_path);
+			music_track_states[music_type] = AUDIO_PLAYER_MUSIC_TRACK_MISSING;
+			return PONG_FALSE;
+		}
+		SDL_RWclose(p_track_file);
+		music_track_states[music_type] = AUDIO_PLAYER_MUSIC_TRACK_AVAILABLE;
 	}
 
+	/* Opened and decoded by the music thread - Never blocks the game loop */
+	audio_music_play(absolute_music_path, PONG_TRUE);
+	music_playing = PONG_TRUE;
+	music_type_playing = music_type;
 	return PONG_TRUE;
 }
 
-void audio_player_cleanup(void)
+void audio_player_stop_music(void)
 {
-	/* Cleanup loaded sound effect and music resources */
-	for (int sfx_index = 0; sfx_index < AUDIO_PLAYER_SFX_TYPE_COUNT; sfx_index++)
+	if (!music_playing)
+		return;
+
+	audio_music_stop();
+	music_playing = PONG_FALSE;
+}
+
+void audio_player_advance(double dt)
+{
+	if (!offline_rendering)
+		return;
+
+	/* Render the simulated time in slices - Only the first slice adds time, the rest drain what is owed */
+	static Sint16 offline_output[AUDIO_PLAYER_OFFLINE_RENDER_FRAMES * AUDIO_MIXER_CHANNELS];
+	int rendered_frames;
+	while ((rendered_frames = audio_mixer_render(dt, offline_output, AUDIO_PLAYER_OFFLINE_RENDER_FRAMES)) > 0)
 	{
-		free(p_sound_effects[sfx_index]);
-		p_sound_effects[sfx_index] = NULL;
+		offline_checksum = audio_mixer_checksum(offline_checksum, offline_output, rendered_frames * AUDIO_MIXER_CHANNELS);
+		offline_rendered_frames += rendered_frames;
+		dt = 0.0;
 	}
-	free(p_sound_effects);
+}
 
-	/* Cleanup subsystem */
-	Mix_Quit();
+Uint64 audio_player_offline_checksum(void)
+{
+	return offline_checksum;
 }
+
+void audio_player_cleanup(void)
+{
+	if (offline_rendering)
+	{
+		printf(
+			"\n[Audio player] Offline render of %llu frames - Checksum %016llx",
+			(unsigned long long)offline_rendered_frames,
+			(unsigned long long)offline_checksum
+		);
+	}
+
+	/* Stop the audio callback before the samples go away */
+	audio_mixer_close();
+	audio_music_cleanup();
+
+	/* Cleanup sound effects loaded from files - Bank samples are unmapped with the bank */
+	for (int sfx_index = 0; sfx_index < AUDIO_PLAYER_SFX_TYPE_COUNT; sfx_index++)
+	{
+		asset_loader_release(sound_effect_asset_handles[sfx_index]);
+		sound_effect_asset_handles[sfx_index] = ASSET_LOADER_INVALID_HANDLE;
+		sound_effects[sfx_index] = (struct audio_mixer_sound){ NULL, 0, 0, AUDIO_MIXER_PRIORITY_LOW };
+	}
+	audio_bank_close(&sound_effect_bank);
+}
\ No newline at end of file
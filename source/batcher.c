@@ -1,12 +1,33 @@
 /* Includes */
+#define GL_GLEXT_PROTOTYPES
+#include <batcher.h>
 #include <vec2f.h>
 #include <SDL2/SDL_opengl.h>
 #include <color4ub.h>
 #include <text_renderer.h>
+#include <texture_atlas.h>
 #include <pong_bool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
 
 /* Defines */
 #define BATCHER_MAX_TRIANGLES (1024)
+#define BATCHER_MAX_BLOCKS (32)
+#define BATCHER_MAX_COMMANDS (64)
+#define BATCHER_MAX_BACKDROPS (4)
+#define BATCHER_MAX_BLOCK_NAME_LENGTH (32)
+#define BATCHER_NO_RECORDING (-1)
+#define BATCHER_SOLID_SIZE (4)
+#define BATCHER_ATTRIBUTE_POSITION (0)
+#define BATCHER_ATTRIBUTE_TEXCOORDS (1)
+#define BATCHER_ATTRIBUTE_COLOR (2)
+#define BATCHER_MAX_PARTICLES (65536)
+#define BATCHER_MAX_PARTICLE_SPANS (8)
+#define BATCHER_PARTICLE_ATTRIBUTE_POSITION_X (0)
+#define BATCHER_PARTICLE_ATTRIBUTE_POSITION_Y (1)
+#define BATCHER_PARTICLE_ATTRIBUTE_SIZE (2)
+#define BATCHER_PARTICLE_ATTRIBUTE_COLOR (3)
 
 /* Data types */
 struct batcher_triangle {
@@ -20,11 +41,59 @@ struct batcher_triangle {
   struct vec2f tcv0;
   struct vec2f tcv1;
   struct vec2f tcv2;
+  float distance_field;
 
   /* Color */
   struct color4ub color;
 };
 
+/* Distance field flag follows the texcoords - Sourced as their third component */
+struct batcher_vertex {
+  struct vec2f position;
+  struct vec2f texcoords;
+  float distance_field;
+  struct color4ub color;
+};
+
+struct batcher_block_span {
+  GLuint texture_handle;
+  GLint first_vertex;
+  GLsizei vertex_count;
+};
+
+struct batcher_block {
+  pong_bool_te in_use;
+  pong_bool_te valid;
+  char name[BATCHER_MAX_BLOCK_NAME_LENGTH];
+  GLuint vertex_buffer_handle;
+  int span_count;
+  struct batcher_block_span * p_spans;
+};
+
+enum batcher_command_type {
+  BATCHER_COMMAND_TYPE_DRAW_BLOCK,
+  BATCHER_COMMAND_TYPE_CAPTURE_BACKDROP,
+  BATCHER_COMMAND_TYPE_DRAW_PARTICLES
+};
+
+struct batcher_command {
+  int triangle_index;
+  enum batcher_command_type type;
+  int target;
+};
+
+struct batcher_particle_span {
+  GLint first_particle;
+  GLsizei particle_count;
+};
+
+struct batcher_backdrop {
+  pong_bool_te valid;
+  GLuint texture_handle;
+  GLint width;
+  GLint height;
+};
+
 /* Private batcher state */
 struct batcher_triangle triangles[BATCHER_MAX_TRIANGLES];
 int batched_triangles = 0;
@@ -33,9 +102,619 @@ GLuint current_texture_handle = 0x00;
 struct vec2f current_texcoords_v0 = { 0.0f, 0.0f };
 struct vec2f current_texcoords_v1 = { 0.0f, 0.0f };
 struct vec2f current_texcoords_v2 = { 0.0f, 0.0f };
-GLuint text_glyph_texture_handle = 0x00;
+static float current_distance_field = 0.0f;
+static int glyph_atlas_region = TEXTURE_ATLAS_INVALID_REGION;
+static int solid_atlas_region = TEXTURE_ATLAS_INVALID_REGION;
+static GLuint atlas_program = 0x00;
+static pong_bool_te glyph_distance_field = PONG_FALSE;
+static pong_bool_te batcher_core_profile = PONG_FALSE;
+static pong_bool_te multi_span_block_reported = PONG_FALSE;
+static pong_bool_te recording_overflowed = PONG_FALSE;
+static pong_bool_te recording_overflow_reported = PONG_FALSE;
+static GLuint core_vertex_array_handle = 0x00;
+static GLuint core_stream_buffer_handle = 0x00;
+static GLuint core_white_texture_handle = 0x00;
+static GLint core_uniform_projection = -1;
+static struct batcher_vertex core_stream_vertices[BATCHER_MAX_TRIANGLES * 3];
+static int batcher_canvas_width = 0;
+static int batcher_canvas_height = 0;
+static struct batcher_block blocks[BATCHER_MAX_BLOCKS];
+static int recording_block_handle = BATCHER_NO_RECORDING;
+static int recording_first_triangle_index = 0;
+static struct batcher_command commands[BATCHER_MAX_COMMANDS];
+static int batched_commands = 0;
+static struct batcher_backdrop backdrops[BATCHER_MAX_BACKDROPS];
+
+/* Particles are staged one array per attribute and uploaded as separate streams of one buffer */
+static float particle_positions_x[BATCHER_MAX_PARTICLES];
+static float particle_positions_y[BATCHER_MAX_PARTICLES];
+static float particle_sizes[BATCHER_MAX_PARTICLES];
+static struct color4ub particle_colors[BATCHER_MAX_PARTICLES];
+static int batched_particles = 0;
+static struct batcher_particle_span particle_spans[BATCHER_MAX_PARTICLE_SPANS];
+static int batched_particle_spans = 0;
+static GLuint particle_program = 0x00;
+static GLuint particle_buffer_handle = 0x00;
+static GLuint particle_vertex_array_handle = 0x00;
+static GLint particle_uniform_projection = -1;
+static GLint particle_uniform_point_scale = -1;
 
 /* Private batcher helpers */
+static struct batcher_block * batcher_block_from_handle(int block_handle)
+{
+  if (block_handle < 0 || block_handle >= BATCHER_MAX_BLOCKS || !blocks[block_handle].in_use)
+    return NULL;
+
+  return blocks + block_handle;
+}
+
+static void batcher_bind_texture(GLuint texture_handle)
+{
+  /* Core profile always samples - Untextured batches read a white texel */
+  if (batcher_core_profile)
+  {
+    glBindTexture(GL_TEXTURE_2D, texture_handle ? texture_handle : core_white_texture_handle);
+    return;
+  }
+
+  /* Textured batches run through the atlas program when distance field text is on */
+  if (texture_handle)
+  {
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, texture_handle);
+    glUseProgram(atlas_program);
+  }
+  else
+  {
+    glDisable(GL_TEXTURE_2D);
+    glUseProgram(0);
+  }
+}
+
+static GLuint batcher_compile_shader(GLenum shader_type, const char * p_source)
+{
+  const GLuint shader = glCreateShader(shader_type);
+  glShaderSource(shader, 1, &p_source, NULL);
+  glCompileShader(shader);
+
+  GLint compiled = GL_FALSE;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+  if (!compiled)
+  {
+    char info_log[512];
+    glGetShaderInfoLog(shader, sizeof(info_log), NULL, info_log);
+    fprintf(stderr, "\n[Batcher] Could not compile shader - Error: %s", info_log);
+    glDeleteShader(shader);
+    return 0x00;
+  }
+
+  return shader;
+}
+
+static GLuint batcher_create_atlas_program(void)
+{
+  /* GLSL 1.20 of the OpenGL 2.1 context - Fixed function inputs so immediate mode and blocks feed it unchanged */
+  static const char * p_legacy_vertex_source =
+    "#version 120\n"
+    "void main()\n"
+    "{\n"
+    "  gl_Position = ftransform();\n"
+    "  gl_FrontColor = gl_Color;\n"
+    "  gl_TexCoord[0] = gl_MultiTexCoord0;\n"
+    "}\n";
+
+  /* Distance field texels cover by distance to the glyph edge at 0.5, smoothed over one screen pixel - Others modulate */
+  static const char * p_legacy_fragment_source =
+    "#version 120\n"
+    "uniform sampler2D atlas;\n"
+    "void main()\n"
+    "{\n"
+    "  vec4 texel = texture2D(atlas, gl_TexCoord[0].st);\n"
+    "  float edge_width = max(fwidth(texel.a) * 0.7, 0.001);\n"
+    "  float coverage = smoothstep(0.5 - edge_width, 0.5 + edge_width, texel.a);\n"
+    "  gl_FragColor = (gl_TexCoord[0].p > 0.5) ? vec4(gl_Color.rgb, gl_Color.a * coverage) : gl_Color * texel;\n"
+    "}\n";
+
+  /* GLSL 3.30 of the core profile - The one program for everything, projected by the canvas matrix */
+  static const char * p_core_vertex_source =
+    "#version 330 core\n"
+    "layout(location = 0) in vec2 position;\n"
+    "layout(location = 1) in vec3 texcoords;\n"
+    "layout(location = 2) in vec4 color;\n"
+    "uniform mat4 projection;\n"
+    "out vec3 vertex_texcoords;\n"
+    "out vec4 vertex_color;\n"
+    "void main()\n"
+    "{\n"
+    "  gl_Position = projection * vec4(position, 0.0, 1.0);\n"
+    "  vertex_texcoords = texcoords;\n"
+    "  vertex_color = color;\n"
+    "}\n";
+
+  static const char * p_core_fragment_source =
+    "#version 330 core\n"
+    "uniform sampler2D atlas;\n"
+    "in vec3 vertex_texcoords;\n"
+    "in vec4 vertex_color;\n"
+    "out vec4 fragment_color;\n"
+    "void main()\n"
+    "{\n"
+    "  vec4 texel = texture(atlas, vertex_texcoords.st);\n"
+    "  float edge_width = max(fwidth(texel.a) * 0.7, 0.001);\n"
+    "  float coverage = smoothstep(0.5 - edge_width, 0.5 + edge_width, texel.a);\n"
+    "  fragment_color = (vertex_texcoords.p > 0.5) ? vec4(vertex_color.rgb, vertex_color.a * coverage) : vertex_color * texel;\n"
+    "}\n";
+
+  const GLuint vertex_shader = batcher_compile_shader(
+    GL_VERTEX_SHADER,
+    batcher_core_profile ? p_core_vertex_source : p_legacy_vertex_source
+  );
+  const GLuint fragment_shader = batcher_compile_shader(
+    GL_FRAGMENT_SHADER,
+    batcher_core_profile ? p_core_fragment_source : p_legacy_fragment_source
+  );
+  GLuint program = 0x00;
+  if (vertex_shader && fragment_shader)
+  {
+    program = glCreateProgram();
+    glAttachShader(program, vertex_shader);
+    glAttachShader(program, fragment_shader);
+    glLinkProgram(program);
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked)
+    {
+      char info_log[512];
+      glGetProgramInfoLog(program, sizeof(info_log), NULL, info_log);
+      fprintf(stderr, "\n[Batcher] Could not link the atlas program - Error: %s", info_log);
+      glDeleteProgram(program);
+      program = 0x00;
+    }
+  }
+
+  /* Shaders stay alive with the program */
+  if (vertex_shader)
+    glDeleteShader(vertex_shader);
+  if (fragment_shader)
+    glDeleteShader(fragment_shader);
+
+  if (program)
+  {
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "atlas"), 0);
+    glUseProgram(0);
+  }
+
+  return program;
+}
+
+static void batcher_vertex_attributes(GLuint vertex_buffer_handle)
+{
+  /* Point the core vertex array at the interleaved vertices of a buffer */
+  const GLsizei vertex_stride = sizeof(struct batcher_vertex);
+  glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_handle);
+  glVertexAttribPointer(BATCHER_ATTRIBUTE_POSITION, 2, GL_FLOAT, GL_FALSE, vertex_stride, (const GLvoid *)offsetof(struct batcher_vertex, position));
+  glVertexAttribPointer(BATCHER_ATTRIBUTE_TEXCOORDS, 3, GL_FLOAT, GL_FALSE, vertex_stride, (const GLvoid *)offsetof(struct batcher_vertex, texcoords));
+  glVertexAttribPointer(BATCHER_ATTRIBUTE_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, vertex_stride, (const GLvoid *)offsetof(struct batcher_vertex, color));
+}
+
+static pong_bool_te batcher_core_initialize(void)
+{
+  /* Every batched triangle streams through one buffer - Sized for a full batch */
+  glGenVertexArrays(1, &core_vertex_array_handle);
+  glBindVertexArray(core_vertex_array_handle);
+  glGenBuffers(1, &core_stream_buffer_handle);
+  glBindBuffer(GL_ARRAY_BUFFER, core_stream_buffer_handle);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(core_stream_vertices), NULL, GL_STREAM_DRAW);
+  batcher_vertex_attributes(core_stream_buffer_handle);
+  glEnableVertexAttribArray(BATCHER_ATTRIBUTE_POSITION);
+  glEnableVertexAttribArray(BATCHER_ATTRIBUTE_TEXCOORDS);
+  glEnableVertexAttribArray(BATCHER_ATTRIBUTE_COLOR);
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  /* Stand-in for the atlas white texels when those are missing */
+  static const Uint8 white_texel[4] = { 255, 255, 255, 255 };
+  glGenTextures(1, &core_white_texture_handle);
+  glBindTexture(GL_TEXTURE_2D, core_white_texture_handle);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white_texel);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+  core_uniform_projection = glGetUniformLocation(atlas_program, "projection");
+  return glGetError() == GL_NO_ERROR;
+}
+
+static void batcher_core_cleanup(void)
+{
+  if (core_white_texture_handle)
+    glDeleteTextures(1, &core_white_texture_handle);
+  if (core_stream_buffer_handle)
+    glDeleteBuffers(1, &core_stream_buffer_handle);
+  if (core_vertex_array_handle)
+    glDeleteVertexArrays(1, &core_vertex_array_handle);
+
+  core_white_texture_handle = 0x00;
+  core_stream_buffer_handle = 0x00;
+  core_vertex_array_handle = 0x00;
+  core_uniform_projection = -1;
+}
+
+static GLuint batcher_create_particle_program(void)
+{
+  /* One point per particle - Sized in canvas units, scaled to framebuffer pixels */
+  static const char * p_legacy_vertex_source =
+    "#version 120\n"
+    "attribute float position_x;\n"
+    "attribute float position_y;\n"
+    "attribute float size;\n"
+    "attribute vec4 color;\n"
+    "uniform float point_scale;\n"
+    "varying vec4 particle_color;\n"
+    "void main()\n"
+    "{\n"
+    "  gl_Position = gl_ModelViewProjectionMatrix * vec4(position_x, position_y, 0.0, 1.0);\n"
+    "  gl_PointSize = max(size * point_scale, 1.0);\n"
+    "  particle_color = color;\n"
+    "}\n";
+
+  static const char * p_legacy_fragment_source =
+    "#version 120\n"
+    "varying vec4 particle_color;\n"
+    "void main()\n"
+    "{\n"
+    "  gl_FragColor = particle_color;\n"
+    "}\n";
+
+  static const char * p_core_vertex_source =
+    "#version 330 core\n"
+    "layout(location = 0) in float position_x;\n"
+    "layout(location = 1) in float position_y;\n"
+    "layout(location = 2) in float size;\n"
+    "layout(location = 3) in vec4 color;\n"
+    "uniform mat4 projection;\n"
+    "uniform float point_scale;\n"
+    "out vec4 particle_color;\n"
+    "void main()\n"
+    "{\n"
+    "  gl_Position = projection * vec4(position_x, position_y, 0.0, 1.0);\n"
+    "  gl_PointSize = max(size * point_scale, 1.0);\n"
+    "  particle_color = color;\n"
+    "}\n";
+
+  static const char * p_core_fragment_source =
+    "#version 330 core\n"
+    "in vec4 particle_color;\n"
+    "out vec4 fragment_color;\n"
+    "void main()\n"
+    "{\n"
+    "  fragment_color = particle_color;\n"
+    "}\n";
+
+  const GLuint vertex_shader = batcher_compile_shader(
+    GL_VERTEX_SHADER,
+    batcher_core_profile ? p_core_vertex_source : p_legacy_vertex_source
+  );
+  const GLuint fragment_shader = batcher_compile_shader(
+    GL_FRAGMENT_SHADER,
+    batcher_core_profile ? p_core_fragment_source : p_legacy_fragment_source
+  );
+  GLuint program = 0x00;
+  if (vertex_shader && fragment_shader)
+  {
+    program = glCreateProgram();
+    glAttachShader(program, vertex_shader);
+    glAttachShader(program, fragment_shader);
+
+    /* Same locations as the core layout qualifiers */
+    glBindAttribLocation(program, BATCHER_PARTICLE_ATTRIBUTE_POSITION_X, "position_x");
+    glBindAttribLocation(program, BATCHER_PARTICLE_ATTRIBUTE_POSITION_Y, "position_y");
+    glBindAttribLocation(program, BATCHER_PARTICLE_ATTRIBUTE_SIZE, "size");
+    glBindAttribLocation(program, BATCHER_PARTICLE_ATTRIBUTE_COLOR, "color");
+    glLinkProgram(program);
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked)
+    {
+      char info_log[512];
+      glGetProgramInfoLog(program, sizeof(info_log), NULL, info_log);
+      fprintf(stderr, "\n[Batcher] Could not link the particle program - Error: %s", info_log);
+      glDeleteProgram(program);
+      program = 0x00;
+    }
+  }
+
+  if (vertex_shader)
+    glDeleteShader(vertex_shader);
+  if (fragment_shader)
+    glDeleteShader(fragment_shader);
+
+  return program;
+}
+
+static void batcher_particle_attributes(void)
+{
+  /* Attribute streams at fixed offsets - One full capacity array after the other */
+  glBindBuffer(GL_ARRAY_BUFFER, particle_buffer_handle);
+  glVertexAttribPointer(BATCHER_PARTICLE_ATTRIBUTE_POSITION_X, 1, GL_FLOAT, GL_FALSE, 0, (const GLvoid *)0);
+  glVertexAttribPointer(BATCHER_PARTICLE_ATTRIBUTE_POSITION_Y, 1, GL_FLOAT, GL_FALSE, 0, (const GLvoid *)sizeof(particle_positions_x));
+  glVertexAttribPointer(BATCHER_PARTICLE_ATTRIBUTE_SIZE, 1, GL_FLOAT, GL_FALSE, 0, (const GLvoid *)(sizeof(particle_positions_x) * 2));
+  glVertexAttribPointer(BATCHER_PARTICLE_ATTRIBUTE_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, (const GLvoid *)(sizeof(particle_positions_x) * 3));
+  glEnableVertexAttribArray(BATCHER_PARTICLE_ATTRIBUTE_POSITION_X);
+  glEnableVertexAttribArray(BATCHER_PARTICLE_ATTRIBUTE_POSITION_Y);
+  glEnableVertexAttribArray(BATCHER_PARTICLE_ATTRIBUTE_SIZE);
+  glEnableVertexAttribArray(BATCHER_PARTICLE_ATTRIBUTE_COLOR);
+}
+
+static void batcher_particles_initialize(void)
+{
+  /* Particles are optional - Without the program they are simply not drawn */
+  particle_program = batcher_create_particle_program();
+  if (!particle_program)
+  {
+    fprintf(stderr, "\n[Batcher] No particle program - Particles are not rendered");
+    return;
+  }
+
+  particle_uniform_projection = glGetUniformLocation(particle_program, "projection");
+  particle_uniform_point_scale = glGetUniformLocation(particle_program, "point_scale");
+  glGenBuffers(1, &particle_buffer_handle);
+  glBindBuffer(GL_ARRAY_BUFFER, particle_buffer_handle);
+  glBufferData(
+    GL_ARRAY_BUFFER,
+    sizeof(particle_positions_x) + sizeof(particle_positions_y) + sizeof(particle_sizes) + sizeof(particle_colors),
+    NULL,
+    GL_STREAM_DRAW
+  );
+
+  /* The core profile keeps the streams in their own vertex array */
+  if (batcher_core_profile)
+  {
+    glGenVertexArrays(1, &particle_vertex_array_handle);
+    glBindVertexArray(particle_vertex_array_handle);
+    batcher_particle_attributes();
+    glBindVertexArray(0);
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+static void batcher_particles_cleanup(void)
+{
+  if (particle_program)
+    glDeleteProgram(particle_program);
+  if (particle_buffer_handle)
+    glDeleteBuffers(1, &particle_buffer_handle);
+  if (particle_vertex_array_handle)
+    glDeleteVertexArrays(1, &particle_vertex_array_handle);
+
+  particle_program = 0x00;
+  particle_buffer_handle = 0x00;
+  particle_vertex_array_handle = 0x00;
+  batched_particles = 0;
+  batched_particle_spans = 0;
+}
+
+static void batcher_particles_upload(void)
+{
+  if (!particle_program || batched_particles <= 0)
+    return;
+
+  /* Orphan and refill only what is batched - Every stream keeps its fixed offset */
+  const GLsizeiptr float_stream_size = sizeof(float) * batched_particles;
+  glBindBuffer(GL_ARRAY_BUFFER, particle_buffer_handle);
+  glBufferData(
+    GL_ARRAY_BUFFER,
+    sizeof(particle_positions_x) + sizeof(particle_positions_y) + sizeof(particle_sizes) + sizeof(particle_colors),
+    NULL,
+    GL_STREAM_DRAW
+  );
+  glBufferSubData(GL_ARRAY_BUFFER, 0, float_stream_size, particle_positions_x);
+  glBufferSubData(GL_ARRAY_BUFFER, sizeof(particle_positions_x), float_stream_size, particle_positions_y);
+  glBufferSubData(GL_ARRAY_BUFFER, sizeof(particle_positions_x) * 2, float_stream_size, particle_sizes);
+  glBufferSubData(GL_ARRAY_BUFFER, sizeof(particle_positions_x) * 3, sizeof(struct color4ub) * batched_particles, particle_colors);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+static void batcher_particles_draw(const struct batcher_particle_span * p_span)
+{
+  if (!particle_program || p_span->particle_count <= 0)
+    return;
+
+  /* Canvas units to framebuffer pixels - Points are sized in pixels */
+  GLint viewport[4];
+  glGetIntegerv(GL_VIEWPORT, viewport);
+  const float point_scale = batcher_canvas_height ? (float)viewport[3] / (float)batcher_canvas_height : 1.0f;
+
+  glUseProgram(particle_program);
+  glUniform1f(particle_uniform_point_scale, point_scale);
+  glEnable(GL_PROGRAM_POINT_SIZE);
+  if (batcher_core_profile)
+  {
+    const float projection[16] = {
+      2.0f / (float)batcher_canvas_width, 0.0f, 0.0f, 0.0f,
+      0.0f, 2.0f / (float)batcher_canvas_height, 0.0f, 0.0f,
+      0.0f, 0.0f, -1.0f, 0.0f,
+      -1.0f, -1.0f, 0.0f, 1.0f
+    };
+    glUniformMatrix4fv(particle_uniform_projection, 1, GL_FALSE, projection);
+    glBindVertexArray(particle_vertex_array_handle);
+    glDrawArrays(GL_POINTS, p_span->first_particle, p_span->particle_count);
+
+    /* Back to the streamed triangles */
+    glBindVertexArray(core_vertex_array_handle);
+    glUseProgram(atlas_program);
+  }
+  else
+  {
+    glDisable(GL_TEXTURE_2D);
+    batcher_particle_attributes();
+    glDrawArrays(GL_POINTS, p_span->first_particle, p_span->particle_count);
+
+    /* Restore immediate mode state */
+    glDisableVertexAttribArray(BATCHER_PARTICLE_ATTRIBUTE_POSITION_X);
+    glDisableVertexAttribArray(BATCHER_PARTICLE_ATTRIBUTE_POSITION_Y);
+    glDisableVertexAttribArray(BATCHER_PARTICLE_ATTRIBUTE_SIZE);
+    glDisableVertexAttribArray(BATCHER_PARTICLE_ATTRIBUTE_COLOR);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glUseProgram(0);
+  }
+  glDisable(GL_PROGRAM_POINT_SIZE);
+}
+
+static void batcher_triangle_vertices(const struct batcher_triangle * p_triangle, struct batcher_vertex * p_out_vertices)
+{
+  p_out_vertices[0] = (struct batcher_vertex){ p_triangle->v0, p_triangle->tcv0, p_triangle->distance_field, p_triangle->color };
+  p_out_vertices[1] = (struct batcher_vertex){ p_triangle->v1, p_triangle->tcv1, p_triangle->distance_field, p_triangle->color };
+  p_out_vertices[2] = (struct batcher_vertex){ p_triangle->v2, p_triangle->tcv2, p_triangle->distance_field, p_triangle->color };
+}
+
+static void batcher_block_release_buffers(struct batcher_block * p_block)
+{
+  if (p_block->vertex_buffer_handle)
+    glDeleteBuffers(1, &p_block->vertex_buffer_handle);
+
+  free(p_block->p_spans);
+  p_block->vertex_buffer_handle = 0x00;
+  p_block->p_spans = NULL;
+  p_block->span_count = 0;
+  p_block->valid = PONG_FALSE;
+}
+
+static pong_bool_te batcher_block_upload
+(
+  struct batcher_block * p_block,
+  const struct batcher_triangle * p_first_triangle,
+  int triangle_count
+)
+{
+  /* Flatten the triangles into interleaved vertices and texture spans */
+  const int vertex_count = triangle_count * 3;
+  struct batcher_vertex * const p_vertices = malloc(sizeof(struct batcher_vertex) * vertex_count);
+  p_block->p_spans = malloc(sizeof(struct batcher_block_span) * triangle_count);
+  if (p_vertices == NULL || p_block->p_spans == NULL)
+  {
+    fprintf(stderr, "\n[Batcher] Could not allocate %d vertices for block '%s'", vertex_count, p_block->name);
+    free(p_vertices);
+    return PONG_FALSE;
+  }
+
+  for (int triangle_index = 0; triangle_index < triangle_count; triangle_index++)
+  {
+    const struct batcher_triangle * const p_triangle = p_first_triangle + triangle_index;
+    batcher_triangle_vertices(p_triangle, p_vertices + triangle_index * 3);
+
+    /* Start a new span on texture changes */
+    struct batcher_block_span * p_span = (p_block->span_count > 0) ? p_block->p_spans + p_block->span_count - 1 : NULL;
+    if (p_span == NULL || p_span->texture_handle != p_triangle->texture_handle)
+    {
+      p_span = p_block->p_spans + p_block->span_count++;
+      p_span->texture_handle = p_triangle->texture_handle;
+      p_span->first_vertex = triangle_index * 3;
+      p_span->vertex_count = 0;
+    }
+    p_span->vertex_count += 3;
+  }
+
+  /* Quads, glyphs and sprites share the atlas page - More spans mean an image landed elsewhere, noted once */
+  if (p_block->span_count > 1 && !multi_span_block_reported)
+  {
+    printf("\n[Batcher] Block '%s' needs %d draw calls - Its textures are not on one atlas page", p_block->name, p_block->span_count);
+    multi_span_block_reported = PONG_TRUE;
+  }
+
+  /* Upload once - The block is drawn from GPU memory until invalidated */
+  glGenBuffers(1, &p_block->vertex_buffer_handle);
+  glBindBuffer(GL_ARRAY_BUFFER, p_block->vertex_buffer_handle);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(struct batcher_vertex) * vertex_count, p_vertices, GL_STATIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  free(p_vertices);
+  return PONG_TRUE;
+}
+
+static void batcher_block_draw(const struct batcher_block * p_block)
+{
+  if (p_block == NULL || !p_block->valid || p_block->span_count <= 0)
+    return;
+
+  /* Source the interleaved vertex attributes from the block buffer */
+  const GLsizei vertex_stride = sizeof(struct batcher_vertex);
+  if (batcher_core_profile)
+  {
+    batcher_vertex_attributes(p_block->vertex_buffer_handle);
+  }
+  else
+  {
+    glBindBuffer(GL_ARRAY_BUFFER, p_block->vertex_buffer_handle);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, vertex_stride, (const GLvoid *)offsetof(struct batcher_vertex, position));
+    glTexCoordPointer(3, GL_FLOAT, vertex_stride, (const GLvoid *)offsetof(struct batcher_vertex, texcoords));
+    glColorPointer(4, GL_UNSIGNED_BYTE, vertex_stride, (const GLvoid *)offsetof(struct batcher_vertex, color));
+  }
+
+  /* One draw call per texture span - A single one while everything is on one atlas page */
+  for (int span_index = 0; span_index < p_block->span_count; span_index++)
+  {
+    const struct batcher_block_span * const p_span = p_block->p_spans + span_index;
+    batcher_bind_texture(p_span->texture_handle);
+    glDrawArrays(GL_TRIANGLES, p_span->first_vertex, p_span->vertex_count);
+  }
+
+  /* Back to the streamed triangles */
+  if (batcher_core_profile)
+  {
+    batcher_vertex_attributes(core_stream_buffer_handle);
+    return;
+  }
+
+  /* Restore immediate mode state */
+  glUseProgram(0);
+  glDisableClientState(GL_COLOR_ARRAY);
+  glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+  glDisableClientState(GL_VERTEX_ARRAY);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+static pong_bool_te batcher_command(enum batcher_command_type type, int target)
+{
+  /* Cap the number of commands */
+  if (batched_commands >= BATCHER_MAX_COMMANDS)
+  {
+    fprintf(stderr, "\n[Batcher] Max number of batch commands reached at index %d", BATCHER_MAX_COMMANDS);
+    return PONG_FALSE;
+  }
+
+  /* Commands execute in order with the batched triangles */
+  struct batcher_command * const p_command = commands + batched_commands++;
+  p_command->triangle_index = batched_triangles;
+  p_command->type = type;
+  p_command->target = target;
+  return PONG_TRUE;
+}
+
+static void batcher_backdrop_copy_framebuffer(struct batcher_backdrop * p_backdrop)
+{
+  /* Copy everything rendered so far in the frame */
+  GLint viewport[4];
+  glGetIntegerv(GL_VIEWPORT, viewport);
+
+  if (!p_backdrop->texture_handle)
+    glGenTextures(1, &p_backdrop->texture_handle);
+
+  glBindTexture(GL_TEXTURE_2D, p_backdrop->texture_handle);
+  glCopyTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, viewport[0], viewport[1], viewport[2], viewport[3], 0);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+  p_backdrop->width = viewport[2];
+  p_backdrop->height = viewport[3];
+  p_backdrop->valid = PONG_TRUE;
+}
+
 static void batcher_texture_handle(GLuint texture_handle)
 {
   current_texture_handle = texture_handle;
@@ -53,6 +732,21 @@ static void batcher_texture_coords
   current_texcoords_v2 = (struct vec2f){ tcv2x, tcv2y };
 }
 
+static struct region2Df batcher_atlas_texcoords(const struct texture_atlas_region * p_region, struct region2Df local_region)
+{
+  /* Texcoords within the image to texcoords within its atlas page */
+  const struct vec2f span = {
+    p_region->texcoords_region.max.x - p_region->texcoords_region.min.x,
+    p_region->texcoords_region.max.y - p_region->texcoords_region.min.y
+  };
+  struct region2Df atlas_region;
+  atlas_region.min.x = p_region->texcoords_region.min.x + local_region.min.x * span.x;
+  atlas_region.min.y = p_region->texcoords_region.min.y + local_region.min.y * span.y;
+  atlas_region.max.x = p_region->texcoords_region.min.x + local_region.max.x * span.x;
+  atlas_region.max.y = p_region->texcoords_region.min.y + local_region.max.y * span.y;
+  return atlas_region;
+}
+
 static void batcher_triangle
 (
   float v0x, float v0y,
@@ -64,6 +758,7 @@ static void batcher_triangle
   if (batched_triangles >= BATCHER_MAX_TRIANGLES)
   {
     fprintf(stderr, "\n[Batcher] Max number of batch triangles reached at index %d", BATCHER_MAX_TRIANGLES);
+    recording_overflowed = (recording_block_handle != BATCHER_NO_RECORDING) ? PONG_TRUE : recording_overflowed;
     return;
   }
 
@@ -82,36 +777,130 @@ static void batcher_triangle
   p_triangle->tcv0 = current_texcoords_v0;
   p_triangle->tcv1 = current_texcoords_v1;
   p_triangle->tcv2 = current_texcoords_v2;
+  p_triangle->distance_field = current_distance_field;
 
   /* Color */
   p_triangle->color = current_color;
 }
 
+static void batcher_execute_command(const struct batcher_command * p_command)
+{
+  if (p_command->type == BATCHER_COMMAND_TYPE_DRAW_BLOCK)
+    batcher_block_draw(batcher_block_from_handle(p_command->target));
+  else if (p_command->type == BATCHER_COMMAND_TYPE_CAPTURE_BACKDROP)
+    batcher_backdrop_copy_framebuffer(backdrops + p_command->target);
+  else if (p_command->type == BATCHER_COMMAND_TYPE_DRAW_PARTICLES)
+    batcher_particles_draw(particle_spans + p_command->target);
+}
+
+static void batcher_render_core(void)
+{
+  /* Orthographic canvas projection - Column major like the fixed function matrices */
+  const float projection[16] = {
+    2.0f / (float)batcher_canvas_width, 0.0f, 0.0f, 0.0f,
+    0.0f, 2.0f / (float)batcher_canvas_height, 0.0f, 0.0f,
+    0.0f, 0.0f, -1.0f, 0.0f,
+    -1.0f, -1.0f, 0.0f, 1.0f
+  };
+  glUseProgram(atlas_program);
+  glUniformMatrix4fv(core_uniform_projection, 1, GL_FALSE, projection);
+  glBindVertexArray(core_vertex_array_handle);
+
+  /* Stream the whole frame in one upload - Orphaning the storage so the previous frame never stalls it */
+  for (int triangle_index = 0; triangle_index < batched_triangles; triangle_index++)
+    batcher_triangle_vertices(triangles + triangle_index, core_stream_vertices + triangle_index * 3);
+
+  glBindBuffer(GL_ARRAY_BUFFER, core_stream_buffer_handle);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(core_stream_vertices), NULL, GL_STREAM_DRAW);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(struct batcher_vertex) * batched_triangles * 3, core_stream_vertices);
+
+  /* One draw per run of triangles sharing a texture - Commands split runs to keep their order */
+  int command_index = 0;
+  int run_first_triangle_index = 0;
+  for (int triangle_index = 0; triangle_index <= batched_triangles; triangle_index++)
+  {
+    const pong_bool_te all_batched = triangle_index == batched_triangles;
+    const pong_bool_te command_due = command_index < batched_commands && commands[command_index].triangle_index == triangle_index;
+    const pong_bool_te texture_changed =
+      !all_batched &&
+      triangles[triangle_index].texture_handle != triangles[run_first_triangle_index].texture_handle;
+
+    if ((all_batched || command_due || texture_changed) && triangle_index > run_first_triangle_index)
+    {
+      batcher_bind_texture(triangles[run_first_triangle_index].texture_handle);
+      glDrawArrays(GL_TRIANGLES, run_first_triangle_index * 3, (triangle_index - run_first_triangle_index) * 3);
+      run_first_triangle_index = triangle_index;
+    }
+
+    while (command_index < batched_commands && commands[command_index].triangle_index == triangle_index)
+      batcher_execute_command(commands + command_index++);
+  }
+
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glUseProgram(0);
+}
+
 /* Batcher function definitions */
-pong_bool_te batcher_initialize(void)
+pong_bool_te batcher_initialize(pong_bool_te core_profile)
 {
   /* Initialize text renderer as requirement for batched rendering */
   if (text_renderer_initialize() == PONG_FALSE)
     return PONG_FALSE;
 
-  /* Construct OpenGL texture for font rendering */
-  /* Solution: https://stackoverflow.com/questions/25771735/creating-opengl-texture-from-sdl2-surface-strange-pixel-values */
-  const SDL_Surface * p_glyph_texture = text_renderer_texture_info();
-  glGenTextures(1, &text_glyph_texture_handle);
-  glBindTexture(GL_TEXTURE_2D, text_glyph_texture_handle);
-  glTexImage2D(
-    GL_TEXTURE_2D,
-    0,
-    GL_RGBA,
-    p_glyph_texture->w,
-    p_glyph_texture->h,
-    0,
-    GL_RGBA,
-    GL_UNSIGNED_BYTE,
-    p_glyph_texture->pixels
+  /* Distance field glyphs render crisp at any font height - Without a program the bitmap sheet is used */
+  batcher_core_profile = core_profile;
+  const struct raw_texture * p_glyph_texture = NULL;
+  atlas_program = batcher_create_atlas_program();
+  if (atlas_program)
+    p_glyph_texture = text_renderer_use_distance_field();
+
+  /* The core profile has no fixed function to fall back to - Its program stays even for bitmap glyphs */
+  if (batcher_core_profile)
+  {
+    if (!atlas_program || !batcher_core_initialize())
+    {
+      fprintf(stderr, "\n[Batcher] Could not set up the core profile renderer");
+      return PONG_FALSE;
+    }
+  }
+  else if (p_glyph_texture == NULL && atlas_program)
+  {
+    glDeleteProgram(atlas_program);
+    atlas_program = 0x00;
+  }
+  glyph_distance_field = (p_glyph_texture != NULL) ? PONG_TRUE : PONG_FALSE;
+  batcher_particles_initialize();
+  printf(
+    "\n[Batcher] Rendering %s glyphs with the %s renderer",
+    glyph_distance_field ? "distance field" : "bitmap",
+    batcher_core_profile ? "core profile" : "fixed function"
   );
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+  /* Glyph sheet into the texture atlas - Packed next to every sprite so the whole frame binds one texture */
+  if (p_glyph_texture == NULL)
+    p_glyph_texture = text_renderer_texture_info();
+  if (p_glyph_texture == NULL || texture_atlas_initialize() == PONG_FALSE)
+    return PONG_FALSE;
+
+  /* Distance field glyphs are magnified well past their texels and need linear filtering */
+  const enum texture_atlas_filter glyph_filter = glyph_distance_field ? TEXTURE_ATLAS_FILTER_LINEAR : TEXTURE_ATLAS_FILTER_NEAREST;
+  glyph_atlas_region = texture_atlas_add(
+    p_glyph_texture->p_header->width,
+    p_glyph_texture->p_header->height,
+    (p_glyph_texture->p_header->format == RAW_TEXTURE_FORMAT_ALPHA8) ? 1 : 4,
+    raw_texture_pixels(p_glyph_texture),
+    glyph_filter
+  );
+  if (glyph_atlas_region == TEXTURE_ATLAS_INVALID_REGION)
+    return PONG_FALSE;
+
+  /* White texels for untextured quads - Sharing the glyph page and filter, texturing is disabled without */
+  static const Uint8 solid_pixels[BATCHER_SOLID_SIZE * BATCHER_SOLID_SIZE] = {
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255
+  };
+  solid_atlas_region = texture_atlas_add(BATCHER_SOLID_SIZE, BATCHER_SOLID_SIZE, 1, solid_pixels, glyph_filter);
+  texture_atlas_upload();
 
   /* Success */
   return PONG_TRUE;
@@ -119,6 +908,33 @@ pong_bool_te batcher_initialize(void)
 
 void batcher_cleanup(void)
 {
+  /* Release all backdrop textures */
+  for (int backdrop_index = 0; backdrop_index < BATCHER_MAX_BACKDROPS; backdrop_index++)
+  {
+    struct batcher_backdrop * const p_backdrop = backdrops + backdrop_index;
+    if (p_backdrop->texture_handle)
+      glDeleteTextures(1, &p_backdrop->texture_handle);
+
+    p_backdrop->texture_handle = 0x00;
+    p_backdrop->valid = PONG_FALSE;
+  }
+
+  /* Release all retained blocks */
+  for (int block_handle = 0; block_handle < BATCHER_MAX_BLOCKS; block_handle++)
+  {
+    batcher_block_destroy(block_handle);
+  }
+
+  if (atlas_program)
+    glDeleteProgram(atlas_program);
+  atlas_program = 0x00;
+  glyph_distance_field = PONG_FALSE;
+  batcher_particles_cleanup();
+  batcher_core_cleanup();
+
+  texture_atlas_cleanup();
+  glyph_atlas_region = TEXTURE_ATLAS_INVALID_REGION;
+  solid_atlas_region = TEXTURE_ATLAS_INVALID_REGION;
   text_renderer_text_cleanup();
 }
 
@@ -148,19 +964,26 @@ void batcher_text
   static struct text_renderer_cache text_info;
   text_renderer_text_info(p_text, base_x, base_y, font_height, &text_info);
 
-  batcher_texture_handle(text_glyph_texture_handle);
+  const struct texture_atlas_region * const p_glyph_region = texture_atlas_region(glyph_atlas_region);
+  if (p_glyph_region == NULL)
+    return;
+
+  /* Only glyphs are distance fields - Everything else samples the atlas as-is */
+  batcher_texture_handle(p_glyph_region->texture_handle);
+  current_distance_field = glyph_distance_field ? 1.0f : 0.0f;
   for (int glyph_index = 0; glyph_index < text_info.glyph_infos_generated; glyph_index++)
   {
     const struct text_renderer_glyph_info * p_info = text_info.glyph_infos + glyph_index;
+    const struct region2Df texcoords_region = batcher_atlas_texcoords(p_glyph_region, p_info->texcoords_region);
 
     /* Lower-right glyph triangle */
     batcher_texture_coords(
-      p_info->texcoords_region.min.x,
-      p_info->texcoords_region.max.y,
-      p_info->texcoords_region.max.x,
-      p_info->texcoords_region.max.y,
-      p_info->texcoords_region.max.x,
-      p_info->texcoords_region.min.y
+      texcoords_region.min.x,
+      texcoords_region.max.y,
+      texcoords_region.max.x,
+      texcoords_region.max.y,
+      texcoords_region.max.x,
+      texcoords_region.min.y
     );
     batcher_triangle(
       p_info->render_region.min.x,
@@ -173,12 +996,12 @@ void batcher_text
 
     /* Upper-left glyph triangle */
     batcher_texture_coords(
-      p_info->texcoords_region.min.x,
-      p_info->texcoords_region.max.y,
-      p_info->texcoords_region.max.x,
-      p_info->texcoords_region.min.y,
-      p_info->texcoords_region.min.x,
-      p_info->texcoords_region.min.y
+      texcoords_region.min.x,
+      texcoords_region.max.y,
+      texcoords_region.max.x,
+      texcoords_region.min.y,
+      texcoords_region.min.x,
+      texcoords_region.min.y
     );
     batcher_triangle(
       p_info->render_region.min.x,
@@ -189,6 +1012,7 @@ void batcher_text
       p_info->render_region.max.y
     );
   }
+  current_distance_field = 0.0f;
 }
 
 void batcher_quadf
@@ -199,91 +1023,170 @@ void batcher_quadf
   float max_y
 )
 {
-  batcher_texture_handle(0);
+  /* Sample the middle of the white atlas texels - Stays in the same batch as text and sprites */
+  const struct texture_atlas_region * const p_solid_region = texture_atlas_region(solid_atlas_region);
+  if (p_solid_region != NULL)
+  {
+    const float center_x = (p_solid_region->texcoords_region.min.x + p_solid_region->texcoords_region.max.x) * 0.5f;
+    const float center_y = (p_solid_region->texcoords_region.min.y + p_solid_region->texcoords_region.max.y) * 0.5f;
+    batcher_texture_handle(p_solid_region->texture_handle);
+    batcher_texture_coords(center_x, center_y, center_x, center_y, center_x, center_y);
+  }
+  else
+  {
+    batcher_texture_handle(0);
+  }
+
+  batcher_triangle(min_x, min_y, max_x, min_y, max_x, max_y);
+  batcher_triangle(min_x, min_y, max_x, max_y, min_x, max_y);
+}
+
+void batcher_sprite
+(
+  int sprite_handle,
+  float min_x,
+  float min_y,
+  float max_x,
+  float max_y
+)
+{
+  const struct texture_atlas_region * const p_region = texture_atlas_region(sprite_handle);
+  if (p_region == NULL)
+    return;
+
+  /* Image top row at max_y like the glyphs */
+  const struct region2Df texcoords = p_region->texcoords_region;
+  batcher_texture_handle(p_region->texture_handle);
+  batcher_texture_coords(texcoords.min.x, texcoords.max.y, texcoords.max.x, texcoords.max.y, texcoords.max.x, texcoords.min.y);
   batcher_triangle(min_x, min_y, max_x, min_y, max_x, max_y);
+  batcher_texture_coords(texcoords.min.x, texcoords.max.y, texcoords.max.x, texcoords.min.y, texcoords.min.x, texcoords.min.y);
   batcher_triangle(min_x, min_y, max_x, max_y, min_x, max_y);
 }
 
+void batcher_particles
+(
+  int particle_count,
+  const float * p_positions_x,
+  const float * p_positions_y,
+  const float * p_sizes,
+  const struct color4ub * p_colors
+)
+{
+  if (!particle_program || particle_count <= 0 || batched_particle_spans >= BATCHER_MAX_PARTICLE_SPANS)
+    return;
+
+  /* Particles beyond the capacity are dropped */
+  if (particle_count > BATCHER_MAX_PARTICLES - batched_particles)
+    particle_count = BATCHER_MAX_PARTICLES - batched_particles;
+  if (particle_count <= 0 || !batcher_command(BATCHER_COMMAND_TYPE_DRAW_PARTICLES, batched_particle_spans))
+    return;
+
+  /* Copied now so the caller may keep simulating - Drawn in order with the batched triangles */
+  memcpy(particle_positions_x + batched_particles, p_positions_x, sizeof(float) * particle_count);
+  memcpy(particle_positions_y + batched_particles, p_positions_y, sizeof(float) * particle_count);
+  memcpy(particle_sizes + batched_particles, p_sizes, sizeof(float) * particle_count);
+  memcpy(particle_colors + batched_particles, p_colors, sizeof(struct color4ub) * particle_count);
+
+  struct batcher_particle_span * const p_span = particle_spans + batched_particle_spans++;
+  p_span->first_particle = batched_particles;
+  p_span->particle_count = particle_count;
+  batched_particles += particle_count;
+}
+
 void batcher_render(void)
 {
+  /* Images added to the atlas since the last frame */
+  texture_atlas_upload();
+  batcher_particles_upload();
+
   /* Batcher OpenGL settings */
   glEnable(GL_BLEND);
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); 
 
+  /* Core profile streams the batch through its vertex array */
+  if (batcher_core_profile)
+  {
+    batcher_render_core();
+    batched_triangles = 0;
+    batched_commands = 0;
+    batched_particles = 0;
+    batched_particle_spans = 0;
+    return;
+  }
+
   /* Batch configuration changes between textured and non-texured primitives */
   GLuint last_texture_handle = 0x00;
+  pong_bool_te batch_open = PONG_FALSE;
+  int command_index = 0;
 
   /* Render added batches in the order added */
-  for (int triangle_index = 0; triangle_index < batched_triangles; triangle_index++)
+  for (int triangle_index = 0; triangle_index <= batched_triangles; triangle_index++)
   {
-    const struct batcher_triangle * p_triangle = triangles + triangle_index;
-    pong_bool_te is_textured = p_triangle->texture_handle ? PONG_TRUE : PONG_FALSE;
-
-    /* End and begin batches on texture unit changes */
-    if (triangle_index == 0)
+    /* Execute the commands batched before this triangle */
+    while (command_index < batched_commands && commands[command_index].triangle_index == triangle_index)
     {
-      /* First batch configured to the first triangle*/
-      if (is_textured)
+      if (batch_open)
       {
-        glEnable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, p_triangle->texture_handle);
-      }
-      else
-      {
-        glDisable(GL_TEXTURE_2D);
+        glEnd();
+        batch_open = PONG_FALSE;
       }
 
-      /* Begin the first batch */
-      last_texture_handle = p_triangle->texture_handle;
-      glBegin(GL_TRIANGLES);
+      batcher_execute_command(commands + command_index++);
     }
-    else
+
+    /* Everything drawn */
+    if (triangle_index == batched_triangles)
+      break;
+
+    const struct batcher_triangle * p_triangle = triangles + triangle_index;
+
+    /* End and begin batches on texture unit changes */
+    if (!batch_open || p_triangle->texture_handle != last_texture_handle)
     {
-      /* Successive batch when texture unit has changed */
-      const GLuint new_texture_handle = p_triangle->texture_handle;
-      if (new_texture_handle != last_texture_handle)
-      {
-        /* Close current batch */
+      /* Close current batch */
+      if (batch_open)
         glEnd();
 
-        /* Configure the next batch */
-        if (is_textured)
-        {
-          glEnable(GL_TEXTURE_2D);
-          glBindTexture(GL_TEXTURE_2D, p_triangle->texture_handle);
-        }
-        else
-        {
-          glDisable(GL_TEXTURE_2D);
-        }
-
-
-        /* Begin the next batch */
-        last_texture_handle = p_triangle->texture_handle;
-        glBegin(GL_TRIANGLES);
-      }
+      /* Configure the next batch */
+      batcher_bind_texture(p_triangle->texture_handle);
+
+      /* Begin the next batch */
+      last_texture_handle = p_triangle->texture_handle;
+      batch_open = PONG_TRUE;
+      glBegin(GL_TRIANGLES);
     }
 
     /* Render data with batch setting */
     glColor4ub(p_triangle->color.red, p_triangle->color.green, p_triangle->color.blue, p_triangle->color.alpha);
-    glTexCoord2f(p_triangle->tcv0.x, p_triangle->tcv0.y);
+    glTexCoord3f(p_triangle->tcv0.x, p_triangle->tcv0.y, p_triangle->distance_field);
     glVertex2f(p_triangle->v0.x, p_triangle->v0.y);
 
-    glTexCoord2f(p_triangle->tcv1.x, p_triangle->tcv1.y);
+    glTexCoord3f(p_triangle->tcv1.x, p_triangle->tcv1.y, p_triangle->distance_field);
     glVertex2f(p_triangle->v1.x, p_triangle->v1.y);
 
-    glTexCoord2f(p_triangle->tcv2.x, p_triangle->tcv2.y);
+    glTexCoord3f(p_triangle->tcv2.x, p_triangle->tcv2.y, p_triangle->distance_field);
     glVertex2f(p_triangle->v2.x, p_triangle->v2.y);
   }
 
   /* Clase last batch if any batch was opened */
-  if (batched_triangles > 0)
+  if (batch_open)
   {
     glEnd();
   }
+  glUseProgram(0);
 
   /* Clear the buffer */
   batched_triangles = 0;
+  batched_commands = 0;
+  batched_particles = 0;
+  batched_particle_spans = 0;
+}
+
+void batcher_canvas(int canvas_width, int canvas_height)
+{
+  /* Projection extents - Captured backdrops are stretched over them */
+  batcher_canvas_width = canvas_width;
+  batcher_canvas_height = canvas_height;
 }
 
 pong_bool_te batcher_text_region
@@ -338,4 +1241,169 @@ pong_bool_te batcher_text_region
   p_out_region->max.y = *p_max_y;
 
   return PONG_TRUE;
-}
\ No newline at end of file
+}
+
+int batcher_block_create(const char * p_name)
+{
+  if (p_name == NULL)
+    return BATCHER_INVALID_BLOCK;
+
+  /* Every caller owns its block - The name only labels diagnostics */
+  int free_block_handle = 0;
+  while (free_block_handle < BATCHER_MAX_BLOCKS && blocks[free_block_handle].in_use)
+    free_block_handle++;
+
+  if (free_block_handle >= BATCHER_MAX_BLOCKS)
+  {
+    fprintf(stderr, "\n[Batcher] Max number of retained blocks reached at %d - Cannot create '%s'", BATCHER_MAX_BLOCKS, p_name);
+    return BATCHER_INVALID_BLOCK;
+  }
+
+  /* Hand out the first unused block slot */
+  struct batcher_block * const p_block = blocks + free_block_handle;
+  p_block->in_use = PONG_TRUE;
+  p_block->valid = PONG_FALSE;
+  snprintf(p_block->name, BATCHER_MAX_BLOCK_NAME_LENGTH, "%s", p_name);
+  p_block->vertex_buffer_handle = 0x00;
+  p_block->span_count = 0;
+  p_block->p_spans = NULL;
+  return free_block_handle;
+}
+
+void batcher_block_destroy(int block_handle)
+{
+  struct batcher_block * const p_block = batcher_block_from_handle(block_handle);
+  if (p_block == NULL)
+    return;
+
+  /* Stop a recording that targets the destroyed block */
+  if (recording_block_handle == block_handle)
+    recording_block_handle = BATCHER_NO_RECORDING;
+
+  batcher_block_release_buffers(p_block);
+  p_block->in_use = PONG_FALSE;
+}
+
+pong_bool_te batcher_block_record_begin(int block_handle)
+{
+  if (batcher_block_from_handle(block_handle) == NULL)
+    return PONG_FALSE;
+
+  /* Blocks cannot be recorded within each other */
+  if (recording_block_handle != BATCHER_NO_RECORDING)
+  {
+    fprintf(stderr, "\n[Batcher] Cannot record block %d while recording block %d", block_handle, recording_block_handle);
+    return PONG_FALSE;
+  }
+
+  /* Everything batched from here on is captured when the recording ends */
+  recording_block_handle = block_handle;
+  recording_first_triangle_index = batched_triangles;
+  recording_overflowed = PONG_FALSE;
+  return PONG_TRUE;
+}
+
+pong_bool_te batcher_block_record_end(void)
+{
+  const int block_handle = recording_block_handle;
+  struct batcher_block * const p_block = batcher_block_from_handle(block_handle);
+  recording_block_handle = BATCHER_NO_RECORDING;
+  if (p_block == NULL)
+    return PONG_FALSE;
+
+  /* Replace the previously uploaded block with the recorded triangles */
+  batcher_block_release_buffers(p_block);
+
+  /* Truncated recordings are not retained - What fit stays batched and the block is recorded again next time */
+  if (recording_overflowed)
+  {
+    if (!recording_overflow_reported)
+    {
+      fprintf(stderr, "\n[Batcher] Block '%s' exceeds %d triangles - Submitting it immediately instead of retaining it", p_block->name, BATCHER_MAX_TRIANGLES);
+      recording_overflow_reported = PONG_TRUE;
+    }
+    recording_overflowed = PONG_FALSE;
+    return PONG_FALSE;
+  }
+
+  const int recorded_triangles = batched_triangles - recording_first_triangle_index;
+  if (recorded_triangles > 0 && !batcher_block_upload(p_block, triangles + recording_first_triangle_index, recorded_triangles))
+  {
+    /* Recorded triangles stay batched so the current frame still renders them */
+    batcher_block_release_buffers(p_block);
+    return PONG_FALSE;
+  }
+
+  /* Draw the block from GPU memory in place of the recorded triangles */
+  p_block->valid = PONG_TRUE;
+  batched_triangles = recording_first_triangle_index;
+  return batcher_block_emit(block_handle);
+}
+
+pong_bool_te batcher_block_emit(int block_handle)
+{
+  const struct batcher_block * const p_block = batcher_block_from_handle(block_handle);
+  if (p_block == NULL || !p_block->valid)
+    return PONG_FALSE;
+
+  /* Emitted blocks cannot be part of another block recording */
+  if (recording_block_handle != BATCHER_NO_RECORDING)
+  {
+    fprintf(stderr, "\n[Batcher] Cannot emit block '%s' while recording a block", p_block->name);
+    return PONG_FALSE;
+  }
+
+  /* Draw the block with a single call in order with the batched triangles */
+  return batcher_command(BATCHER_COMMAND_TYPE_DRAW_BLOCK, block_handle);
+}
+
+void batcher_block_invalidate(int block_handle)
+{
+  struct batcher_block * const p_block = batcher_block_from_handle(block_handle);
+  if (p_block == NULL)
+    return;
+
+  p_block->valid = PONG_FALSE;
+}
+
+pong_bool_te batcher_backdrop_capture(int backdrop_index)
+{
+  if (backdrop_index < 0 || backdrop_index >= BATCHER_MAX_BACKDROPS)
+    return PONG_FALSE;
+
+  /* The framebuffer is copied once everything batched so far is rendered */
+  return batcher_command(BATCHER_COMMAND_TYPE_CAPTURE_BACKDROP, backdrop_index);
+}
+
+pong_bool_te batcher_backdrop(int backdrop_index)
+{
+  if (backdrop_index < 0 || backdrop_index >= BATCHER_MAX_BACKDROPS)
+    return PONG_FALSE;
+
+  /* Captured backdrops cover the whole canvas - They stay usable when the resolution they were captured at changes */
+  const struct batcher_backdrop * const p_backdrop = backdrops + backdrop_index;
+  if (!p_backdrop->valid)
+    return PONG_FALSE;
+
+  /* Draw the captured frame as a single textured quad over the whole canvas */
+  const struct color4ub previous_color = current_color;
+  const float max_x = batcher_canvas_width ? batcher_canvas_width : p_backdrop->width;
+  const float max_y = batcher_canvas_height ? batcher_canvas_height : p_backdrop->height;
+  batcher_color(255, 255, 255, 255);
+  batcher_texture_handle(p_backdrop->texture_handle);
+  batcher_texture_coords(0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f);
+  batcher_triangle(0.0f, 0.0f, max_x, 0.0f, max_x, max_y);
+  batcher_texture_coords(0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f);
+  batcher_triangle(0.0f, 0.0f, max_x, max_y, 0.0f, max_y);
+  current_color = previous_color;
+
+  return PONG_TRUE;
+}
+
+void batcher_backdrop_invalidate(int backdrop_index)
+{
+  if (backdrop_index < 0 || backdrop_index >= BATCHER_MAX_BACKDROPS)
+    return;
+
+  backdrops[backdrop_index].valid = PONG_FALSE;
+}
@@ -0,0 +1,483 @@
+/* Includes */
+#define GL_GLEXT_PROTOTYPES
+#include <frame_capture.h>
+#include <SDL2/SDL_opengl.h>
+#include <SDL2/SDL_image.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Constants */
+static const int FRAME_CAPTURE_BYTES_PER_PIXEL = 4;
+
+/* Datatypes */
+struct frame_capture_pixel_buffer {
+  GLuint handle;
+  size_t capacity;
+  int width;
+  int height;
+  pong_bool_te pending;
+};
+
+/* Owned by the game loop while free, by the writer thread while queued */
+struct frame_capture_slot {
+  Uint8 * p_pixels;
+  size_t capacity;
+  int width;
+  int height;
+  pong_bool_te end_of_recording;
+  char recording_path[FRAME_CAPTURE_MAX_PATH_LENGTH];
+};
+
+/* Private state */
+static pong_bool_te capture_initialized = PONG_FALSE;
+static pong_bool_te capture_recording = PONG_FALSE;
+static enum frame_capture_format capture_format = FRAME_CAPTURE_FORMAT_Y4M;
+static int capture_frame_rate = 60;
+static char capture_path_prefix[FRAME_CAPTURE_MAX_PATH_LENGTH];
+static char recording_path[FRAME_CAPTURE_MAX_PATH_LENGTH];
+static struct frame_capture_stats capture_stats;
+
+/* Readback ring - Only touched by the game loop */
+static struct frame_capture_pixel_buffer pixel_buffers[FRAME_CAPTURE_PIXEL_BUFFER_COUNT];
+static int next_pixel_buffer = 0;
+
+/* Queue of frames for the writer - Head and count under the queue mutex */
+static struct frame_capture_slot slots[FRAME_CAPTURE_QUEUE_LENGTH];
+static int slot_queue_head = 0;
+static int slot_queue_count = 0;
+static pong_bool_te writer_running = PONG_FALSE;
+static SDL_Thread * p_writer = NULL;
+static SDL_mutex * p_queue_mutex = NULL;
+static SDL_cond * p_frame_queued = NULL;
+static SDL_cond * p_frame_written = NULL;
+
+/* Writer side - Only touched by the writer thread */
+static FILE * p_video_file = NULL;
+static int video_width = 0;
+static int video_height = 0;
+static int video_segment = 0;
+static Uint32 image_sequence_index = 0;
+static Uint8 * p_conversion_buffer = NULL;
+static size_t conversion_capacity = 0;
+
+/* Private helper functions */
+static pong_bool_te reserve(Uint8 ** p_buffer, size_t * p_capacity, size_t length)
+{
+  if (length <= *p_capacity)
+    return PONG_TRUE;
+
+  Uint8 * const p_grown = realloc(*p_buffer, length);
+  if (p_grown == NULL)
+    return PONG_FALSE;
+
+  *p_buffer = p_grown;
+  *p_capacity = length;
+  return PONG_TRUE;
+}
+
+static void close_video(void)
+{
+  if (p_video_file != NULL && fclose(p_video_file) != 0)
+    fprintf(stderr, "\n[Frame capture] Could not finish writing the video");
+
+  p_video_file = NULL;
+}
+
+static void write_video_frame(const struct frame_capture_slot * p_slot)
+{
+  /* A new quality level changes the frame size - Continue in the next segment */
+  if (p_video_file != NULL && (p_slot->width != video_width || p_slot->height != video_height))
+  {
+    close_video();
+    video_segment++;
+  }
+
+  if (p_video_file == NULL)
+  {
+    char path[FRAME_CAPTURE_MAX_PATH_LENGTH + 16];
+    if (video_segment == 0)
+      snprintf(path, sizeof(path), "%s.y4m", p_slot->recording_path);
+    else
+      snprintf(path, sizeof(path), "%s_%d.y4m", p_slot->recording_path, video_segment);
+
+    p_video_file = fopen(path, "wb");
+    if (p_video_file == NULL)
+    {
+      fprintf(stderr, "\n[Frame capture] Could not open: %s", path);
+      return;
+    }
+
+    video_width = p_slot->width;
+    video_height = p_slot->height;
+    fprintf(p_video_file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", video_width, video_height, capture_frame_rate);
+    printf("\n[Frame capture] Writing %dx%d video to: %s", video_width, video_height, path);
+  }
+
+  /* Full resolution luma and quarter resolution chroma - Rows flipped from the bottom-up readback */
+  const int width = p_slot->width;
+  const int height = p_slot->height;
+  const size_t luma_length = (size_t)width * height;
+  const size_t chroma_length = luma_length / 4;
+  if (!reserve(&p_conversion_buffer, &conversion_capacity, luma_length + chroma_length * 2))
+    return;
+
+  Uint8 * const p_luma = p_conversion_buffer;
+  Uint8 * const p_chroma_blue = p_luma + luma_length;
+  Uint8 * const p_chroma_red = p_chroma_blue + chroma_length;
+  const size_t stride = (size_t)width * FRAME_CAPTURE_BYTES_PER_PIXEL;
+  for (int row = 0; row < height; row += 2)
+  {
+    const Uint8 * const p_upper = p_slot->p_pixels + (size_t)(height - 1 - row) * stride;
+    const Uint8 * const p_lower = p_upper - stride;
+    Uint8 * const p_luma_upper = p_luma + (size_t)row * width;
+    Uint8 * const p_luma_lower = p_luma_upper + width;
+    const size_t chroma_row = (size_t)(row / 2) * (width / 2);
+
+    for (int column = 0; column < width; column += 2)
+    {
+      /* BT.601 studio range */
+      int red_sum = 0, green_sum = 0, blue_sum = 0;
+      for (int pixel = 0; pixel < 4; pixel++)
+      {
+        const Uint8 * const p_pixel = ((pixel < 2) ? p_upper : p_lower) + (size_t)(column + (pixel & 1)) * FRAME_CAPTURE_BYTES_PER_PIXEL;
+        const int red = p_pixel[0], green = p_pixel[1], blue = p_pixel[2];
+        ((pixel < 2) ? p_luma_upper : p_luma_lower)[column + (pixel & 1)] = (Uint8)(((66 * red + 129 * green + 25 * blue + 128) >> 8) + 16);
+        red_sum += red;
+        green_sum += green;
+        blue_sum += blue;
+      }
+
+      const int red = red_sum / 4, green = green_sum / 4, blue = blue_sum / 4;
+      p_chroma_blue[chroma_row + column / 2] = (Uint8)(((-38 * red - 74 * green + 112 * blue + 128) >> 8) + 128);
+      p_chroma_red[chroma_row + column / 2] = (Uint8)(((112 * red - 94 * green - 18 * blue + 128) >> 8) + 128);
+    }
+  }
+
+  if (
+    fputs("FRAME\n", p_video_file) < 0 ||
+    fwrite(p_conversion_buffer, 1, luma_length + chroma_length * 2, p_video_file) != luma_length + chroma_length * 2
+  )
+  {
+    fprintf(stderr, "\n[Frame capture] Could not write a video frame - Closing the video");
+    close_video();
+  }
+}
+
+static void write_image_frame(const struct frame_capture_slot * p_slot)
+{
+  /* Flip the bottom-up readback into a top-down surface */
+  const size_t stride = (size_t)p_slot->width * FRAME_CAPTURE_BYTES_PER_PIXEL;
+  if (!reserve(&p_conversion_buffer, &conversion_capacity, stride * p_slot->height))
+    return;
+
+  for (int row = 0; row < p_slot->height; row++)
+    memcpy(p_conversion_buffer + (size_t)row * stride, p_slot->p_pixels + (size_t)(p_slot->height - 1 - row) * stride, stride);
+
+  SDL_Surface * const p_image = SDL_CreateRGBSurfaceWithFormatFrom(
+    p_conversion_buffer,
+    p_slot->width,
+    p_slot->height,
+    32,
+    (int)stride,
+    SDL_PIXELFORMAT_RGBA32
+  );
+  if (p_image == NULL)
+    return;
+
+  char path[FRAME_CAPTURE_MAX_PATH_LENGTH + 16];
+  snprintf(path, sizeof(path), "%s_%06u.png", p_slot->recording_path, image_sequence_index++);
+  if (IMG_SavePNG(p_image, path) != 0)
+    fprintf(stderr, "\n[Frame capture] Could not write: %s - Error: %s", path, IMG_GetError());
+  SDL_FreeSurface(p_image);
+}
+
+static int writer_run(void * p_data)
+{
+  SDL_LockMutex(p_queue_mutex);
+  while (writer_running || slot_queue_count > 0)
+  {
+    if (slot_queue_count == 0)
+    {
+      SDL_CondWait(p_frame_queued, p_queue_mutex);
+      continue;
+    }
+
+    /* Encode and write outside the lock - The game loop keeps queueing meanwhile */
+    const struct frame_capture_slot * const p_slot = slots + slot_queue_head;
+    SDL_UnlockMutex(p_queue_mutex);
+
+    if (p_slot->end_of_recording)
+    {
+      close_video();
+      video_segment = 0;
+      image_sequence_index = 0;
+    }
+    else if (capture_format == FRAME_CAPTURE_FORMAT_Y4M)
+      write_video_frame(p_slot);
+    else
+      write_image_frame(p_slot);
+
+    SDL_LockMutex(p_queue_mutex);
+    slot_queue_head = (slot_queue_head + 1) % FRAME_CAPTURE_QUEUE_LENGTH;
+    slot_queue_count--;
+    SDL_CondSignal(p_frame_written);
+  }
+  SDL_UnlockMutex(p_queue_mutex);
+
+  close_video();
+  return 0;
+}
+
+static struct frame_capture_slot * acquire_slot(pong_bool_te wait)
+{
+  /* Slots past the queued ones belong to the game loop */
+  SDL_LockMutex(p_queue_mutex);
+  while (wait && slot_queue_count == FRAME_CAPTURE_QUEUE_LENGTH)
+    SDL_CondWait(p_frame_written, p_queue_mutex);
+  struct frame_capture_slot * const p_slot = (slot_queue_count < FRAME_CAPTURE_QUEUE_LENGTH)
+    ? slots + (slot_queue_head + slot_queue_count) % FRAME_CAPTURE_QUEUE_LENGTH
+    : NULL;
+  SDL_UnlockMutex(p_queue_mutex);
+
+  return p_slot;
+}
+
+static void queue_slot(void)
+{
+  SDL_LockMutex(p_queue_mutex);
+  slot_queue_count++;
+  SDL_CondSignal(p_frame_queued);
+  SDL_UnlockMutex(p_queue_mutex);
+}
+
+static void collect_pixel_buffer(struct frame_capture_pixel_buffer * p_pixel_buffer, pong_bool_te wait)
+{
+  p_pixel_buffer->pending = PONG_FALSE;
+
+  /* Writer is behind - Drop the frame instead of stalling the game loop */
+  struct frame_capture_slot * const p_slot = acquire_slot(wait);
+  const size_t length = (size_t)p_pixel_buffer->width * p_pixel_buffer->height * FRAME_CAPTURE_BYTES_PER_PIXEL;
+  if (p_slot == NULL || !reserve(&p_slot->p_pixels, &p_slot->capacity, length))
+  {
+    capture_stats.dropped++;
+    return;
+  }
+
+  /* Read back frames ago - The copy is long finished by now */
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, p_pixel_buffer->handle);
+  const void * const p_mapped = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+  if (p_mapped != NULL)
+  {
+    memcpy(p_slot->p_pixels, p_mapped, length);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  if (p_mapped == NULL)
+  {
+    capture_stats.dropped++;
+    return;
+  }
+
+  p_slot->width = p_pixel_buffer->width;
+  p_slot->height = p_pixel_buffer->height;
+  p_slot->end_of_recording = PONG_FALSE;
+  strcpy(p_slot->recording_path, recording_path);
+  queue_slot();
+}
+
+/* Function definitions */
+pong_bool_te frame_capture_initialize(enum frame_capture_format format, const char * p_path_prefix, int frame_rate)
+{
+  if (capture_initialized)
+    return PONG_TRUE;
+
+  capture_format = format;
+  capture_frame_rate = (frame_rate > 0) ? frame_rate : 60;
+  snprintf(capture_path_prefix, FRAME_CAPTURE_MAX_PATH_LENGTH, "%s", p_path_prefix);
+  capture_stats = (struct frame_capture_stats){ 0 };
+  slot_queue_head = slot_queue_count = 0;
+  next_pixel_buffer = 0;
+
+  p_queue_mutex = SDL_CreateMutex();
+  p_frame_queued = SDL_CreateCond();
+  p_frame_written = SDL_CreateCond();
+  if (p_queue_mutex == NULL || p_frame_queued == NULL || p_frame_written == NULL)
+  {
+    fprintf(stderr, "\n[Frame capture] Could not create synchronization primitives - Error: %s", SDL_GetError());
+    capture_initialized = PONG_TRUE;
+    frame_capture_cleanup();
+    return PONG_FALSE;
+  }
+
+  writer_running = PONG_TRUE;
+  p_writer = SDL_CreateThread(writer_run, "frame_capture", NULL);
+  if (p_writer == NULL)
+  {
+    fprintf(stderr, "\n[Frame capture] Could not create the writer thread - Error: %s", SDL_GetError());
+    writer_running = PONG_FALSE;
+    capture_initialized = PONG_TRUE;
+    frame_capture_cleanup();
+    return PONG_FALSE;
+  }
+
+  /* Storage is sized by the first readback */
+  for (int buffer_index = 0; buffer_index < FRAME_CAPTURE_PIXEL_BUFFER_COUNT; buffer_index++)
+  {
+    pixel_buffers[buffer_index] = (struct frame_capture_pixel_buffer){ 0 };
+    glGenBuffers(1, &pixel_buffers[buffer_index].handle);
+  }
+
+  capture_initialized = PONG_TRUE;
+  return PONG_TRUE;
+}
+
+pong_bool_te frame_capture_start(void)
+{
+  if (!capture_initialized || capture_recording)
+    return capture_recording;
+
+  /* One recording per start - Named by the local time it started at */
+  char timestamp[32];
+  const time_t now = time(NULL);
+  strftime(timestamp, sizeof(timestamp), "%Y%m%d_%H%M%S", localtime(&now));
+  snprintf(recording_path, FRAME_CAPTURE_MAX_PATH_LENGTH, "%s_%s", capture_path_prefix, timestamp);
+
+  capture_recording = PONG_TRUE;
+  printf(
+    "\n[Frame capture] Recording %s to: %s%s",
+    (capture_format == FRAME_CAPTURE_FORMAT_Y4M) ? "video" : "images",
+    recording_path,
+    (capture_format == FRAME_CAPTURE_FORMAT_Y4M) ? ".y4m" : "_*.png"
+  );
+  return PONG_TRUE;
+}
+
+pong_bool_te frame_capture_recording(void)
+{
+  return capture_recording;
+}
+
+void frame_capture_read(int x, int y, int width, int height)
+{
+  if (!capture_recording)
+    return;
+
+  const Uint64 start_counter = SDL_GetPerformanceCounter();
+
+  /* Chroma is stored per two by two pixels */
+  if (capture_format == FRAME_CAPTURE_FORMAT_Y4M)
+  {
+    width &= ~1;
+    height &= ~1;
+  }
+  if (width <= 0 || height <= 0)
+    return;
+
+  /* Hand over the oldest readback before its buffer is reused */
+  struct frame_capture_pixel_buffer * const p_pixel_buffer = pixel_buffers + next_pixel_buffer;
+  if (p_pixel_buffer->pending)
+    collect_pixel_buffer(p_pixel_buffer, PONG_FALSE);
+
+  /* Asynchronous copy into the buffer - Returns without waiting for the frame to finish */
+  const size_t length = (size_t)width * height * FRAME_CAPTURE_BYTES_PER_PIXEL;
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, p_pixel_buffer->handle);
+  if (length > p_pixel_buffer->capacity)
+  {
+    glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)length, NULL, GL_STREAM_READ);
+    p_pixel_buffer->capacity = length;
+  }
+  glPixelStorei(GL_PACK_ALIGNMENT, 4);
+  glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  p_pixel_buffer->width = width;
+  p_pixel_buffer->height = height;
+  p_pixel_buffer->pending = PONG_TRUE;
+  next_pixel_buffer = (next_pixel_buffer + 1) % FRAME_CAPTURE_PIXEL_BUFFER_COUNT;
+
+  /* Time spent on the game loop */
+  const double elapsed_in_milliseconds = (double)(SDL_GetPerformanceCounter() - start_counter) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+  capture_stats.sum_in_milliseconds += elapsed_in_milliseconds;
+  if (elapsed_in_milliseconds > capture_stats.max_in_milliseconds)
+    capture_stats.max_in_milliseconds = elapsed_in_milliseconds;
+  capture_stats.frames++;
+}
+
+void frame_capture_stop(void)
+{
+  if (!capture_recording)
+    return;
+
+  /* Hand over the frames still in flight in order - Waiting on the writer once at the end is fine */
+  for (int buffer_offset = 0; buffer_offset < FRAME_CAPTURE_PIXEL_BUFFER_COUNT; buffer_offset++)
+  {
+    struct frame_capture_pixel_buffer * const p_pixel_buffer =
+      pixel_buffers + (next_pixel_buffer + buffer_offset) % FRAME_CAPTURE_PIXEL_BUFFER_COUNT;
+    if (p_pixel_buffer->pending)
+      collect_pixel_buffer(p_pixel_buffer, PONG_TRUE);
+  }
+
+  /* Tell the writer to finish the recording */
+  struct frame_capture_slot * const p_slot = acquire_slot(PONG_TRUE);
+  p_slot->end_of_recording = PONG_TRUE;
+  queue_slot();
+
+  capture_recording = PONG_FALSE;
+  printf("\n[Frame capture] Stopped recording: %s", recording_path);
+}
+
+struct frame_capture_stats frame_capture_take_stats(void)
+{
+  const struct frame_capture_stats stats = capture_stats;
+  capture_stats = (struct frame_capture_stats){ 0 };
+  return stats;
+}
+
+void frame_capture_cleanup(void)
+{
+  if (!capture_initialized)
+    return;
+
+  frame_capture_stop();
+
+  /* Writer drains the queue before it exits */
+  if (p_writer != NULL)
+  {
+    SDL_LockMutex(p_queue_mutex);
+    writer_running = PONG_FALSE;
+    SDL_CondSignal(p_frame_queued);
+    SDL_UnlockMutex(p_queue_mutex);
+    SDL_WaitThread(p_writer, NULL);
+    p_writer = NULL;
+  }
+
+  if (p_frame_written != NULL)
+    SDL_DestroyCond(p_frame_written);
+  if (p_frame_queued != NULL)
+    SDL_DestroyCond(p_frame_queued);
+  if (p_queue_mutex != NULL)
+    SDL_DestroyMutex(p_queue_mutex);
+  p_frame_written = NULL;
+  p_frame_queued = NULL;
+  p_queue_mutex = NULL;
+
+  for (int buffer_index = 0; buffer_index < FRAME_CAPTURE_PIXEL_BUFFER_COUNT; buffer_index++)
+  {
+    if (pixel_buffers[buffer_index].handle)
+      glDeleteBuffers(1, &pixel_buffers[buffer_index].handle);
+    pixel_buffers[buffer_index] = (struct frame_capture_pixel_buffer){ 0 };
+  }
+
+  for (int slot_index = 0; slot_index < FRAME_CAPTURE_QUEUE_LENGTH; slot_index++)
+  {
+    free(slots[slot_index].p_pixels);
+    slots[slot_index] = (struct frame_capture_slot){ 0 };
+  }
+
+  free(p_conversion_buffer);
+  p_conversion_buffer = NULL;
+  conversion_capacity = 0;
+  capture_initialized = PONG_FALSE;
+}
\ No newline at end of file
@@ -0,0 +1,228 @@
+/* Includes */
+#define GL_GLEXT_PROTOTYPES
+#include <frame_governor.h>
+#include <SDL2/SDL_opengl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Defines */
+#define FRAME_GOVERNOR_WINDOW_FRAMES (120)
+#define FRAME_GOVERNOR_GPU_QUERIES (4)
+
+/* Constants */
+static const double FRAME_GOVERNOR_DEGRADE_FRACTION = 0.9;
+static const double FRAME_GOVERNOR_RESTORE_FRACTION = 0.5;
+static const int FRAME_GOVERNOR_RESTORE_WINDOWS = 3;
+
+/* Datatypes */
+struct frame_governor_gpu_query {
+  GLuint query_handle;
+  pong_bool_te pending;
+};
+
+/* Private state */
+static double target_ms = 0.0;
+static int max_level = 0;
+static int current_level = 0;
+static int headroom_windows = 0;
+static int window_frames = 0;
+static double cpu_samples[FRAME_GOVERNOR_WINDOW_FRAMES];
+static double gpu_samples[FRAME_GOVERNOR_WINDOW_FRAMES];
+static double cost_samples[FRAME_GOVERNOR_WINDOW_FRAMES];
+static double sorted_samples[FRAME_GOVERNOR_WINDOW_FRAMES];
+static pong_bool_te gpu_timing_enabled = PONG_FALSE;
+static struct frame_governor_gpu_query gpu_queries[FRAME_GOVERNOR_GPU_QUERIES];
+static int gpu_query_index = 0;
+static pong_bool_te gpu_query_open = PONG_FALSE;
+static double last_gpu_ms = 0.0;
+
+/* Private helper functions */
+static int compare_samples(const void * p_left, const void * p_right)
+{
+  const double left = *(const double *)p_left;
+  const double right = *(const double *)p_right;
+  return (left > right) - (left < right);
+}
+
+static double percentile(const double * p_samples, int sample_count, double fraction)
+{
+  /* Nearest rank on a sorted copy - The window is small enough to sort once per evaluation */
+  memcpy(sorted_samples, p_samples, sizeof(double) * sample_count);
+  qsort(sorted_samples, sample_count, sizeof(double), compare_samples);
+
+  const int rank = (int)(fraction * sample_count + 0.5) - 1;
+  return sorted_samples[(rank < 0) ? 0 : (rank >= sample_count) ? sample_count - 1 : rank];
+}
+
+static void poll_gpu_queries(void)
+{
+  /* Only finished queries are read - The newest one available wins, none ever blocks */
+  for (int query_offset = 1; query_offset <= FRAME_GOVERNOR_GPU_QUERIES; query_offset++)
+  {
+    struct frame_governor_gpu_query * const p_query = gpu_queries + (gpu_query_index + query_offset) % FRAME_GOVERNOR_GPU_QUERIES;
+    if (!p_query->pending)
+      continue;
+
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(p_query->query_handle, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+      continue;
+
+    GLuint64 elapsed_ns = 0;
+    glGetQueryObjectui64v(p_query->query_handle, GL_QUERY_RESULT, &elapsed_ns);
+    last_gpu_ms = (double)elapsed_ns / 1000000.0;
+    p_query->pending = PONG_FALSE;
+  }
+}
+
+static void evaluate_window(void)
+{
+  const double cost_p50 = percentile(cost_samples, window_frames, 0.50);
+  const double cost_p95 = percentile(cost_samples, window_frames, 0.95);
+  const double cost_p99 = percentile(cost_samples, window_frames, 0.99);
+  const double cpu_p95 = percentile(cpu_samples, window_frames, 0.95);
+  const double gpu_p95 = percentile(gpu_samples, window_frames, 0.95);
+  printf(
+    "\n[Frame governor] Level %d - Frame cost p50 %.2f ms - p95 %.2f ms - p99 %.2f ms - CPU p95 %.2f ms - GPU p95 %.2f ms - Target %.2f ms",
+    current_level,
+    cost_p50,
+    cost_p95,
+    cost_p99,
+    cpu_p95,
+    gpu_p95,
+    target_ms
+  );
+
+  /* Step down at once when over budget, back up only after sustained headroom */
+  const int previous_level = current_level;
+  if (cost_p95 > target_ms * FRAME_GOVERNOR_DEGRADE_FRACTION)
+  {
+    headroom_windows = 0;
+    if (current_level < max_level)
+      current_level++;
+  }
+  else if (cost_p95 < target_ms * FRAME_GOVERNOR_RESTORE_FRACTION)
+  {
+    if (++headroom_windows >= FRAME_GOVERNOR_RESTORE_WINDOWS && current_level > 0)
+    {
+      current_level--;
+      headroom_windows = 0;
+    }
+  }
+  else
+  {
+    headroom_windows = 0;
+  }
+
+  if (current_level != previous_level)
+  {
+    printf(
+      "\n[Frame governor] Level %d -> %d - p95 %.2f ms %s %.2f ms",
+      previous_level,
+      current_level,
+      cost_p95,
+      (current_level > previous_level) ? "over the budget of" : "with headroom under",
+      target_ms * ((current_level > previous_level) ? FRAME_GOVERNOR_DEGRADE_FRACTION : FRAME_GOVERNOR_RESTORE_FRACTION)
+    );
+  }
+}
+
+/* Function definitions */
+void frame_governor_initialize(double target_frame_ms, int level_count, pong_bool_te gpu_timing)
+{
+  frame_governor_cleanup();
+
+  target_ms = target_frame_ms;
+  max_level = (level_count > 0) ? level_count - 1 : 0;
+  current_level = 0;
+  headroom_windows = 0;
+  window_frames = 0;
+  last_gpu_ms = 0.0;
+
+  /* Timer queries ring - Results are read frames later so the GPU is never waited on */
+  gpu_timing_enabled = gpu_timing;
+  if (gpu_timing_enabled)
+  {
+    for (int query_index = 0; query_index < FRAME_GOVERNOR_GPU_QUERIES; query_index++)
+    {
+      glGenQueries(1, &gpu_queries[query_index].query_handle);
+      gpu_queries[query_index].pending = PONG_FALSE;
+    }
+  }
+
+  printf(
+    "\n[Frame governor] Target %.2f ms - %d levels - %s",
+    target_ms,
+    max_level + 1,
+    gpu_timing_enabled ? "CPU and GPU timed" : "CPU timed"
+  );
+}
+
+void frame_governor_gpu_begin(void)
+{
+  if (!gpu_timing_enabled)
+    return;
+
+  /* Skip timing the frame while its query slot is still in flight */
+  gpu_query_index = (gpu_query_index + 1) % FRAME_GOVERNOR_GPU_QUERIES;
+  struct frame_governor_gpu_query * const p_query = gpu_queries + gpu_query_index;
+  poll_gpu_queries();
+  if (p_query->pending)
+    return;
+
+  glBeginQuery(GL_TIME_ELAPSED, p_query->query_handle);
+  gpu_query_open = PONG_TRUE;
+}
+
+void frame_governor_gpu_end(void)
+{
+  if (!gpu_query_open)
+    return;
+
+  glEndQuery(GL_TIME_ELAPSED);
+  gpu_queries[gpu_query_index].pending = PONG_TRUE;
+  gpu_query_open = PONG_FALSE;
+}
+
+pong_bool_te frame_governor_frame(double cpu_frame_ms, int * p_out_level)
+{
+  /* GPU time trails by a few frames - Close enough for a rolling window */
+  const double gpu_frame_ms = gpu_timing_enabled ? last_gpu_ms : 0.0;
+  cpu_samples[window_frames] = cpu_frame_ms;
+  gpu_samples[window_frames] = gpu_frame_ms;
+  cost_samples[window_frames] = (cpu_frame_ms > gpu_frame_ms) ? cpu_frame_ms : gpu_frame_ms;
+  if (++window_frames < FRAME_GOVERNOR_WINDOW_FRAMES)
+    return PONG_FALSE;
+
+  /* Fresh window per evaluation - Frames across a level change never mix */
+  const int previous_level = current_level;
+  evaluate_window();
+  window_frames = 0;
+
+  *p_out_level = current_level;
+  return current_level != previous_level;
+}
+
+int frame_governor_level(void)
+{
+  return current_level;
+}
+
+void frame_governor_cleanup(void)
+{
+  if (gpu_query_open)
+    glEndQuery(GL_TIME_ELAPSED);
+  gpu_query_open = PONG_FALSE;
+
+  if (gpu_timing_enabled)
+  {
+    for (int query_index = 0; query_index < FRAME_GOVERNOR_GPU_QUERIES; query_index++)
+    {
+      glDeleteQueries(1, &gpu_queries[query_index].query_handle);
+      gpu_queries[query_index].query_handle = 0x00;
+      gpu_queries[query_index].pending = PONG_FALSE;
+    }
+  }
+  gpu_timing_enabled = PONG_FALSE;
+}
@@ -0,0 +1,289 @@
+/* Includes */
+#include <input_bindings.h>
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdlib.h>
+
+/* Defines */
+#define MAX_CONFIG_PATH_LENGTH (1024)
+#define MAX_CONFIG_LINE_LENGTH (256)
+
+/* Constants */
+static const char * INPUT_BINDINGS_CONFIG_DIRECTORY = "../resources/config";
+
+static const char * INPUT_BINDINGS_SETTING_AXIS_DEADZONE = "axis_deadzone";
+static const char * INPUT_BINDINGS_SETTING_AXIS_RESPONSE = "axis_response";
+
+/* Config names of the custom key types in enum order */
+static const char * custom_key_type_names[INPUT_MAPPER_KEY_TYPE_COUNT] = {
+	"left_paddle_up",
+	"left_paddle_down",
+	"right_paddle_up",
+	"right_paddle_down",
+	"quit_application",
+	"menu_select",
+	"menu_return",
+	"menu_up",
+	"menu_down",
+	"menu_left",
+	"menu_right",
+	"dev_1",
+	"dev_2",
+	"dev_3"
+};
+
+/* Private helper functions */
+static pong_bool_te config_path(const char * p_config_filename, char * p_out_path)
+{
+	/* Get the absolute path for the config file */
+	char * const p_base_path = SDL_GetBasePath();
+	if (p_base_path == NULL)
+	{
+		fprintf(stderr, "\n[Input bindings] Could not get the base path - Error: %s", SDL_GetError());
+		return PONG_FALSE;
+	}
+
+	snprintf(
+		p_out_path,
+		MAX_CONFIG_PATH_LENGTH,
+		"%s%s/%s",
+		p_base_path,
+		INPUT_BINDINGS_CONFIG_DIRECTORY,
+		p_config_filename
+	);
+	SDL_free(p_base_path);
+	return PONG_TRUE;
+}
+
+static int custom_key_type_from_name(const char * p_name)
+{
+	for (int custom_key_type = 0; custom_key_type < INPUT_MAPPER_KEY_TYPE_COUNT; custom_key_type++)
+	{
+		if (strcmp(custom_key_type_names[custom_key_type], p_name) == 0)
+			return custom_key_type;
+	}
+
+	return -1;
+}
+
+static char * trim(char * p_text)
+{
+	while (isspace((unsigned char)*p_text))
+		p_text++;
+
+	char * p_end = p_text + strlen(p_text);
+	while (p_end > p_text && isspace((unsigned char)p_end[-1]))
+		*--p_end = '\0';
+
+	return p_text;
+}
+
+static pong_bool_te parse_setting(float * p_axis_deadzone, float * p_axis_response_exponent, const char * p_setting, const char * p_value)
+{
+	char * p_value_end = NULL;
+	const float value = strtof(p_value, &p_value_end);
+	if (p_value_end == p_value || *p_value_end != '\0')
+		return PONG_FALSE;
+
+	/* Deadzone as a fraction of the full axis range */
+	if (strcmp(p_setting, INPUT_BINDINGS_SETTING_AXIS_DEADZONE) == 0 && value >= 0.0f && value < 1.0f)
+	{
+		*p_axis_deadzone = value;
+		return PONG_TRUE;
+	}
+
+	/* Response curve exponent - 1 is linear, larger values give finer control near the center */
+	if (strcmp(p_setting, INPUT_BINDINGS_SETTING_AXIS_RESPONSE) == 0 && value > 0.0f)
+	{
+		*p_axis_response_exponent = value;
+		return PONG_TRUE;
+	}
+
+	return PONG_FALSE;
+}
+
+static pong_bool_te parse_binding(const char * p_type, const char * p_name, struct input_mapper_binding * p_out_binding)
+{
+	/* Keyboard keys by SDL scancode name - e.g. Left Shift */
+	if (strcmp(p_type, "key") == 0)
+	{
+		*p_out_binding = (struct input_mapper_binding){ INPUT_MAPPER_BINDING_TYPE_KEY, SDL_GetScancodeFromName(p_name) };
+		return (p_out_binding->code != SDL_SCANCODE_UNKNOWN) ? PONG_TRUE : PONG_FALSE;
+	}
+
+	/* Game controller buttons by SDL name - e.g. dpup */
+	if (strcmp(p_type, "button") == 0)
+	{
+		*p_out_binding = (struct input_mapper_binding){ INPUT_MAPPER_BINDING_TYPE_CONTROLLER_BUTTON, SDL_GameControllerGetButtonFromString(p_name) };
+		return (p_out_binding->code != SDL_CONTROLLER_BUTTON_INVALID) ? PONG_TRUE : PONG_FALSE;
+	}
+
+	/* Game controller axis directions by sign and SDL name - e.g. -lefty */
+	if (strcmp(p_type, "axis") == 0 && (p_name[0] == '-' || p_name[0] == '+'))
+	{
+		const enum input_mapper_binding_type type = (p_name[0] == '-')
+			? INPUT_MAPPER_BINDING_TYPE_CONTROLLER_AXIS_NEGATIVE
+			: INPUT_MAPPER_BINDING_TYPE_CONTROLLER_AXIS_POSITIVE;
+		*p_out_binding = (struct input_mapper_binding){ type, SDL_GameControllerGetAxisFromString(p_name + 1) };
+		return (p_out_binding->code != SDL_CONTROLLER_AXIS_INVALID) ? PONG_TRUE : PONG_FALSE;
+	}
+
+	return PONG_FALSE;
+}
+
+static pong_bool_te write_binding(FILE * p_file, const char * p_custom_key_name, const struct input_mapper_binding * p_binding)
+{
+	switch (p_binding->type)
+	{
+		case INPUT_MAPPER_BINDING_TYPE_KEY:
+			return fprintf(p_file, "%s key %s\n", p_custom_key_name, SDL_GetScancodeName(p_binding->code)) > 0;
+		case INPUT_MAPPER_BINDING_TYPE_CONTROLLER_BUTTON:
+			return fprintf(p_file, "%s button %s\n", p_custom_key_name, SDL_GameControllerGetStringForButton(p_binding->code)) > 0;
+		case INPUT_MAPPER_BINDING_TYPE_CONTROLLER_AXIS_NEGATIVE:
+			return fprintf(p_file, "%s axis -%s\n", p_custom_key_name, SDL_GameControllerGetStringForAxis(p_binding->code)) > 0;
+		case INPUT_MAPPER_BINDING_TYPE_CONTROLLER_AXIS_POSITIVE:
+			return fprintf(p_file, "%s axis +%s\n", p_custom_key_name, SDL_GameControllerGetStringForAxis(p_binding->code)) > 0;
+		default:
+			return PONG_TRUE;
+	}
+}
+
+/* Function definitions */
+pong_bool_te input_bindings_load(struct input_mapper_instance * p_instance, const char * p_config_filename)
+{
+	char path[MAX_CONFIG_PATH_LENGTH];
+	if (!config_path(p_config_filename, path))
+		return PONG_FALSE;
+
+	/* Keep the built-in bindings and write them out for editing when there is no config yet */
+	FILE * p_file = fopen(path, "r");
+	if (p_file == NULL)
+	{
+		fprintf(stderr, "\n[Input bindings] No config at: %s - Writing the default bindings", path);
+		return input_bindings_save(p_instance, p_config_filename);
+	}
+
+	/* Parse into a separate table first - The instance is only touched once the whole file is read */
+	struct input_mapper_binding parsed_bindings[INPUT_MAPPER_KEY_TYPE_COUNT][INPUT_MAPPER_MAX_BINDINGS_PER_KEY];
+	int parsed_binding_counts[INPUT_MAPPER_KEY_TYPE_COUNT] = { 0 };
+	float axis_deadzone = p_instance->axis_deadzone;
+	float axis_response_exponent = p_instance->axis_response_exponent;
+
+	/* One binding per line - <custom key> <key|button|axis> <name> */
+	char line[MAX_CONFIG_LINE_LENGTH];
+	int line_number = 0;
+	while (fgets(line, MAX_CONFIG_LINE_LENGTH, p_file) != NULL)
+	{
+		line_number++;
+		char * p_line = trim(line);
+		if (*p_line == '\0' || *p_line == '#')
+			continue;
+
+		/* Split off the custom key and binding type - The rest is the name which may contain spaces */
+		char * p_custom_key_name = strtok(p_line, " \t");
+		char * p_type = strtok(NULL, " \t");
+
+		/* Analog settings - <setting> <value> */
+		if (
+			p_type != NULL &&
+			(strcmp(p_custom_key_name, INPUT_BINDINGS_SETTING_AXIS_DEADZONE) == 0 || strcmp(p_custom_key_name, INPUT_BINDINGS_SETTING_AXIS_RESPONSE) == 0)
+		)
+		{
+			if (!parse_setting(&axis_deadzone, &axis_response_exponent, p_custom_key_name, p_type))
+				fprintf(stderr, "\n[Input bindings] Invalid setting in line %d of: %s", line_number, path);
+			continue;
+		}
+
+		char * p_name = strtok(NULL, "");
+		if (p_custom_key_name == NULL || p_type == NULL || p_name == NULL)
+		{
+			fprintf(stderr, "\n[Input bindings] Malformed binding in line %d of: %s", line_number, path);
+			continue;
+		}
+
+		const int custom_key_type = custom_key_type_from_name(p_custom_key_name);
+		struct input_mapper_binding binding;
+		if (custom_key_type < 0 || !parse_binding(p_type, trim(p_name), &binding))
+		{
+			fprintf(stderr, "\n[Input bindings] Unknown binding in line %d of: %s", line_number, path);
+			continue;
+		}
+
+		if (parsed_binding_counts[custom_key_type] >= INPUT_MAPPER_MAX_BINDINGS_PER_KEY)
+		{
+			fprintf(stderr, "\n[Input bindings] More than %d bindings for '%s' in line %d of: %s", INPUT_MAPPER_MAX_BINDINGS_PER_KEY, p_custom_key_name, line_number, path);
+			continue;
+		}
+
+		parsed_bindings[custom_key_type][parsed_binding_counts[custom_key_type]++] = binding;
+	}
+
+	fclose(p_file);
+
+	/* Keys the config binds are replaced - The ones it leaves out keep their defaults so every key stays reachable */
+	for (int custom_key_type = 0; custom_key_type < INPUT_MAPPER_KEY_TYPE_COUNT; custom_key_type++)
+	{
+		if (parsed_binding_counts[custom_key_type] == 0)
+		{
+			fprintf(stderr, "\n[Input bindings] No valid binding for '%s' in: %s - Keeping the default", custom_key_type_names[custom_key_type], path);
+			continue;
+		}
+
+		input_mapper_unbind_all(p_instance, custom_key_type);
+		for (int binding_index = 0; binding_index < parsed_binding_counts[custom_key_type]; binding_index++)
+			input_mapper_bind(p_instance, custom_key_type, parsed_bindings[custom_key_type][binding_index]);
+	}
+
+	p_instance->axis_deadzone = axis_deadzone;
+	p_instance->axis_response_exponent = axis_response_exponent;
+	return PONG_TRUE;
+}
+
+pong_bool_te input_bindings_save(const struct input_mapper_instance * p_instance, const char * p_config_filename)
+{
+	char path[MAX_CONFIG_PATH_LENGTH];
+	if (!config_path(p_config_filename, path))
+		return PONG_FALSE;
+
+	FILE * p_file = fopen(path, "w");
+	if (p_file == NULL)
+	{
+		fprintf(stderr, "\n[Input bindings] Could not open config for writing: %s", path);
+		return PONG_FALSE;
+	}
+
+	/* Header with the line format */
+	pong_bool_te written = fprintf(
+		p_file,
+		"# Pong input bindings - One binding per line, at most %d per custom key\n"
+		"# <custom key> key <SDL scancode name>\n"
+		"# <custom key> button <SDL game controller button>\n"
+		"# <custom key> axis <-|+><SDL game controller axis>\n"
+		"%s %.2f\n"
+		"%s %.2f\n",
+		INPUT_MAPPER_MAX_BINDINGS_PER_KEY,
+		INPUT_BINDINGS_SETTING_AXIS_DEADZONE,
+		p_instance->axis_deadzone,
+		INPUT_BINDINGS_SETTING_AXIS_RESPONSE,
+		p_instance->axis_response_exponent
+	) > 0;
+
+	for (int custom_key_type = 0; custom_key_type < INPUT_MAPPER_KEY_TYPE_COUNT; custom_key_type++)
+	{
+		for (int binding_index = 0; binding_index < INPUT_MAPPER_MAX_BINDINGS_PER_KEY; binding_index++)
+		{
+			if (!write_binding(p_file, custom_key_type_names[custom_key_type], p_instance->bindings[custom_key_type] + binding_index))
+				written = PONG_FALSE;
+		}
+	}
+
+	if (fclose(p_file) != 0 || !written)
+	{
+		fprintf(stderr, "\n[Input bindings] Could not write config: %s", path);
+		return PONG_FALSE;
+	}
+
+	return PONG_TRUE;
+}
@@ -1,6 +1,17 @@
 /* Includes */
 #include <input_mapper.h>
 #include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+/* Every custom key owns one bit of the key masks */
+_Static_assert(INPUT_MAPPER_KEY_TYPE_COUNT <= 64, "Custom key types must fit into the 64-bit key masks");
+
+/* Constants */
+static const Sint16 INPUT_MAPPER_AXIS_DIGITAL_THRESHOLD = 16000;
+static const float INPUT_MAPPER_AXIS_MAX_MAGNITUDE = 32767.0f;
+static const float INPUT_MAPPER_DEFAULT_AXIS_DEADZONE = 0.15f;
+static const float INPUT_MAPPER_DEFAULT_AXIS_RESPONSE_EXPONENT = 1.5f;
 
 /* Private helper functions */
 static pong_bool_te custom_key_type_valid(enum input_mapper_key_type custom_key_type)
@@ -8,96 +19,286 @@ static pong_bool_te custom_key_type_valid(enum input_mapper_key_type custom_key_
 	return custom_key_type >= 0 && custom_key_type < INPUT_MAPPER_KEY_TYPE_COUNT;
 }
 
-static void register_usable_mapping
+static void bind_default(struct input_mapper_instance * p_instance, enum input_mapper_key_type custom_key_type, enum input_mapper_binding_type type, int code)
+{
+	if (!input_mapper_bind(p_instance, custom_key_type, (struct input_mapper_binding){ type, code }))
+		fprintf(stderr, "\n[Input mapper] Could not register default binding for custom key type %d", custom_key_type);
+}
+
+static void record_key_transition
 (
-	struct input_mapper_key_mapping * p_mappings,
+	struct input_mapper_instance * p_instance,
 	enum input_mapper_key_type custom_key_type,
-	int scancode_to_associate
+	Uint32 timestamp,
+	pong_bool_te down
 )
 {
-	if (p_mappings == NULL)
+	struct input_mapper_key_input * const p_input = p_instance->p_inputs + custom_key_type;
+
+	/* Ignore repeats of the current state */
+	if (p_input->down == down)
 		return;
 
-	if (!custom_key_type_valid(custom_key_type))
+	p_input->down = down;
+	p_instance->keys_down ^= (Uint64)1 << custom_key_type;
+
+	/* A full buffer keeps the latest transition so the final state stays correct */
+	if (p_input->transition_count >= INPUT_MAPPER_MAX_KEY_TRANSITIONS)
+		p_input->transition_count = INPUT_MAPPER_MAX_KEY_TRANSITIONS - 1;
+
+	struct input_mapper_key_transition * const p_transition = p_input->transitions + p_input->transition_count++;
+	p_transition->timestamp = timestamp;
+	p_transition->down = down;
+}
+
+static float held_fraction_in_tick
+(
+	const struct input_mapper_key_input * p_input,
+	Uint32 tick_begin_timestamp,
+	Uint32 tick_end_timestamp
+)
+{
+	/* Nothing to integrate over */
+	if (tick_end_timestamp <= tick_begin_timestamp)
+		return p_input->down ? 1.0f : 0.0f;
+
+	/* Sum up the time the key was held between the tick boundaries */
+	Uint32 held_duration = 0;
+	Uint32 segment_begin_timestamp = tick_begin_timestamp;
+	pong_bool_te down = p_input->down_at_tick_begin;
+	for (int transition_index = 0; transition_index < p_input->transition_count; transition_index++)
 	{
-		fprintf(stderr, "\n[Input mapper] Could not register invalid custom key type %d", custom_key_type);
-		return;
+		const struct input_mapper_key_transition * const p_transition = p_input->transitions + transition_index;
+
+		/* Events timestamped outside the tick count towards its boundaries */
+		Uint32 transition_timestamp = p_transition->timestamp;
+		if (transition_timestamp < segment_begin_timestamp)
+			transition_timestamp = segment_begin_timestamp;
+		if (transition_timestamp > tick_end_timestamp)
+			transition_timestamp = tick_end_timestamp;
+
+		if (down)
+			held_duration += transition_timestamp - segment_begin_timestamp;
+
+		down = p_transition->down;
+		segment_begin_timestamp = transition_timestamp;
+	}
+
+	if (down)
+		held_duration += tick_end_timestamp - segment_begin_timestamp;
+
+	return (float)held_duration / (float)(tick_end_timestamp - tick_begin_timestamp);
+}
+
+static pong_bool_te any_binding_down
+(
+	const struct input_mapper_instance * p_instance,
+	enum input_mapper_key_type custom_key_type
+)
+{
+	/* Custom keys stay down while any of their physical inputs is down */
+	for (int binding_index = 0; binding_index < INPUT_MAPPER_MAX_BINDINGS_PER_KEY; binding_index++)
+	{
+		const int physical_input = input_mapper_physical_input(p_instance->bindings[custom_key_type][binding_index]);
+		if (physical_input >= 0 && input_mapper_physical_input_down(p_instance, physical_input))
+			return PONG_TRUE;
+	}
+
+	return PONG_FALSE;
+}
+
+static void update_custom_keys(struct input_mapper_instance * p_instance, Uint64 custom_keys, Uint32 timestamp)
+{
+	while (custom_keys)
+	{
+		const int custom_key_type = __builtin_ctzll(custom_keys);
+		record_key_transition(p_instance, custom_key_type, timestamp, any_binding_down(p_instance, custom_key_type));
+		custom_keys &= custom_keys - 1;
 	}
+}
+
+static float shape_axis_amount(const struct input_mapper_instance * p_instance, Sint16 value, int direction)
+{
+	/* Magnitude along the direction - Rescaled past the deadzone and bent by the response curve */
+	const float magnitude = (float)value * (float)direction / INPUT_MAPPER_AXIS_MAX_MAGNITUDE;
+	if (magnitude <= p_instance->axis_deadzone)
+		return 0.0f;
 
-	/* Custom key type is valid */
-	struct input_mapper_key_mapping * const p_updated_mapping = p_mappings + custom_key_type;
-	p_updated_mapping->custom_key_type = custom_key_type;
-	p_updated_mapping->associated_scancode = scancode_to_associate;
-	p_updated_mapping->usable = PONG_TRUE;
+	const float normalized = (magnitude - p_instance->axis_deadzone) / (1.0f - p_instance->axis_deadzone);
+	return powf((normalized > 1.0f) ? 1.0f : normalized, p_instance->axis_response_exponent);
 }
 
-static pong_bool_te input_mapper_custom_key_in_state
+static void set_axis_direction_amount
 (
 	struct input_mapper_instance * p_instance,
-	enum input_mapper_key_type custom_key_type,
-	enum input_mapper_key_state requested_state
+	int axis_direction,
+	float amount,
+	Uint32 timestamp
 )
 {
-	/* Something wrong with the instance */
-	if (p_instance == NULL || p_instance->p_mappings == NULL || p_instance->p_states == NULL)
-		return PONG_FALSE;
+	struct input_mapper_axis_direction * const p_axis_direction = p_instance->axis_directions + axis_direction;
 
-	/* Ignore invalid custom key types */
-	if (!custom_key_type_valid(custom_key_type))
-		return PONG_FALSE;
+	/* Events timestamped before the tick count towards its beginning */
+	if (timestamp < p_axis_direction->amount_timestamp)
+		timestamp = p_axis_direction->amount_timestamp;
 
-	return (p_instance->p_states[custom_key_type] == requested_state) ? PONG_TRUE : PONG_FALSE;
+	/* Integrate the previous amount up to the change */
+	p_axis_direction->amount_integral += p_axis_direction->amount * (float)(timestamp - p_axis_direction->amount_timestamp);
+	p_axis_direction->amount_timestamp = timestamp;
+	p_axis_direction->amount = amount;
+}
+
+static struct input_mapper_controller * find_controller(struct input_mapper_instance * p_instance, SDL_JoystickID instance_id)
+{
+	for (int controller_index = 0; controller_index < INPUT_MAPPER_MAX_CONTROLLERS; controller_index++)
+	{
+		struct input_mapper_controller * const p_controller = p_instance->controllers + controller_index;
+		if (p_controller->p_controller != NULL && p_controller->instance_id == instance_id)
+			return p_controller;
+	}
+
+	return NULL;
+}
+
+static void sync_controller_button(struct input_mapper_instance * p_instance, int button, Uint32 timestamp)
+{
+	/* Down while held on any controller */
+	pong_bool_te down = PONG_FALSE;
+	for (int controller_index = 0; controller_index < INPUT_MAPPER_MAX_CONTROLLERS; controller_index++)
+	{
+		const struct input_mapper_controller * const p_controller = p_instance->controllers + controller_index;
+		if (p_controller->p_controller != NULL && (p_controller->buttons_down & (1u << button)))
+			down = PONG_TRUE;
+	}
+
+	input_mapper_process_physical_input(p_instance, INPUT_MAPPER_PHYSICAL_INPUT_FIRST_BUTTON + button, down, timestamp);
+}
+
+static void sync_controller_axis(struct input_mapper_instance * p_instance, int axis, Uint32 timestamp)
+{
+	/* The controller deflected the furthest drives the axis */
+	Sint16 value = 0;
+	for (int controller_index = 0; controller_index < INPUT_MAPPER_MAX_CONTROLLERS; controller_index++)
+	{
+		const struct input_mapper_controller * const p_controller = p_instance->controllers + controller_index;
+		if (p_controller->p_controller != NULL && abs(p_controller->axes[axis]) > abs(value))
+			value = p_controller->axes[axis];
+	}
+
+	/* Analog amounts per direction */
+	set_axis_direction_amount(p_instance, 2 * axis, shape_axis_amount(p_instance, value, -1), timestamp);
+	set_axis_direction_amount(p_instance, 2 * axis + 1, shape_axis_amount(p_instance, value, 1), timestamp);
+
+	/* Axis directions act as buttons past the threshold */
+	input_mapper_process_physical_input(p_instance, INPUT_MAPPER_PHYSICAL_INPUT_FIRST_AXIS + 2 * axis, (value < -INPUT_MAPPER_AXIS_DIGITAL_THRESHOLD) ? PONG_TRUE : PONG_FALSE, timestamp);
+	input_mapper_process_physical_input(p_instance, INPUT_MAPPER_PHYSICAL_INPUT_FIRST_AXIS + 2 * axis + 1, (value > INPUT_MAPPER_AXIS_DIGITAL_THRESHOLD) ? PONG_TRUE : PONG_FALSE, timestamp);
+}
+
+static void add_controller(struct input_mapper_instance * p_instance, int device_index)
+{
+	if (!SDL_IsGameController(device_index))
+		return;
+
+	/* Find a free slot */
+	struct input_mapper_controller * p_free_controller = NULL;
+	for (int controller_index = 0; controller_index < INPUT_MAPPER_MAX_CONTROLLERS && p_free_controller == NULL; controller_index++)
+	{
+		if (p_instance->controllers[controller_index].p_controller == NULL)
+			p_free_controller = p_instance->controllers + controller_index;
+	}
+	if (p_free_controller == NULL)
+	{
+		fprintf(stderr, "\n[Input mapper] Ignoring game controller %d - Already using %d controllers", device_index, INPUT_MAPPER_MAX_CONTROLLERS);
+		return;
+	}
+
+	SDL_GameController * const p_controller = SDL_GameControllerOpen(device_index);
+	if (p_controller == NULL)
+	{
+		fprintf(stderr, "\n[Input mapper] Could not open game controller %d - Error: %s", device_index, SDL_GetError());
+		return;
+	}
+
+	/* Already tracked - Drop the extra reference */
+	const SDL_JoystickID instance_id = SDL_JoystickInstanceID(SDL_GameControllerGetJoystick(p_controller));
+	if (find_controller(p_instance, instance_id) != NULL)
+	{
+		SDL_GameControllerClose(p_controller);
+		return;
+	}
+
+	/* Inputs arrive through events from here on */
+	p_free_controller->p_controller = p_controller;
+	p_free_controller->instance_id = instance_id;
+	p_free_controller->buttons_down = 0;
+	for (int axis = 0; axis < SDL_CONTROLLER_AXIS_MAX; axis++)
+		p_free_controller->axes[axis] = 0;
+}
+
+static void remove_controller(struct input_mapper_instance * p_instance, SDL_JoystickID instance_id, Uint32 timestamp)
+{
+	struct input_mapper_controller * const p_controller = find_controller(p_instance, instance_id);
+	if (p_controller == NULL)
+		return;
+
+	SDL_GameControllerClose(p_controller->p_controller);
+	p_controller->p_controller = NULL;
+
+	/* Release whatever only the removed controller held */
+	for (int button = 0; button < SDL_CONTROLLER_BUTTON_MAX; button++)
+		sync_controller_button(p_instance, button, timestamp);
+	for (int axis = 0; axis < SDL_CONTROLLER_AXIS_MAX; axis++)
+		sync_controller_axis(p_instance, axis, timestamp);
 }
 
 /* Function definitions */
 pong_bool_te input_mapper_create(struct input_mapper_instance * p_out_instance)
 {
-	/* Build contextual to SDL2 scancode key relationship */
-	p_out_instance->p_mappings = malloc(sizeof(struct input_mapper_key_mapping) * INPUT_MAPPER_KEY_TYPE_COUNT);
-	if (p_out_instance->p_mappings == NULL)
+	/* All custom keys start released */
+	p_out_instance->keys_down = 0;
+	p_out_instance->keys_current = 0;
+	p_out_instance->keys_previous = 0;
+	p_out_instance->keys_pressed = 0;
+
+	/* Build a list of timestamped custom key inputs fed by key events */
+	p_out_instance->p_inputs = malloc(sizeof(struct input_mapper_key_input) * INPUT_MAPPER_KEY_TYPE_COUNT);
+	if (p_out_instance->p_inputs == NULL)
 	{
-		fprintf(stderr, "\n[Input mapper] Could not allocate input key mappings");
-		return PONG_FALSE;
-	}
-	
-	/* Build a list of all possible mappings and mark them as un-usable */
-	for (int mapping_index = 0; mapping_index < INPUT_MAPPER_KEY_TYPE_COUNT; mapping_index++)
-	{
-		struct input_mapper_key_mapping * const p_initial_mapping = p_out_instance->p_mappings + mapping_index;
-		p_initial_mapping->custom_key_type = mapping_index;
-		p_initial_mapping->associated_scancode = - 1;
-		p_initial_mapping->usable = PONG_FALSE;
-	}
-
-	/* Register the key mappings to update the state for and mark then as usable */
-	register_usable_mapping(p_out_instance->p_mappings, INPUT_MAPPER_KEY_TYPE_LEFT_PADDLE_UP, SDL_SCANCODE_LSHIFT);
-	register_usable_mapping(p_out_instance->p_mappings, INPUT_MAPPER_KEY_TYPE_LEFT_PADDLE_DOWN, SDL_SCANCODE_LCTRL);
-	register_usable_mapping(p_out_instance->p_mappings, INPUT_MAPPER_KEY_TYPE_RIGHT_PADDLE_UP, SDL_SCANCODE_RSHIFT);
-	register_usable_mapping(p_out_instance->p_mappings, INPUT_MAPPER_KEY_TYPE_RIGHT_PADDLE_DOWN, SDL_SCANCODE_RCTRL);
-	register_usable_mapping(p_out_instance->p_mappings, INPUT_MAPPER_KEY_TYPE_QUIT_APPLICATION, SDL_SCANCODE_F4);
-	register_usable_mapping(p_out_instance->p_mappings, INPUT_MAPPER_KEY_TYPE_MENU_SELECT, SDL_SCANCODE_RETURN);
-	register_usable_mapping(p_out_instance->p_mappings, INPUT_MAPPER_KEY_TYPE_MENU_RETURN, SDL_SCANCODE_ESCAPE);
-	register_usable_mapping(p_out_instance->p_mappings, INPUT_MAPPER_KEY_TYPE_MENU_UP, SDL_SCANCODE_UP);
-	register_usable_mapping(p_out_instance->p_mappings, INPUT_MAPPER_KEY_TYPE_MENU_DOWN, SDL_SCANCODE_DOWN);
-	register_usable_mapping(p_out_instance->p_mappings, INPUT_MAPPER_KEY_TYPE_MENU_LEFT, SDL_SCANCODE_LEFT);
-	register_usable_mapping(p_out_instance->p_mappings, INPUT_MAPPER_KEY_TYPE_MENU_RIGHT, SDL_SCANCODE_RIGHT);
-	register_usable_mapping(p_out_instance->p_mappings, INPUT_MAPPER_KEY_TYPE_DEV_1, SDL_SCANCODE_F1);
-	register_usable_mapping(p_out_instance->p_mappings, INPUT_MAPPER_KEY_TYPE_DEV_2, SDL_SCANCODE_F2);
-	register_usable_mapping(p_out_instance->p_mappings, INPUT_MAPPER_KEY_TYPE_DEV_3, SDL_SCANCODE_F3);
-
-	/* Build a list of custom key input states */
-	p_out_instance->p_states = malloc(sizeof(enum input_mapper_key_state) * INPUT_MAPPER_KEY_TYPE_COUNT);
-	if (p_out_instance->p_states == NULL)
-	{
-		input_mapper_destroy(p_out_instance);
+		fprintf(stderr, "\n[Input mapper] Could not allocate custom key inputs");
 		return PONG_FALSE;
 	}
 
 	/* Initialize all custom key states */
 	for (int custom_key_type = 0; custom_key_type < INPUT_MAPPER_KEY_TYPE_COUNT; custom_key_type++)
 	{
-		p_out_instance->p_states[custom_key_type] = INPUT_MAPPER_KEY_STATE_NONE;
+		struct input_mapper_key_input * const p_input = p_out_instance->p_inputs + custom_key_type;
+		p_input->down = PONG_FALSE;
+		p_input->down_at_tick_begin = PONG_FALSE;
+		p_input->transition_count = 0;
+		p_input->held_fraction = 0.0f;
+	}
+	p_out_instance->tick_begin_timestamp = SDL_GetTicks();
+	p_out_instance->latency = (struct input_mapper_latency){ 0, 0, 0 };
+
+	/* No game controllers until SDL reports them */
+	for (int controller_index = 0; controller_index < INPUT_MAPPER_MAX_CONTROLLERS; controller_index++)
+		p_out_instance->controllers[controller_index].p_controller = NULL;
+	for (int axis_direction = 0; axis_direction < INPUT_MAPPER_AXIS_DIRECTION_COUNT; axis_direction++)
+		p_out_instance->axis_directions[axis_direction] = (struct input_mapper_axis_direction){ 0.0f, 0.0f, p_out_instance->tick_begin_timestamp, 0.0f };
+	p_out_instance->axis_deadzone = INPUT_MAPPER_DEFAULT_AXIS_DEADZONE;
+	p_out_instance->axis_response_exponent = INPUT_MAPPER_DEFAULT_AXIS_RESPONSE_EXPONENT;
+
+	/* Start with no physical input down and the built-in bindings */
+	for (int word_index = 0; word_index < (INPUT_MAPPER_PHYSICAL_INPUT_COUNT + 63) / 64; word_index++)
+		p_out_instance->physical_inputs_down[word_index] = 0;
+	for (int physical_input = 0; physical_input < INPUT_MAPPER_PHYSICAL_INPUT_COUNT; physical_input++)
+		p_out_instance->physical_input_bindings[physical_input] = 0;
+	for (int custom_key_type = 0; custom_key_type < INPUT_MAPPER_KEY_TYPE_COUNT; custom_key_type++)
+	{
+		for (int binding_index = 0; binding_index < INPUT_MAPPER_MAX_BINDINGS_PER_KEY; binding_index++)
+			p_out_instance->bindings[custom_key_type][binding_index] = (struct input_mapper_binding){ INPUT_MAPPER_BINDING_TYPE_NONE, 0 };
 	}
+	input_mapper_bind_defaults(p_out_instance);
 
 	/* Success */
 	return PONG_TRUE;
@@ -105,89 +306,345 @@ pong_bool_te input_mapper_create(struct input_mapper_instance * p_out_instance)
 
 void input_mapper_destroy(const struct input_mapper_instance * p_instance)
 {
-	free(p_instance->p_states);
-	free(p_instance->p_mappings);
+	for (int controller_index = 0; controller_index < INPUT_MAPPER_MAX_CONTROLLERS; controller_index++)
+	{
+		if (p_instance->controllers[controller_index].p_controller != NULL)
+			SDL_GameControllerClose(p_instance->controllers[controller_index].p_controller);
+	}
+
+	free(p_instance->p_inputs);
 }
 
-void input_mapper_set_intermediate_state
+void input_mapper_process_event
+(
+	struct input_mapper_instance * p_instance,
+	const SDL_Event * p_event
+)
+{
+	switch (p_event->type)
+	{
+		case SDL_KEYDOWN:
+		case SDL_KEYUP:
+			/* Only physical key changes are transitions */
+			if (p_event->key.repeat)
+				return;
+
+			input_mapper_process_physical_input(
+				p_instance,
+				p_event->key.keysym.scancode,
+				(p_event->type == SDL_KEYDOWN) ? PONG_TRUE : PONG_FALSE,
+				p_event->key.timestamp
+			);
+			break;
+		case SDL_CONTROLLERBUTTONDOWN:
+		case SDL_CONTROLLERBUTTONUP:
+		{
+			struct input_mapper_controller * const p_controller = find_controller(p_instance, p_event->cbutton.which);
+			if (p_controller == NULL || p_event->cbutton.button >= SDL_CONTROLLER_BUTTON_MAX)
+				return;
+
+			if (p_event->type == SDL_CONTROLLERBUTTONDOWN)
+				p_controller->buttons_down |= 1u << p_event->cbutton.button;
+			else
+				p_controller->buttons_down &= ~(1u << p_event->cbutton.button);
+			sync_controller_button(p_instance, p_event->cbutton.button, p_event->cbutton.timestamp);
+			break;
+		}
+		case SDL_CONTROLLERAXISMOTION:
+		{
+			/* Every reported axis sample counts towards the tick average */
+			struct input_mapper_controller * const p_controller = find_controller(p_instance, p_event->caxis.which);
+			if (p_controller == NULL || p_event->caxis.axis >= SDL_CONTROLLER_AXIS_MAX)
+				return;
+
+			p_controller->axes[p_event->caxis.axis] = p_event->caxis.value;
+			sync_controller_axis(p_instance, p_event->caxis.axis, p_event->caxis.timestamp);
+			break;
+		}
+		case SDL_CONTROLLERDEVICEADDED:
+			/* Also reported for the controllers connected at startup */
+			add_controller(p_instance, p_event->cdevice.which);
+			break;
+		case SDL_CONTROLLERDEVICEREMOVED:
+			remove_controller(p_instance, p_event->cdevice.which, p_event->cdevice.timestamp);
+			break;
+	}
+}
+
+int input_mapper_physical_input(struct input_mapper_binding binding)
+{
+	switch (binding.type)
+	{
+		case INPUT_MAPPER_BINDING_TYPE_KEY:
+			return (binding.code > SDL_SCANCODE_UNKNOWN && binding.code < SDL_NUM_SCANCODES) ? binding.code : -1;
+		case INPUT_MAPPER_BINDING_TYPE_CONTROLLER_BUTTON:
+			return (binding.code >= 0 && binding.code < SDL_CONTROLLER_BUTTON_MAX) ? INPUT_MAPPER_PHYSICAL_INPUT_FIRST_BUTTON + binding.code : -1;
+		case INPUT_MAPPER_BINDING_TYPE_CONTROLLER_AXIS_NEGATIVE:
+			return (binding.code >= 0 && binding.code < SDL_CONTROLLER_AXIS_MAX) ? INPUT_MAPPER_PHYSICAL_INPUT_FIRST_AXIS + 2 * binding.code : -1;
+		case INPUT_MAPPER_BINDING_TYPE_CONTROLLER_AXIS_POSITIVE:
+			return (binding.code >= 0 && binding.code < SDL_CONTROLLER_AXIS_MAX) ? INPUT_MAPPER_PHYSICAL_INPUT_FIRST_AXIS + 2 * binding.code + 1 : -1;
+		default:
+			return -1;
+	}
+}
+
+pong_bool_te input_mapper_bind
 (
 	struct input_mapper_instance * p_instance,
-	const uint8_t * p_keyboard_state
+	enum input_mapper_key_type custom_key_type,
+	struct input_mapper_binding binding
 )
 {
-	for (int mapping_index = 0; mapping_index < INPUT_MAPPER_KEY_TYPE_COUNT; mapping_index++)
+	const int physical_input = input_mapper_physical_input(binding);
+	if (!custom_key_type_valid(custom_key_type) || physical_input < 0)
+		return PONG_FALSE;
+
+	/* Already bound */
+	const Uint64 custom_key_bit = (Uint64)1 << custom_key_type;
+	if (p_instance->physical_input_bindings[physical_input] & custom_key_bit)
+		return PONG_TRUE;
+
+	/* Take the first free binding slot */
+	for (int binding_index = 0; binding_index < INPUT_MAPPER_MAX_BINDINGS_PER_KEY; binding_index++)
 	{
-		/* Ignore un-usable custom keys */
-		const struct input_mapper_key_mapping * const p_current_mapping = p_instance->p_mappings + mapping_index;
-		if (!p_current_mapping->usable)
+		struct input_mapper_binding * const p_binding = p_instance->bindings[custom_key_type] + binding_index;
+		if (p_binding->type != INPUT_MAPPER_BINDING_TYPE_NONE)
 			continue;
 
-		/* Udpate the state of the usable custom key */
-		const uint8_t custom_key_pressed = p_keyboard_state[p_current_mapping->associated_scancode];
-		enum input_mapper_key_state * p_current_custom_key_state = p_instance->p_states + p_current_mapping->custom_key_type;
-
-		if (custom_key_pressed)
-    {
-      /* Pressed */
-      if (*p_current_custom_key_state == INPUT_MAPPER_KEY_STATE_NONE)
-      {
-        *p_current_custom_key_state = INPUT_MAPPER_KEY_STATE_PRESSED;
-      }
-      else if (*p_current_custom_key_state == INPUT_MAPPER_KEY_STATE_PRESSED)
-      {
-        *p_current_custom_key_state = INPUT_MAPPER_KEY_STATE_HELD;
-      }
-    }
-    else
-    {
-      /* Released */
-      if (
-      	*p_current_custom_key_state == INPUT_MAPPER_KEY_STATE_PRESSED ||
-      	*p_current_custom_key_state == INPUT_MAPPER_KEY_STATE_HELD
-      )
-      {
-        *p_current_custom_key_state = INPUT_MAPPER_KEY_STATE_RELEASED;
-      }
-      else if (*p_current_custom_key_state == INPUT_MAPPER_KEY_STATE_RELEASED)
-      {
-				*p_current_custom_key_state = INPUT_MAPPER_KEY_STATE_NONE;
-      }
-    }
-	}
-}
-
-pong_bool_te input_mapper_custom_key_state_none
+		/* Rebinding only touches the lookup table - Nothing is left to do per frame */
+		*p_binding = binding;
+		p_instance->physical_input_bindings[physical_input] |= custom_key_bit;
+		update_custom_keys(p_instance, custom_key_bit, SDL_GetTicks());
+		return PONG_TRUE;
+	}
+
+	fprintf(stderr, "\n[Input mapper] Custom key type %d already has %d bindings", custom_key_type, INPUT_MAPPER_MAX_BINDINGS_PER_KEY);
+	return PONG_FALSE;
+}
+
+void input_mapper_unbind_all
 (
 	struct input_mapper_instance * p_instance,
 	enum input_mapper_key_type custom_key_type
 )
 {
-	return input_mapper_custom_key_in_state(p_instance, custom_key_type, INPUT_MAPPER_KEY_STATE_NONE);
+	if (!custom_key_type_valid(custom_key_type))
+		return;
+
+	const Uint64 custom_key_bit = (Uint64)1 << custom_key_type;
+	for (int binding_index = 0; binding_index < INPUT_MAPPER_MAX_BINDINGS_PER_KEY; binding_index++)
+	{
+		struct input_mapper_binding * const p_binding = p_instance->bindings[custom_key_type] + binding_index;
+		const int physical_input = input_mapper_physical_input(*p_binding);
+		if (physical_input >= 0)
+			p_instance->physical_input_bindings[physical_input] &= ~custom_key_bit;
+
+		*p_binding = (struct input_mapper_binding){ INPUT_MAPPER_BINDING_TYPE_NONE, 0 };
+	}
+
+	/* A custom key held through its removed bindings is released */
+	update_custom_keys(p_instance, custom_key_bit, SDL_GetTicks());
+}
+
+void input_mapper_bind_defaults(struct input_mapper_instance * p_instance)
+{
+	for (int custom_key_type = 0; custom_key_type < INPUT_MAPPER_KEY_TYPE_COUNT; custom_key_type++)
+		input_mapper_unbind_all(p_instance, custom_key_type);
+
+	/* Keyboard */
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_LEFT_PADDLE_UP, INPUT_MAPPER_BINDING_TYPE_KEY, SDL_SCANCODE_LSHIFT);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_LEFT_PADDLE_DOWN, INPUT_MAPPER_BINDING_TYPE_KEY, SDL_SCANCODE_LCTRL);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_RIGHT_PADDLE_UP, INPUT_MAPPER_BINDING_TYPE_KEY, SDL_SCANCODE_RSHIFT);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_RIGHT_PADDLE_DOWN, INPUT_MAPPER_BINDING_TYPE_KEY, SDL_SCANCODE_RCTRL);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_QUIT_APPLICATION, INPUT_MAPPER_BINDING_TYPE_KEY, SDL_SCANCODE_F4);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_MENU_SELECT, INPUT_MAPPER_BINDING_TYPE_KEY, SDL_SCANCODE_RETURN);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_MENU_RETURN, INPUT_MAPPER_BINDING_TYPE_KEY, SDL_SCANCODE_ESCAPE);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_MENU_UP, INPUT_MAPPER_BINDING_TYPE_KEY, SDL_SCANCODE_UP);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_MENU_DOWN, INPUT_MAPPER_BINDING_TYPE_KEY, SDL_SCANCODE_DOWN);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_MENU_LEFT, INPUT_MAPPER_BINDING_TYPE_KEY, SDL_SCANCODE_LEFT);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_MENU_RIGHT, INPUT_MAPPER_BINDING_TYPE_KEY, SDL_SCANCODE_RIGHT);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_DEV_1, INPUT_MAPPER_BINDING_TYPE_KEY, SDL_SCANCODE_F1);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_DEV_2, INPUT_MAPPER_BINDING_TYPE_KEY, SDL_SCANCODE_F2);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_DEV_3, INPUT_MAPPER_BINDING_TYPE_KEY, SDL_SCANCODE_F3);
+
+	/* Game controller */
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_LEFT_PADDLE_UP, INPUT_MAPPER_BINDING_TYPE_CONTROLLER_AXIS_NEGATIVE, SDL_CONTROLLER_AXIS_LEFTY);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_LEFT_PADDLE_DOWN, INPUT_MAPPER_BINDING_TYPE_CONTROLLER_AXIS_POSITIVE, SDL_CONTROLLER_AXIS_LEFTY);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_RIGHT_PADDLE_UP, INPUT_MAPPER_BINDING_TYPE_CONTROLLER_AXIS_NEGATIVE, SDL_CONTROLLER_AXIS_RIGHTY);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_RIGHT_PADDLE_DOWN, INPUT_MAPPER_BINDING_TYPE_CONTROLLER_AXIS_POSITIVE, SDL_CONTROLLER_AXIS_RIGHTY);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_MENU_SELECT, INPUT_MAPPER_BINDING_TYPE_CONTROLLER_BUTTON, SDL_CONTROLLER_BUTTON_A);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_MENU_RETURN, INPUT_MAPPER_BINDING_TYPE_CONTROLLER_BUTTON, SDL_CONTROLLER_BUTTON_B);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_MENU_RETURN, INPUT_MAPPER_BINDING_TYPE_CONTROLLER_BUTTON, SDL_CONTROLLER_BUTTON_START);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_MENU_UP, INPUT_MAPPER_BINDING_TYPE_CONTROLLER_BUTTON, SDL_CONTROLLER_BUTTON_DPAD_UP);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_MENU_DOWN, INPUT_MAPPER_BINDING_TYPE_CONTROLLER_BUTTON, SDL_CONTROLLER_BUTTON_DPAD_DOWN);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_MENU_LEFT, INPUT_MAPPER_BINDING_TYPE_CONTROLLER_BUTTON, SDL_CONTROLLER_BUTTON_DPAD_LEFT);
+	bind_default(p_instance, INPUT_MAPPER_KEY_TYPE_MENU_RIGHT, INPUT_MAPPER_BINDING_TYPE_CONTROLLER_BUTTON, SDL_CONTROLLER_BUTTON_DPAD_RIGHT);
+}
+
+Uint64 input_mapper_gather_keyboard_state
+(
+	const struct input_mapper_instance * p_instance,
+	const Uint8 * p_keyboard_state
+)
+{
+	/* One pass over all bindings - Only key bindings read the keyboard state */
+	Uint64 keys_down = 0;
+	for (int custom_key_type = 0; custom_key_type < INPUT_MAPPER_KEY_TYPE_COUNT; custom_key_type++)
+	{
+		for (int binding_index = 0; binding_index < INPUT_MAPPER_MAX_BINDINGS_PER_KEY; binding_index++)
+		{
+			const struct input_mapper_binding * const p_binding = p_instance->bindings[custom_key_type] + binding_index;
+			keys_down |= (Uint64)(p_binding->type == INPUT_MAPPER_BINDING_TYPE_KEY && p_keyboard_state[p_binding->code]) << custom_key_type;
+		}
+	}
+
+	return keys_down;
+}
+
+void input_mapper_sync_keyboard_state
+(
+	struct input_mapper_instance * p_instance,
+	const Uint8 * p_keyboard_state,
+	Uint32 timestamp
+)
+{
+	/* Record a transition for every bound key that changed without an event */
+	for (int custom_key_type = 0; custom_key_type < INPUT_MAPPER_KEY_TYPE_COUNT; custom_key_type++)
+	{
+		for (int binding_index = 0; binding_index < INPUT_MAPPER_MAX_BINDINGS_PER_KEY; binding_index++)
+		{
+			const struct input_mapper_binding * const p_binding = p_instance->bindings[custom_key_type] + binding_index;
+			if (p_binding->type == INPUT_MAPPER_BINDING_TYPE_KEY)
+				input_mapper_process_physical_input(p_instance, p_binding->code, p_keyboard_state[p_binding->code] ? PONG_TRUE : PONG_FALSE, timestamp);
+		}
+	}
 }
 
-pong_bool_te input_mapper_custom_key_state_pressed
+void input_mapper_process_physical_input
 (
 	struct input_mapper_instance * p_instance,
-	enum input_mapper_key_type custom_key_type
+	int physical_input,
+	pong_bool_te down,
+	Uint32 timestamp
 )
 {
-return input_mapper_custom_key_in_state(p_instance, custom_key_type, INPUT_MAPPER_KEY_STATE_PRESSED);
+	if (physical_input < 0 || physical_input >= INPUT_MAPPER_PHYSICAL_INPUT_COUNT)
+		return;
+	if (input_mapper_physical_input_down(p_instance, physical_input) == down)
+		return;
+
+	/* Flip the physical input and update every custom key bound to it */
+	p_instance->physical_inputs_down[physical_input >> 6] ^= (Uint64)1 << (physical_input & 63);
+	update_custom_keys(p_instance, p_instance->physical_input_bindings[physical_input], timestamp);
 }
 
-pong_bool_te input_mapper_custom_key_state_held
+void input_mapper_set_intermediate_state
 (
 	struct input_mapper_instance * p_instance,
-	enum input_mapper_key_type custom_key_type
+	Uint32 tick_end_timestamp
 )
 {
-return input_mapper_custom_key_in_state(p_instance, custom_key_type, INPUT_MAPPER_KEY_STATE_HELD);
+	Uint64 pressed_in_tick = 0;
+	for (int custom_key_type = 0; custom_key_type < INPUT_MAPPER_KEY_TYPE_COUNT; custom_key_type++)
+	{
+		struct input_mapper_key_input * const p_input = p_instance->p_inputs + custom_key_type;
+
+		/* Fraction of the tick the key was held for, including taps shorter than a tick */
+		p_input->held_fraction = held_fraction_in_tick(p_input, p_instance->tick_begin_timestamp, tick_end_timestamp);
+
+		for (int transition_index = 0; transition_index < p_input->transition_count; transition_index++)
+		{
+			/* Any press within the tick is reported - Even when released before the tick ended */
+			const struct input_mapper_key_transition * const p_transition = p_input->transitions + transition_index;
+			pressed_in_tick |= (Uint64)(p_transition->down != PONG_FALSE) << custom_key_type;
+
+			/* Instrument the time from the key event to the simulation seeing it */
+			const Uint32 latency = (tick_end_timestamp > p_transition->timestamp) ? tick_end_timestamp - p_transition->timestamp : 0;
+			p_instance->latency.sum += latency;
+			p_instance->latency.samples++;
+			if (latency > p_instance->latency.max)
+				p_instance->latency.max = latency;
+		}
+
+		/* The next tick starts with the current key state */
+		p_input->down_at_tick_begin = p_input->down;
+		p_input->transition_count = 0;
+	}
+
+	/* Average the analog axis amounts over the tick */
+	const Uint32 tick_duration = tick_end_timestamp - p_instance->tick_begin_timestamp;
+	for (int axis_direction = 0; axis_direction < INPUT_MAPPER_AXIS_DIRECTION_COUNT; axis_direction++)
+	{
+		struct input_mapper_axis_direction * const p_axis_direction = p_instance->axis_directions + axis_direction;
+		set_axis_direction_amount(p_instance, axis_direction, p_axis_direction->amount, tick_end_timestamp);
+
+		const float tick_amount = (tick_duration > 0) ? p_axis_direction->amount_integral / (float)tick_duration : p_axis_direction->amount;
+		p_axis_direction->tick_amount = (tick_amount > 1.0f) ? 1.0f : tick_amount;
+		p_axis_direction->amount_integral = 0.0f;
+		p_axis_direction->amount_timestamp = tick_end_timestamp;
+	}
+
+	/* Keys active this tick are down or were tapped - New activity and re-presses are pressed, the rest is held */
+	p_instance->keys_previous = p_instance->keys_current;
+	p_instance->keys_current = p_instance->keys_down | pressed_in_tick;
+	p_instance->keys_pressed = pressed_in_tick | (p_instance->keys_current & ~p_instance->keys_previous);
+	p_instance->tick_begin_timestamp = tick_end_timestamp;
 }
 
-pong_bool_te input_mapper_custom_key_state_released
+float input_mapper_custom_key_held_fraction
 (
 	struct input_mapper_instance * p_instance,
 	enum input_mapper_key_type custom_key_type
 )
 {
-return input_mapper_custom_key_in_state(p_instance, custom_key_type, INPUT_MAPPER_KEY_STATE_RELEASED);
+	if (p_instance == NULL || p_instance->p_inputs == NULL || !custom_key_type_valid(custom_key_type))
+		return 0.0f;
+
+	return p_instance->p_inputs[custom_key_type].held_fraction;
+}
+
+float input_mapper_custom_key_amount
+(
+	const struct input_mapper_instance * p_instance,
+	enum input_mapper_key_type custom_key_type
+)
+{
+	if (p_instance == NULL || p_instance->p_inputs == NULL || !custom_key_type_valid(custom_key_type))
+		return 0.0f;
+
+	/* Gather the analog amount and whether a digital binding is down */
+	float analog_amount = 0.0f;
+	pong_bool_te digital_down = PONG_FALSE;
+	for (int binding_index = 0; binding_index < INPUT_MAPPER_MAX_BINDINGS_PER_KEY; binding_index++)
+	{
+		const struct input_mapper_binding binding = p_instance->bindings[custom_key_type][binding_index];
+		const int physical_input = input_mapper_physical_input(binding);
+		if (physical_input < 0)
+			continue;
+
+		if (physical_input >= INPUT_MAPPER_PHYSICAL_INPUT_FIRST_AXIS)
+		{
+			const float tick_amount = p_instance->axis_directions[physical_input - INPUT_MAPPER_PHYSICAL_INPUT_FIRST_AXIS].tick_amount;
+			if (tick_amount > analog_amount)
+				analog_amount = tick_amount;
+		}
+		else if (input_mapper_physical_input_down(p_instance, physical_input))
+		{
+			digital_down = PONG_TRUE;
+		}
+	}
+
+	/* Keys and buttons drive the custom key fully for as long as they were held */
+	if (digital_down || analog_amount <= 0.0f)
+		return p_instance->p_inputs[custom_key_type].held_fraction;
+
+	return analog_amount;
+}
+
+struct input_mapper_latency input_mapper_take_latency(struct input_mapper_instance * p_instance)
+{
+	/* Hand out the accumulated latency and start over */
+	const struct input_mapper_latency latency = p_instance->latency;
+	p_instance->latency = (struct input_mapper_latency){ 0, 0, 0 };
+	return latency;
 }
\ No newline at end of file
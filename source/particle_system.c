@@ -0,0 +1,136 @@
+/* Includes */
+#include <particle_system.h>
+#include <math.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* Constants */
+static const float PARTICLE_SYSTEM_GRAVITY = -400.0f;
+static const float PARTICLE_SYSTEM_DRAG = 1.5f;
+
+/* Private helper functions */
+static float random_unit(struct particle_system * p_system)
+{
+  /* Xorshift - Cheap enough to call per emitted particle and independent of rand() */
+  Uint32 state = p_system->random_state;
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  p_system->random_state = state;
+  return (float)(state >> 8) * (1.0f / 16777216.0f);
+}
+
+static float random_range(struct particle_system * p_system, float min, float max)
+{
+  return min + (max - min) * random_unit(p_system);
+}
+
+static void integrate(struct particle_system * p_system, float dt, int first_index, int end_index)
+{
+  /* Scalar tail and fallback - Same arithmetic as the vector path */
+  const float damping = fmaxf(0.0f, 1.0f - PARTICLE_SYSTEM_DRAG * dt);
+  for (int particle_index = first_index; particle_index < end_index; particle_index++)
+  {
+    p_system->velocities_x[particle_index] *= damping;
+    p_system->velocities_y[particle_index] = (p_system->velocities_y[particle_index] + PARTICLE_SYSTEM_GRAVITY * dt) * damping;
+    p_system->positions_x[particle_index] += p_system->velocities_x[particle_index] * dt;
+    p_system->positions_y[particle_index] += p_system->velocities_y[particle_index] * dt;
+    p_system->lifetimes[particle_index] -= dt;
+    p_system->sizes[particle_index] -= p_system->shrink_rates[particle_index] * dt;
+  }
+}
+
+/* Function definitions */
+void particle_system_reset(struct particle_system * p_system, Uint32 random_seed)
+{
+  p_system->count = 0;
+  p_system->random_state = random_seed ? random_seed : 0x9e3779b9u;
+}
+
+int particle_system_emit
+(
+  struct particle_system * p_system,
+  const struct particle_system_emitter * p_emitter,
+  float origin_x,
+  float origin_y,
+  float direction_x,
+  float direction_y,
+  int particle_count
+)
+{
+  /* Bursts beyond the capacity are cut short */
+  if (particle_count > PARTICLE_SYSTEM_CAPACITY - p_system->count)
+    particle_count = PARTICLE_SYSTEM_CAPACITY - p_system->count;
+
+  /* Fan out around the direction - Particles shrink to nothing over their lifetime */
+  const float direction_angle = atan2f(direction_y, direction_x);
+  for (int emitted = 0; emitted < particle_count; emitted++)
+  {
+    const int particle_index = p_system->count++;
+    const float angle = direction_angle + (random_unit(p_system) - 0.5f) * p_emitter->spread_radians;
+    const float speed = random_range(p_system, p_emitter->speed_min, p_emitter->speed_max);
+    const float lifetime = random_range(p_system, p_emitter->lifetime_min, p_emitter->lifetime_max);
+
+    p_system->positions_x[particle_index] = origin_x;
+    p_system->positions_y[particle_index] = origin_y;
+    p_system->velocities_x[particle_index] = cosf(angle) * speed;
+    p_system->velocities_y[particle_index] = sinf(angle) * speed;
+    p_system->lifetimes[particle_index] = lifetime;
+    p_system->sizes[particle_index] = p_emitter->size;
+    p_system->shrink_rates[particle_index] = p_emitter->size / lifetime;
+    p_system->colors[particle_index] = p_emitter->color;
+  }
+
+  return particle_count;
+}
+
+void particle_system_update(struct particle_system * p_system, float dt)
+{
+  int integrated = 0;
+
+#if defined(__SSE2__)
+  /* Four particles per step over the aligned arrays */
+  const __m128 dt4 = _mm_set1_ps(dt);
+  const __m128 damping4 = _mm_set1_ps(fmaxf(0.0f, 1.0f - PARTICLE_SYSTEM_DRAG * dt));
+  const __m128 gravity_dt4 = _mm_set1_ps(PARTICLE_SYSTEM_GRAVITY * dt);
+  const int vector_end = p_system->count & ~3;
+  for (; integrated < vector_end; integrated += 4)
+  {
+    const __m128 velocity_x = _mm_mul_ps(_mm_load_ps(p_system->velocities_x + integrated), damping4);
+    const __m128 velocity_y = _mm_mul_ps(_mm_add_ps(_mm_load_ps(p_system->velocities_y + integrated), gravity_dt4), damping4);
+    _mm_store_ps(p_system->velocities_x + integrated, velocity_x);
+    _mm_store_ps(p_system->velocities_y + integrated, velocity_y);
+    _mm_store_ps(p_system->positions_x + integrated, _mm_add_ps(_mm_load_ps(p_system->positions_x + integrated), _mm_mul_ps(velocity_x, dt4)));
+    _mm_store_ps(p_system->positions_y + integrated, _mm_add_ps(_mm_load_ps(p_system->positions_y + integrated), _mm_mul_ps(velocity_y, dt4)));
+    _mm_store_ps(p_system->lifetimes + integrated, _mm_sub_ps(_mm_load_ps(p_system->lifetimes + integrated), dt4));
+    _mm_store_ps(
+      p_system->sizes + integrated,
+      _mm_sub_ps(_mm_load_ps(p_system->sizes + integrated), _mm_mul_ps(_mm_load_ps(p_system->shrink_rates + integrated), dt4))
+    );
+  }
+#endif
+
+  integrate(p_system, dt, integrated, p_system->count);
+
+  /* Keep the live particles packed - Expired ones are replaced by the last live one */
+  int particle_index = 0;
+  while (particle_index < p_system->count)
+  {
+    if (p_system->lifetimes[particle_index] > 0.0f)
+    {
+      particle_index++;
+      continue;
+    }
+
+    const int last_index = --p_system->count;
+    p_system->positions_x[particle_index] = p_system->positions_x[last_index];
+    p_system->positions_y[particle_index] = p_system->positions_y[last_index];
+    p_system->velocities_x[particle_index] = p_system->velocities_x[last_index];
+    p_system->velocities_y[particle_index] = p_system->velocities_y[last_index];
+    p_system->lifetimes[particle_index] = p_system->lifetimes[last_index];
+    p_system->sizes[particle_index] = p_system->sizes[last_index];
+    p_system->shrink_rates[particle_index] = p_system->shrink_rates[last_index];
+    p_system->colors[particle_index] = p_system->colors[last_index];
+  }
+}
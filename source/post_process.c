@@ -0,0 +1,341 @@
+/* Includes */
+#define GL_GLEXT_PROTOTYPES
+#include <post_process.h>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_opengl.h>
+#include <stdio.h>
+
+/* Constants */
+static const float POST_PROCESS_SCANLINE_STRENGTH = 0.25f;
+
+/* Private state */
+static pong_bool_te post_process_enabled = PONG_FALSE;
+static pong_bool_te post_process_core_profile = PONG_FALSE;
+static GLuint core_vertex_array_handle = 0x00;
+static GLuint framebuffer_handle = 0x00;
+static GLuint frame_texture_handle = 0x00;
+static GLuint present_program = 0x00;
+static GLint uniform_source_size = -1;
+static GLint uniform_output_size = -1;
+static int frame_width = 0;
+static int frame_height = 0;
+static enum post_process_filter frame_filter = POST_PROCESS_FILTER_NEAREST;
+static pong_bool_te frame_scanlines = PONG_FALSE;
+
+/* Private helper functions */
+static GLuint compile_shader(GLenum shader_type, GLsizei source_count, const char * const * p_sources)
+{
+  const GLuint shader = glCreateShader(shader_type);
+  glShaderSource(shader, source_count, (const GLchar **)p_sources, NULL);
+  glCompileShader(shader);
+
+  GLint compiled = GL_FALSE;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+  if (!compiled)
+  {
+    char info_log[512];
+    glGetShaderInfoLog(shader, sizeof(info_log), NULL, info_log);
+    fprintf(stderr, "\n[Post process] Could not compile shader - Error: %s", info_log);
+    glDeleteShader(shader);
+    return 0x00;
+  }
+
+  return shader;
+}
+
+static GLuint create_present_program(void)
+{
+  static const char * p_legacy_vertex_source =
+    "#version 120\n"
+    "void main()\n"
+    "{\n"
+    "  gl_Position = gl_Vertex;\n"
+    "  gl_TexCoord[0] = gl_MultiTexCoord0;\n"
+    "}\n";
+
+  /* Core profile - One triangle covering the viewport, generated from the vertex index alone */
+  static const char * p_core_vertex_source =
+    "#version 330 core\n"
+    "out vec2 frame_texcoords;\n"
+    "void main()\n"
+    "{\n"
+    "  frame_texcoords = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);\n"
+    "  gl_Position = vec4(frame_texcoords * 2.0 - 1.0, 0.0, 1.0);\n"
+    "}\n";
+
+  /* Profile specific inputs and outputs in front of the shared fragment body */
+  static const char * p_legacy_fragment_header =
+    "#version 120\n"
+    "#define FRAME_TEXCOORDS gl_TexCoord[0].st\n"
+    "#define FRAME_SAMPLE texture2D\n"
+    "#define FRAGMENT_COLOR gl_FragColor\n";
+
+  static const char * p_core_fragment_header =
+    "#version 330 core\n"
+    "#define FRAME_TEXCOORDS frame_texcoords\n"
+    "#define FRAME_SAMPLE texture\n"
+    "#define FRAGMENT_COLOR fragment_color\n"
+    "in vec2 frame_texcoords;\n"
+    "out vec4 fragment_color;\n";
+
+  /*
+    Sharp bilinear - Texels are blown up by the whole part of the scale with nearest
+    sampling, only the remaining fraction at their borders is blended bilinearly.
+    Scanlines darken the border between internal rows.
+  */
+  static const char * p_fragment_body =
+    "uniform sampler2D frame;\n"
+    "uniform vec2 source_size;\n"
+    "uniform vec2 output_size;\n"
+    "uniform float sharp_bilinear;\n"
+    "uniform float scanline_strength;\n"
+    "void main()\n"
+    "{\n"
+    "  vec2 texel = FRAME_TEXCOORDS * source_size;\n"
+    "  vec2 prescale = max(floor(output_size / source_size), vec2(1.0));\n"
+    "  vec2 region_range = 0.5 - 0.5 / prescale;\n"
+    "  vec2 center_distance = fract(texel) - 0.5;\n"
+    "  vec2 blend = (center_distance - clamp(center_distance, -region_range, region_range)) * prescale + 0.5;\n"
+    "  vec2 sharp_texel = floor(texel) + blend;\n"
+    "  vec2 sample_texel = mix(texel, sharp_texel, sharp_bilinear);\n"
+    "  vec4 color = FRAME_SAMPLE(frame, sample_texel / source_size);\n"
+    "  float scanline = 1.0 - scanline_strength * (0.5 + 0.5 * cos(texel.y * 6.2831853));\n"
+    "  FRAGMENT_COLOR = vec4(color.rgb * scanline, 1.0);\n"
+    "}\n";
+
+  const char * p_vertex_sources[1] = {
+    post_process_core_profile ? p_core_vertex_source : p_legacy_vertex_source
+  };
+  const char * p_fragment_sources[2] = {
+    post_process_core_profile ? p_core_fragment_header : p_legacy_fragment_header,
+    p_fragment_body
+  };
+  const GLuint vertex_shader = compile_shader(GL_VERTEX_SHADER, 1, p_vertex_sources);
+  const GLuint fragment_shader = compile_shader(GL_FRAGMENT_SHADER, 2, p_fragment_sources);
+  GLuint program = 0x00;
+  if (vertex_shader && fragment_shader)
+  {
+    program = glCreateProgram();
+    glAttachShader(program, vertex_shader);
+    glAttachShader(program, fragment_shader);
+    glLinkProgram(program);
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked)
+    {
+      char info_log[512];
+      glGetProgramInfoLog(program, sizeof(info_log), NULL, info_log);
+      fprintf(stderr, "\n[Post process] Could not link the present program - Error: %s", info_log);
+      glDeleteProgram(program);
+      program = 0x00;
+    }
+  }
+
+  if (vertex_shader)
+    glDeleteShader(vertex_shader);
+  if (fragment_shader)
+    glDeleteShader(fragment_shader);
+
+  return program;
+}
+
+/* Function definitions */
+pong_bool_te post_process_initialize
+(
+  int internal_width,
+  int internal_height,
+  enum post_process_filter filter,
+  pong_bool_te scanlines,
+  pong_bool_te core_profile
+)
+{
+  post_process_cleanup();
+  post_process_core_profile = core_profile;
+
+  /* Without framebuffer objects the game renders straight to the window - Always there in the core profile */
+  if (!post_process_core_profile && !SDL_GL_ExtensionSupported("GL_ARB_framebuffer_object"))
+  {
+    fprintf(stderr, "\n[Post process] Framebuffer objects unsupported - Rendering at the window resolution");
+    return PONG_FALSE;
+  }
+
+  /* Internal resolution color target - Sampled linearly only for sharp bilinear */
+  glGenTextures(1, &frame_texture_handle);
+  glBindTexture(GL_TEXTURE_2D, frame_texture_handle);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, internal_width, internal_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+  const GLint texture_filter = (filter == POST_PROCESS_FILTER_SHARP_BILINEAR) ? GL_LINEAR : GL_NEAREST;
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, texture_filter);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, texture_filter);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+  glGenFramebuffers(1, &framebuffer_handle);
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_handle);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, frame_texture_handle, 0);
+  const GLenum framebuffer_status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  if (framebuffer_status != GL_FRAMEBUFFER_COMPLETE)
+  {
+    fprintf(stderr, "\n[Post process] Incomplete framebuffer of %dx%d - Status: 0x%x", internal_width, internal_height, framebuffer_status);
+    post_process_cleanup();
+    return PONG_FALSE;
+  }
+
+  /* Without the program the frame is still upscaled with the texture filter alone - Except in the core profile */
+  present_program = create_present_program();
+  if (post_process_core_profile)
+  {
+    if (!present_program)
+    {
+      post_process_cleanup();
+      return PONG_FALSE;
+    }
+
+    /* Attributeless draw - The core profile still wants a vertex array bound */
+    glGenVertexArrays(1, &core_vertex_array_handle);
+  }
+  if (present_program)
+  {
+    glUseProgram(present_program);
+    glUniform1i(glGetUniformLocation(present_program, "frame"), 0);
+    glUniform1f(glGetUniformLocation(present_program, "sharp_bilinear"), (filter == POST_PROCESS_FILTER_SHARP_BILINEAR) ? 1.0f : 0.0f);
+    glUniform1f(glGetUniformLocation(present_program, "scanline_strength"), scanlines ? POST_PROCESS_SCANLINE_STRENGTH : 0.0f);
+    uniform_source_size = glGetUniformLocation(present_program, "source_size");
+    uniform_output_size = glGetUniformLocation(present_program, "output_size");
+    glUseProgram(0);
+  }
+
+  frame_width = internal_width;
+  frame_height = internal_height;
+  frame_filter = filter;
+  frame_scanlines = scanlines;
+  post_process_enabled = PONG_TRUE;
+  printf(
+    "\n[Post process] Rendering at %dx%d - %s upscale%s",
+    frame_width,
+    frame_height,
+    (frame_filter == POST_PROCESS_FILTER_SHARP_BILINEAR) ? "Sharp bilinear" : "Nearest",
+    (frame_scanlines && present_program) ? " with scanlines" : ""
+  );
+  return PONG_TRUE;
+}
+
+void post_process_set_scanlines(pong_bool_te scanlines)
+{
+  /* Only the present uniform changes - The frame keeps its size and contents */
+  frame_scanlines = scanlines;
+  if (!post_process_enabled || !present_program)
+    return;
+
+  glUseProgram(present_program);
+  glUniform1f(glGetUniformLocation(present_program, "scanline_strength"), scanlines ? POST_PROCESS_SCANLINE_STRENGTH : 0.0f);
+  glUseProgram(0);
+}
+
+pong_bool_te post_process_active(void)
+{
+  return post_process_enabled;
+}
+
+void post_process_frame_size(int * p_out_width, int * p_out_height)
+{
+  *p_out_width = frame_width;
+  *p_out_height = frame_height;
+}
+
+void post_process_begin(void)
+{
+  if (!post_process_enabled)
+    return;
+
+  /* Everything until the present lands in the internal resolution frame */
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_handle);
+  glViewport(0, 0, frame_width, frame_height);
+}
+
+void post_process_present
+(
+  int window_width,
+  int window_height,
+  int viewport_x,
+  int viewport_y,
+  int viewport_width,
+  int viewport_height
+)
+{
+  if (!post_process_enabled)
+    return;
+
+  /* Clear the whole window for the bars around the letterboxed frame */
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  glViewport(0, 0, window_width, window_height);
+  glClear(GL_COLOR_BUFFER_BIT);
+  glViewport(viewport_x, viewport_y, viewport_width, viewport_height);
+
+  glDisable(GL_BLEND);
+  glBindTexture(GL_TEXTURE_2D, frame_texture_handle);
+  if (present_program)
+  {
+    glUseProgram(present_program);
+    glUniform2f(uniform_source_size, (float)frame_width, (float)frame_height);
+    glUniform2f(uniform_output_size, (float)viewport_width, (float)viewport_height);
+  }
+
+  if (post_process_core_profile)
+  {
+    glBindVertexArray(core_vertex_array_handle);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glUseProgram(0);
+    return;
+  }
+
+  /* One quad in normalized device coordinates - The canvas projection stays untouched */
+  glEnable(GL_TEXTURE_2D);
+
+  glMatrixMode(GL_PROJECTION);
+  glPushMatrix();
+  glLoadIdentity();
+  glMatrixMode(GL_MODELVIEW);
+  glPushMatrix();
+  glLoadIdentity();
+
+  glColor4ub(255, 255, 255, 255);
+  glBegin(GL_TRIANGLE_STRIP);
+  glTexCoord2f(0.0f, 0.0f);
+  glVertex2f(-1.0f, -1.0f);
+  glTexCoord2f(1.0f, 0.0f);
+  glVertex2f(1.0f, -1.0f);
+  glTexCoord2f(0.0f, 1.0f);
+  glVertex2f(-1.0f, 1.0f);
+  glTexCoord2f(1.0f, 1.0f);
+  glVertex2f(1.0f, 1.0f);
+  glEnd();
+
+  glPopMatrix();
+  glMatrixMode(GL_PROJECTION);
+  glPopMatrix();
+  glMatrixMode(GL_MODELVIEW);
+
+  glUseProgram(0);
+  glDisable(GL_TEXTURE_2D);
+}
+
+void post_process_cleanup(void)
+{
+  if (present_program)
+    glDeleteProgram(present_program);
+  if (framebuffer_handle)
+    glDeleteFramebuffers(1, &framebuffer_handle);
+  if (frame_texture_handle)
+    glDeleteTextures(1, &frame_texture_handle);
+  if (core_vertex_array_handle)
+    glDeleteVertexArrays(1, &core_vertex_array_handle);
+
+  present_program = 0x00;
+  framebuffer_handle = 0x00;
+  frame_texture_handle = 0x00;
+  core_vertex_array_handle = 0x00;
+  post_process_enabled = PONG_FALSE;
+}
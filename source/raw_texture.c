@@ -0,0 +1,181 @@
+/* Includes */
+#include <raw_texture.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Private helper functions */
+static int bytes_per_pixel(Uint32 format)
+{
+  return (format == RAW_TEXTURE_FORMAT_ALPHA8) ? 1 : 4;
+}
+
+static pong_bool_te raw_texture_valid(const struct raw_texture * p_texture)
+{
+  /* Header must fit */
+  if (p_texture->mapping_size < sizeof(struct raw_texture_header))
+    return PONG_FALSE;
+
+  const struct raw_texture_header * const p_header = p_texture->p_header;
+  if (
+    p_header->magic != RAW_TEXTURE_MAGIC ||
+    p_header->version != RAW_TEXTURE_VERSION ||
+    (p_header->format != RAW_TEXTURE_FORMAT_ALPHA8 && p_header->format != RAW_TEXTURE_FORMAT_RGBA8) ||
+    p_header->width == 0 ||
+    p_header->height == 0
+  )
+    return PONG_FALSE;
+
+  /* Pixels must lie within the mapping */
+  const size_t pixels_size = (size_t)p_header->width * p_header->height * (size_t)bytes_per_pixel(p_header->format);
+  return (sizeof(struct raw_texture_header) + pixels_size <= p_texture->mapping_size) ? PONG_TRUE : PONG_FALSE;
+}
+
+/* Function definitions */
+pong_bool_te raw_texture_open(const char * p_path, struct raw_texture * p_out_texture)
+{
+  p_out_texture->p_mapping = NULL;
+  p_out_texture->mapping_size = 0;
+
+  const int file_descriptor = open(p_path, O_RDONLY);
+  if (file_descriptor < 0)
+    return PONG_FALSE;
+
+  struct stat file_stat;
+  if (fstat(file_descriptor, &file_stat) != 0 || file_stat.st_size <= 0)
+  {
+    close(file_descriptor);
+    return PONG_FALSE;
+  }
+
+  /* Pixels are read straight from the mapping by the upload */
+  void * const p_mapping = mmap(NULL, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+  close(file_descriptor);
+  if (p_mapping == MAP_FAILED)
+  {
+    fprintf(stderr, "\n[Raw texture] Could not map texture: %s", p_path);
+    return PONG_FALSE;
+  }
+
+  p_out_texture->p_mapping = p_mapping;
+  p_out_texture->mapping_size = (size_t)file_stat.st_size;
+  p_out_texture->owns_mapping = PONG_TRUE;
+  p_out_texture->p_header = p_mapping;
+  p_out_texture->p_pixels = (const Uint8 *)(p_out_texture->p_header + 1);
+
+  if (!raw_texture_valid(p_out_texture))
+  {
+    fprintf(stderr, "\n[Raw texture] Invalid texture: %s", p_path);
+    raw_texture_close(p_out_texture);
+    return PONG_FALSE;
+  }
+
+  return PONG_TRUE;
+}
+
+pong_bool_te raw_texture_open_memory(const Uint8 * p_data, size_t length, struct raw_texture * p_out_texture)
+{
+  /* Pixels point straight into the memory - It has to outlive the texture */
+  p_out_texture->p_mapping = (Uint8 *)p_data;
+  p_out_texture->mapping_size = length;
+  p_out_texture->owns_mapping = PONG_FALSE;
+  p_out_texture->p_header = (const struct raw_texture_header *)p_data;
+  p_out_texture->p_pixels = (const Uint8 *)(p_out_texture->p_header + 1);
+
+  if (p_data == NULL || !raw_texture_valid(p_out_texture))
+  {
+    fprintf(stderr, "\n[Raw texture] Invalid texture in memory");
+    raw_texture_close(p_out_texture);
+    return PONG_FALSE;
+  }
+
+  return PONG_TRUE;
+}
+
+const Uint8 * raw_texture_pixels(const struct raw_texture * p_texture)
+{
+  if (p_texture->p_mapping == NULL)
+    return NULL;
+
+  return p_texture->p_pixels;
+}
+
+size_t raw_texture_size(const struct raw_texture * p_texture)
+{
+  if (p_texture->p_mapping == NULL)
+    return 0;
+
+  const struct raw_texture_header * const p_header = p_texture->p_header;
+  return (size_t)p_header->width * p_header->height * (size_t)bytes_per_pixel(p_header->format);
+}
+
+void raw_texture_close(struct raw_texture * p_texture)
+{
+  if (p_texture->p_mapping != NULL && p_texture->owns_mapping)
+    munmap(p_texture->p_mapping, p_texture->mapping_size);
+
+  p_texture->p_mapping = NULL;
+  p_texture->mapping_size = 0;
+  p_texture->owns_mapping = PONG_FALSE;
+}
+
+pong_bool_te raw_texture_build(SDL_Surface * p_surface, Uint8 ** p_out_data, size_t * p_out_length)
+{
+  /* Byte order R, G, B, A on every platform */
+  SDL_Surface * const p_rgba_surface = SDL_ConvertSurfaceFormat(p_surface, SDL_PIXELFORMAT_RGBA32, 0);
+  if (p_rgba_surface == NULL)
+  {
+    fprintf(stderr, "\n[Raw texture] Could not convert surface - Error: %s", SDL_GetError());
+    return PONG_FALSE;
+  }
+
+  /* Alpha-only when every visible pixel is white - Modulated by the vertex color either way */
+  const Uint32 width = (Uint32)p_rgba_surface->w;
+  const Uint32 height = (Uint32)p_rgba_surface->h;
+  pong_bool_te alpha_only = PONG_TRUE;
+  for (Uint32 y = 0; y < height && alpha_only; y++)
+  {
+    const Uint8 * const p_row = (const Uint8 *)p_rgba_surface->pixels + y * (Uint32)p_rgba_surface->pitch;
+    for (Uint32 x = 0; x < width && alpha_only; x++)
+    {
+      const Uint8 * const p_pixel = p_row + x * 4;
+      if (p_pixel[3] != 0 && (p_pixel[0] != 255 || p_pixel[1] != 255 || p_pixel[2] != 255))
+        alpha_only = PONG_FALSE;
+    }
+  }
+  const Uint32 format = alpha_only ? RAW_TEXTURE_FORMAT_ALPHA8 : RAW_TEXTURE_FORMAT_RGBA8;
+  const int channels = bytes_per_pixel(format);
+
+  const struct raw_texture_header header = { RAW_TEXTURE_MAGIC, RAW_TEXTURE_VERSION, width, height, format };
+  const size_t length = sizeof(struct raw_texture_header) + (size_t)width * height * (size_t)channels;
+  Uint8 * const p_data = malloc(length);
+  if (p_data == NULL)
+  {
+    SDL_FreeSurface(p_rgba_surface);
+    return PONG_FALSE;
+  }
+  memcpy(p_data, &header, sizeof(header));
+
+  /* Pixel rows without padding */
+  Uint8 * const p_pixels = p_data + sizeof(header);
+  for (Uint32 y = 0; y < height; y++)
+  {
+    const Uint8 * const p_row = (const Uint8 *)p_rgba_surface->pixels + y * (Uint32)p_rgba_surface->pitch;
+    for (Uint32 x = 0; x < width; x++)
+    {
+      if (alpha_only)
+        p_pixels[y * width + x] = p_row[x * 4 + 3];
+      else
+        memcpy(p_pixels + (y * width + x) * 4, p_row + x * 4, 4);
+    }
+  }
+  SDL_FreeSurface(p_rgba_surface);
+
+  *p_out_data = p_data;
+  *p_out_length = length;
+  return PONG_TRUE;
+}
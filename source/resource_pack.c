@@ -0,0 +1,129 @@
+/* Includes */
+#include <resource_pack.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Private helper functions */
+static pong_bool_te resource_pack_valid(const struct resource_pack * p_pack)
+{
+	/* Header and table of contents must fit */
+	if (p_pack->mapping_size < sizeof(struct resource_pack_header))
+		return PONG_FALSE;
+
+	const struct resource_pack_header * const p_header = p_pack->p_header;
+	if (p_header->magic != RESOURCE_PACK_MAGIC || p_header->version != RESOURCE_PACK_VERSION)
+		return PONG_FALSE;
+
+	/* Power of two buckets with at least one empty so every probe terminates */
+	if (p_header->bucket_count == 0 || (p_header->bucket_count & (p_header->bucket_count - 1)) != 0 || p_header->entry_count >= p_header->bucket_count)
+		return PONG_FALSE;
+
+	const size_t table_size = sizeof(struct resource_pack_header) + (size_t)p_header->bucket_count * sizeof(struct resource_pack_entry);
+	if (table_size > p_pack->mapping_size)
+		return PONG_FALSE;
+
+	/* Every resource must lie within the mapping */
+	for (Uint32 bucket_index = 0; bucket_index < p_header->bucket_count; bucket_index++)
+	{
+		const struct resource_pack_entry * const p_entry = p_pack->p_buckets + bucket_index;
+		if (p_entry->name_hash == RESOURCE_PACK_EMPTY_BUCKET)
+			continue;
+
+		if (
+			p_entry->offset < table_size ||
+			p_entry->offset > p_pack->mapping_size ||
+			p_entry->length > p_pack->mapping_size - p_entry->offset ||
+			memchr(p_entry->name, '\0', RESOURCE_PACK_MAX_NAME_LENGTH) == NULL
+		)
+			return PONG_FALSE;
+	}
+
+	return PONG_TRUE;
+}
+
+/* Function definitions */
+Uint64 resource_pack_hash(const char * p_name)
+{
+	/* FNV-1a - Zero marks empty buckets */
+	Uint64 hash = 0xcbf29ce484222325ULL;
+	for (const unsigned char * p_char = (const unsigned char *)p_name; *p_char; p_char++)
+		hash = (hash ^ *p_char) * 0x100000001b3ULL;
+
+	return (hash == RESOURCE_PACK_EMPTY_BUCKET) ? 1 : hash;
+}
+
+pong_bool_te resource_pack_open(const char * p_path, struct resource_pack * p_out_pack)
+{
+	p_out_pack->p_mapping = NULL;
+	p_out_pack->mapping_size = 0;
+
+	const int file_descriptor = open(p_path, O_RDONLY);
+	if (file_descriptor < 0)
+		return PONG_FALSE;
+
+	struct stat file_stat;
+	if (fstat(file_descriptor, &file_stat) != 0 || file_stat.st_size <= 0)
+	{
+		close(file_descriptor);
+		return PONG_FALSE;
+	}
+
+	/* The one read of every resource - Pages come in on first access */
+	void * const p_mapping = mmap(NULL, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+	close(file_descriptor);
+	if (p_mapping == MAP_FAILED)
+	{
+		fprintf(stderr, "\n[Resource pack] Could not map pack: %s", p_path);
+		return PONG_FALSE;
+	}
+
+	p_out_pack->p_mapping = p_mapping;
+	p_out_pack->mapping_size = (size_t)file_stat.st_size;
+	p_out_pack->p_header = p_mapping;
+	p_out_pack->p_buckets = (const struct resource_pack_entry *)(p_out_pack->p_header + 1);
+
+	if (!resource_pack_valid(p_out_pack))
+	{
+		fprintf(stderr, "\n[Resource pack] Invalid pack: %s", p_path);
+		resource_pack_close(p_out_pack);
+		return PONG_FALSE;
+	}
+
+	return PONG_TRUE;
+}
+
+pong_bool_te resource_pack_find(const struct resource_pack * p_pack, const char * p_name, const Uint8 ** p_out_data, size_t * p_out_length)
+{
+	if (p_pack->p_mapping == NULL)
+		return PONG_FALSE;
+
+	/* Probe from the home bucket until the name or an empty bucket turns up */
+	const Uint64 name_hash = resource_pack_hash(p_name);
+	const Uint32 bucket_mask = p_pack->p_header->bucket_count - 1;
+	for (Uint32 bucket_index = (Uint32)name_hash & bucket_mask; ; bucket_index = (bucket_index + 1) & bucket_mask)
+	{
+		const struct resource_pack_entry * const p_entry = p_pack->p_buckets + bucket_index;
+		if (p_entry->name_hash == RESOURCE_PACK_EMPTY_BUCKET)
+			return PONG_FALSE;
+
+		if (p_entry->name_hash == name_hash && strcmp(p_entry->name, p_name) == 0)
+		{
+			*p_out_data = p_pack->p_mapping + p_entry->offset;
+			*p_out_length = (size_t)p_entry->length;
+			return PONG_TRUE;
+		}
+	}
+}
+
+void resource_pack_close(struct resource_pack * p_pack)
+{
+	if (p_pack->p_mapping != NULL)
+		munmap(p_pack->p_mapping, p_pack->mapping_size);
+
+	p_pack->p_mapping = NULL;
+	p_pack->mapping_size = 0;
+}
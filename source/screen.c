@@ -5,19 +5,24 @@
 struct screen screen_make
 (
 	enum screen_type type,
-	screen_callback_initialize_tf p_initialize,
+	screen_callback_prepare_tf p_prepare,
+	screen_callback_activate_tf p_activate,
 	screen_callback_integrate_tf p_integrate,
 	screen_callback_render_tf p_render,
-	screen_callback_cleanup_tf p_cleanup
+	screen_callback_deactivate_tf p_deactivate,
+	screen_callback_release_tf p_release
 )
 {
 	struct screen new_screen;
 
 	new_screen.type = type;
-	new_screen.p_initialize = p_initialize;
+	new_screen.overlay = PONG_FALSE;
+	new_screen.p_prepare = p_prepare;
+	new_screen.p_activate = p_activate;
 	new_screen.p_integrate = p_integrate;
 	new_screen.p_render = p_render;
-	new_screen.p_cleanup = p_cleanup;
+	new_screen.p_deactivate = p_deactivate;
+	new_screen.p_release = p_release;
 
 	return new_screen;
 }
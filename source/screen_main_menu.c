@@ -5,6 +5,7 @@
 #include <color4ub.h>
 #include <audio_player.h>
 #include <region2Di.h>
+#include <vec2i.h>
 
 /* Datatypes */
 enum menu_item_type {
@@ -39,6 +40,11 @@ static const struct menu_item main_menu_items[] = {
 	{ "Exit to desktop", MENU_ITEM_TYPE_EXIT_TO_DESKTOP }
 };
 static struct menu main_menu;
+static int menu_block_handle = BATCHER_INVALID_BLOCK;
+static const struct gameplay_dependencies_batcher * p_deps_batcher = NULL;
+static pong_bool_te menu_layer_dirty = PONG_TRUE;
+static struct vec2i menu_layer_window_dimensions;
+static pong_bool_te menu_music_requested = PONG_FALSE;
 
 /* Private helper functions */
 static int number_of_menu_items(void)
@@ -59,12 +65,16 @@ static void set_selection_index(int direction)
 		main_menu.selection_index = 0;
 	else
 		main_menu.selection_index = next_selection_index;
+
+	/* Highlight moved - Re-record the static menu layer */
+	menu_layer_dirty = PONG_TRUE;
 }
 
 /* Function definitions */
-static void screen_initialize
+static void screen_prepare
 (
-	const struct gameplay_dependencies_windowing * p_windowing
+	const struct gameplay_dependencies_windowing * p_windowing,
+	Uint32 random_seed
 )
 {
 	/* Build the menu */
@@ -75,6 +85,15 @@ static void screen_initialize
 	main_menu.color_background = (struct color4ub){ 100, 150, 100, 255 };
 	main_menu.sfx_type = AUDIO_PLAYER_SFX_TYPE_PADDLE_HIT;
 	main_menu.p_items = main_menu_items;
+	menu_layer_dirty = PONG_TRUE;
+}
+
+static void screen_activate
+(
+	const struct gameplay_dependencies_windowing * p_windowing
+)
+{
+	menu_music_requested = PONG_FALSE;
 }
 
 static void screen_integrate
@@ -87,6 +106,13 @@ static void screen_integrate
 	screen_callback_change_request_tf change_request
 )
 {
+	/* Menu music - Keeps playing when it already is */
+	if (!menu_music_requested)
+	{
+		p_audio->play_music(AUDIO_PLAYER_MUSIC_TYPE_MENU);
+		menu_music_requested = PONG_TRUE;
+	}
+
 	/* Menu item selection */
 	if (p_input->key_pressed(INPUT_MAPPER_KEY_TYPE_MENU_UP))
 	{
@@ -122,7 +148,7 @@ static void screen_integrate
 	}
 }
 
-static void screen_render
+static void render_menu_layer
 (
 	const struct gameplay_dependencies_batcher * p_batcher,
 	const struct gameplay_dependencies_windowing * p_windowing
@@ -130,7 +156,7 @@ static void screen_render
 {
 	/* Background */
 	p_batcher->color(25, 75, 25, 255);
-	p_batcher->quadf(0, 0, 800, 600);
+	p_batcher->quadf(0, 0, p_windowing->window_width, p_windowing->window_height);
 
 	/* Render menu items */
 	struct vec2f menu_item_cursor = main_menu.base_position;
@@ -165,8 +191,43 @@ static void screen_render
 	p_batcher->text(WRITTEN_BY, 10, p_windowing->window_height - 10, 9);
 }
 
-static void screen_cleanup(void)
+static void screen_render
+(
+	const struct gameplay_dependencies_batcher * p_batcher,
+	const struct gameplay_dependencies_windowing * p_windowing
+)
+{
+	/* Draw the static menu layer from the GPU until the menu changes */
+	if (
+		!menu_layer_dirty &&
+		menu_layer_window_dimensions.x == p_windowing->window_width &&
+		menu_layer_window_dimensions.y == p_windowing->window_height &&
+		p_batcher->block_emit(menu_block_handle)
+	)
+		return;
+
+	/* Record the menu into its static layer - Still renders this frame when it cannot be retained */
+	p_deps_batcher = p_batcher;
+	if (menu_block_handle == BATCHER_INVALID_BLOCK)
+		menu_block_handle = p_batcher->block_create("main_menu");
+	const pong_bool_te recording = p_batcher->block_record_begin(menu_block_handle);
+	render_menu_layer(p_batcher, p_windowing);
+	menu_layer_dirty = (recording && p_batcher->block_record_end()) ? PONG_FALSE : PONG_TRUE;
+	menu_layer_window_dimensions = (struct vec2i){ p_windowing->window_width, p_windowing->window_height };
+}
+
+static void screen_deactivate(void)
+{
+}
+
+static void screen_release(void)
 {
+	/* Release the retained layer */
+	if (p_deps_batcher != NULL)
+		p_deps_batcher->block_destroy(menu_block_handle);
+
+	menu_block_handle = BATCHER_INVALID_BLOCK;
+	menu_layer_dirty = PONG_TRUE;
 }
 
 struct screen screen_main_menu_make(void)
@@ -174,9 +235,11 @@ struct screen screen_main_menu_make(void)
 	return screen_make
 	(
 		SCREEN_TYPE_MAIN_MENU,
-		screen_initialize,
+		screen_prepare,
+		screen_activate,
 		screen_integrate,
 		screen_render,
-		screen_cleanup
+		screen_deactivate,
+		screen_release
 	);
 }
\ No newline at end of file
@@ -47,6 +47,11 @@ struct options_menu {
 	static int selected_display_mode_index = 0;
 	/* Confirm and cancel */
 	static pong_bool_te options_have_changed = PONG_FALSE;
+	/* Static layer */
+	static int options_block_handle = BATCHER_INVALID_BLOCK;
+	static const struct gameplay_dependencies_batcher * p_deps_batcher = NULL;
+	static pong_bool_te options_layer_dirty = PONG_TRUE;
+	static struct vec2i options_layer_window_dimensions;
 
 /* Private helper functions */
 static void increment_selected_item_index_in_direction(int direction)
@@ -146,21 +151,17 @@ static void callback_display_mode_select_sub_option(int direction)
 }
 
 /* Function definitions */
-static void screen_initialize
+static void screen_prepare
 (
-	const struct gameplay_dependencies_windowing * p_windowing
+	const struct gameplay_dependencies_windowing * p_windowing,
+	Uint32 random_seed
 )
 {
-	/* Dependencies */
-	p_deps_windowing = p_windowing;
-
 	/* Reset things */
 	options_used = 0;
 	options_have_changed = PONG_FALSE;
 	selected_display_mode_index = 0;
-
-	/* Initialize options from previously configured things */
-	option_fullscreen_enabled = p_windowing->hook_window_is_fullscreen();
+	options_layer_dirty = PONG_TRUE;
 
 	/* Setup menu items */
 	struct options_menu_item item_fullscreen;
@@ -183,6 +184,18 @@ static void screen_initialize
 	/* Add items to the menu */
 	menu_options.items[options_used++] = item_fullscreen;
 	menu_options.items[options_used++] = item_display_mode;
+}
+
+static void screen_activate
+(
+	const struct gameplay_dependencies_windowing * p_windowing
+)
+{
+	/* Dependencies */
+	p_deps_windowing = p_windowing;
+
+	/* Initialize options from previously configured things - Windowing calls stay on the main thread */
+	option_fullscreen_enabled = p_windowing->hook_window_is_fullscreen();
 
 	/* Load all display modes and determine the current one */
 	number_of_display_modes = p_windowing->hook_window_number_of_display_modes();
@@ -217,11 +230,11 @@ static void screen_integrate
 	screen_callback_change_request_tf change_request
 )
 {
-	/* Back to main menu - Use a menu entry point for this */
+	/* Back to the screen the options were opened from */
 	if (p_input->key_pressed(INPUT_MAPPER_KEY_TYPE_MENU_RETURN))
 	{
 		p_audio->play_sound_effect(AUDIO_PLAYER_SFX_TYPE_MENU_RETURN);
-		change_request(SCREEN_TYPE_MAIN_MENU);
+		change_request(SCREEN_TYPE_RESUME);
 	}
 
 	/* Select option */
@@ -229,11 +242,13 @@ static void screen_integrate
 	{
 		p_audio->play_sound_effect(AUDIO_PLAYER_SFX_TYPE_MENU_SELECT);
 		increment_selected_item_index_in_direction(1);
+		options_layer_dirty = PONG_TRUE;
 	}
 	if (p_input->key_pressed(INPUT_MAPPER_KEY_TYPE_MENU_DOWN))
 	{
 		p_audio->play_sound_effect(AUDIO_PLAYER_SFX_TYPE_MENU_SELECT);
 		increment_selected_item_index_in_direction(-1);
+		options_layer_dirty = PONG_TRUE;
 	}
 
 	/* Select sub-option */
@@ -242,11 +257,13 @@ static void screen_integrate
 	{
 		p_audio->play_sound_effect(AUDIO_PLAYER_SFX_TYPE_PADDLE_HIT);
 		p_active_option->cb_selection_sub_option(-1);
+		options_layer_dirty = PONG_TRUE;
 	}
 	if (p_input->key_pressed(INPUT_MAPPER_KEY_TYPE_MENU_RIGHT))
 	{
 		p_audio->play_sound_effect(AUDIO_PLAYER_SFX_TYPE_PADDLE_HIT);
 		p_active_option->cb_selection_sub_option(1);
+		options_layer_dirty = PONG_TRUE;
 	}
 
 	/* Apply options */
@@ -259,10 +276,11 @@ static void screen_integrate
 		/* Options applied */
 		p_audio->play_sound_effect(AUDIO_PLAYER_SFX_TYPE_MENU_CHOOSE);
 		options_have_changed = PONG_FALSE;
+		options_layer_dirty = PONG_TRUE;
 	}
 }
 
-static void screen_render
+static void render_options_layer
 (
 	const struct gameplay_dependencies_batcher * p_batcher,
 	const struct gameplay_dependencies_windowing * p_windowing
@@ -270,7 +288,7 @@ static void screen_render
 {
 	/* Background */
 	p_batcher->color(25, 25, 75, 255);
-	p_batcher->quadf(0, 0, 800, 600);
+	p_batcher->quadf(0, 0, p_windowing->window_width, p_windowing->window_height);
 
 	/* Render the options menu with currently selected values */
 	struct vec2i menu_item_cursor = menu_options.base_position;
@@ -305,22 +323,65 @@ static void screen_render
 	}
 
 	p_batcher->color(150, 150, 150, 255);
-	p_batcher->text("Escape to return to main menu", 10, p_windowing->window_height - 10, 9 * 3);
+	p_batcher->text("Escape to return", 10, p_windowing->window_height - 10, 9 * 3);
+}
+
+static void screen_render
+(
+	const struct gameplay_dependencies_batcher * p_batcher,
+	const struct gameplay_dependencies_windowing * p_windowing
+)
+{
+	/* Draw the static options layer from the GPU until an option changes */
+	if (
+		!options_layer_dirty &&
+		options_layer_window_dimensions.x == p_windowing->window_width &&
+		options_layer_window_dimensions.y == p_windowing->window_height &&
+		p_batcher->block_emit(options_block_handle)
+	)
+		return;
+
+	/* Record the options into their static layer - Still renders this frame when it cannot be retained */
+	p_deps_batcher = p_batcher;
+	if (options_block_handle == BATCHER_INVALID_BLOCK)
+		options_block_handle = p_batcher->block_create("options_menu");
+	const pong_bool_te recording = p_batcher->block_record_begin(options_block_handle);
+	render_options_layer(p_batcher, p_windowing);
+	options_layer_dirty = (recording && p_batcher->block_record_end()) ? PONG_FALSE : PONG_TRUE;
+	options_layer_window_dimensions = (struct vec2i){ p_windowing->window_width, p_windowing->window_height };
 }
 
-static void screen_cleanup(void)
+static void screen_deactivate(void)
 {
+	/* Display modes are queried again on the next activation */
 	free(p_available_display_modes);
+	p_available_display_modes = NULL;
+}
+
+static void screen_release(void)
+{
+	/* Release the retained layer */
+	if (p_deps_batcher != NULL)
+		p_deps_batcher->block_destroy(options_block_handle);
+
+	options_block_handle = BATCHER_INVALID_BLOCK;
+	options_layer_dirty = PONG_TRUE;
 }
 
 struct screen screen_options_make(void)
 {
-	return screen_make
+	struct screen options_screen = screen_make
 	(
-		SCREEN_TYPE_MAIN_MENU,
-		screen_initialize,
+		SCREEN_TYPE_OPTIONS,
+		screen_prepare,
+		screen_activate,
 		screen_integrate,
 		screen_render,
-		screen_cleanup
+		screen_deactivate,
+		screen_release
 	);
+
+	/* Options are opened over the main menu or a paused match */
+	options_screen.overlay = PONG_TRUE;
+	return options_screen;
 }
@@ -0,0 +1,224 @@
+/* Includes */
+#include <screen_pause.h>
+#include <input_mapper.h>
+#include <vec2i.h>
+#include <color4ub.h>
+#include <audio_player.h>
+#include <region2Di.h>
+
+/* Datatypes */
+enum pause_item_type {
+	PAUSE_ITEM_TYPE_RESUME,
+	PAUSE_ITEM_TYPE_OPTIONS,
+	PAUSE_ITEM_TYPE_EXIT_TO_MAIN_MENU
+};
+
+struct pause_item {
+	const char * p_text;
+	enum pause_item_type type;
+};
+
+/* Constants */
+static const char * PAUSE_TITLE = "Paused";
+static const int PAUSE_FONT_HEIGHT = 9 * 3;
+static const struct color4ub PAUSE_COLOR_DIM = { 0, 0, 0, 150 };
+static const struct color4ub PAUSE_COLOR_FOREGROUND = { 255, 255, 255, 255 };
+static const struct color4ub PAUSE_COLOR_SELECTION = { 100, 150, 100, 255 };
+
+/* Private state */
+static const struct pause_item pause_items[] = {
+	{ "Resume", PAUSE_ITEM_TYPE_RESUME },
+	{ "Options", PAUSE_ITEM_TYPE_OPTIONS },
+	{ "Exit to main menu", PAUSE_ITEM_TYPE_EXIT_TO_MAIN_MENU }
+};
+static int selection_index = 0;
+static int pause_block_handle = BATCHER_INVALID_BLOCK;
+static const struct gameplay_dependencies_batcher * p_deps_batcher = NULL;
+static pong_bool_te pause_layer_dirty = PONG_TRUE;
+static struct vec2i pause_layer_window_dimensions;
+
+/* Private helper functions */
+static int number_of_pause_items(void)
+{
+	return (int)(sizeof(pause_items) / sizeof(pause_items[0]));
+}
+
+static void set_selection_index(int direction)
+{
+	const int next_selection_index = selection_index + ((direction >= 0) ? 1 : -1);
+
+	/* Apply and wrap */
+	if (next_selection_index < 0)
+		selection_index = number_of_pause_items() - 1;
+	else if (next_selection_index >= number_of_pause_items())
+		selection_index = 0;
+	else
+		selection_index = next_selection_index;
+
+	/* Highlight moved - Re-record the static pause layer */
+	pause_layer_dirty = PONG_TRUE;
+}
+
+/* Function definitions */
+static void screen_prepare
+(
+	const struct gameplay_dependencies_windowing * p_windowing,
+	Uint32 random_seed
+)
+{
+	selection_index = 0;
+	pause_layer_dirty = PONG_TRUE;
+}
+
+static void screen_activate
+(
+	const struct gameplay_dependencies_windowing * p_windowing
+)
+{
+}
+
+static void screen_integrate
+(
+	double dt,
+	const struct gameplay_dependencies_input * p_input,
+  const struct gameplay_dependencies_batcher * p_batcher,
+  const struct gameplay_dependencies_audio * p_audio,
+  const struct gameplay_dependencies_windowing * p_windowing,
+	screen_callback_change_request_tf change_request
+)
+{
+	/* Back to the match */
+	if (p_input->key_pressed(INPUT_MAPPER_KEY_TYPE_MENU_RETURN))
+	{
+		p_audio->play_sound_effect(AUDIO_PLAYER_SFX_TYPE_MENU_RETURN);
+		change_request(SCREEN_TYPE_RESUME);
+		return;
+	}
+
+	/* Pause item selection */
+	if (p_input->key_pressed(INPUT_MAPPER_KEY_TYPE_MENU_UP))
+	{
+		p_audio->play_sound_effect(AUDIO_PLAYER_SFX_TYPE_MENU_SELECT);
+		set_selection_index(-1);
+	}
+	if (p_input->key_pressed(INPUT_MAPPER_KEY_TYPE_MENU_DOWN))
+	{
+		p_audio->play_sound_effect(AUDIO_PLAYER_SFX_TYPE_MENU_SELECT);
+		set_selection_index(1);
+	}
+
+	/* Trigger selection */
+	if (p_input->key_pressed(INPUT_MAPPER_KEY_TYPE_MENU_SELECT))
+	{
+		p_audio->play_sound_effect(AUDIO_PLAYER_SFX_TYPE_MENU_CHOOSE);
+		switch (pause_items[selection_index].type)
+		{
+			case PAUSE_ITEM_TYPE_RESUME:
+				change_request(SCREEN_TYPE_RESUME);
+				break;
+			case PAUSE_ITEM_TYPE_OPTIONS:
+				change_request(SCREEN_TYPE_OPTIONS);
+				break;
+			case PAUSE_ITEM_TYPE_EXIT_TO_MAIN_MENU:
+				change_request(SCREEN_TYPE_MAIN_MENU);
+				break;
+		}
+	}
+}
+
+static void render_pause_layer
+(
+	const struct gameplay_dependencies_batcher * p_batcher,
+	const struct gameplay_dependencies_windowing * p_windowing
+)
+{
+	/* Dim the frozen match below */
+	p_batcher->color(PAUSE_COLOR_DIM.red, PAUSE_COLOR_DIM.green, PAUSE_COLOR_DIM.blue, PAUSE_COLOR_DIM.alpha);
+	p_batcher->quadf(0, 0, p_windowing->window_width, p_windowing->window_height);
+
+	/* Title */
+	p_batcher->color(PAUSE_COLOR_FOREGROUND.red, PAUSE_COLOR_FOREGROUND.green, PAUSE_COLOR_FOREGROUND.blue, PAUSE_COLOR_FOREGROUND.alpha);
+	p_batcher->text(PAUSE_TITLE, p_windowing->window_width * 0.35f, p_windowing->window_height * 0.7f, 9 * 6);
+
+	/* Pause items */
+	struct vec2i item_cursor = { p_windowing->window_width * 0.35f, p_windowing->window_height * 0.5f };
+	for (int item_index = 0; item_index < number_of_pause_items(); item_index++)
+	{
+		const struct pause_item * const p_item = pause_items + item_index;
+
+		/* Render active item background region when selected */
+		struct region2Di background_region;
+		if (
+			selection_index == item_index &&
+			p_batcher->text_region(p_item->p_text, item_cursor.x, item_cursor.y, PAUSE_FONT_HEIGHT, &background_region)
+		)
+		{
+			p_batcher->color(PAUSE_COLOR_SELECTION.red, PAUSE_COLOR_SELECTION.green, PAUSE_COLOR_SELECTION.blue, PAUSE_COLOR_SELECTION.alpha);
+			p_batcher->quadf(background_region.min.x, background_region.min.y, background_region.max.x, background_region.max.y);
+		}
+
+		/* Render item text */
+		p_batcher->color(PAUSE_COLOR_FOREGROUND.red, PAUSE_COLOR_FOREGROUND.green, PAUSE_COLOR_FOREGROUND.blue, PAUSE_COLOR_FOREGROUND.alpha);
+		p_batcher->text(p_item->p_text, item_cursor.x, item_cursor.y, PAUSE_FONT_HEIGHT);
+
+		/* Move the cursor to the next item in line */
+		item_cursor.y -= PAUSE_FONT_HEIGHT;
+	}
+}
+
+static void screen_render
+(
+	const struct gameplay_dependencies_batcher * p_batcher,
+	const struct gameplay_dependencies_windowing * p_windowing
+)
+{
+	/* Draw the static pause layer from the GPU until the selection changes */
+	if (
+		!pause_layer_dirty &&
+		pause_layer_window_dimensions.x == p_windowing->window_width &&
+		pause_layer_window_dimensions.y == p_windowing->window_height &&
+		p_batcher->block_emit(pause_block_handle)
+	)
+		return;
+
+	/* Record the pause menu into its static layer - Still renders this frame when it cannot be retained */
+	p_deps_batcher = p_batcher;
+	if (pause_block_handle == BATCHER_INVALID_BLOCK)
+		pause_block_handle = p_batcher->block_create("pause_menu");
+	const pong_bool_te recording = p_batcher->block_record_begin(pause_block_handle);
+	render_pause_layer(p_batcher, p_windowing);
+	pause_layer_dirty = (recording && p_batcher->block_record_end()) ? PONG_FALSE : PONG_TRUE;
+	pause_layer_window_dimensions = (struct vec2i){ p_windowing->window_width, p_windowing->window_height };
+}
+
+static void screen_deactivate(void)
+{
+}
+
+static void screen_release(void)
+{
+	/* Release the retained layer */
+	if (p_deps_batcher != NULL)
+		p_deps_batcher->block_destroy(pause_block_handle);
+
+	pause_block_handle = BATCHER_INVALID_BLOCK;
+	pause_layer_dirty = PONG_TRUE;
+}
+
+struct screen screen_pause_make(void)
+{
+	struct screen pause_screen = screen_make
+	(
+		SCREEN_TYPE_PAUSE,
+		screen_prepare,
+		screen_activate,
+		screen_integrate,
+		screen_render,
+		screen_deactivate,
+		screen_release
+	);
+
+	/* The match stays suspended below the pause overlay */
+	pause_screen.overlay = PONG_TRUE;
+	return pause_screen;
+}
@@ -5,6 +5,7 @@
 #include <region2Df.h>
 #include <input_mapper.h>
 #include <audio_player.h>
+#include <particle_system.h>
 
 /* Datatypes */
 struct ball {
@@ -26,6 +27,36 @@ struct edge_collider {
   struct paddle * p_associated_paddle;
 };
 
+/* Retained render nodes - Static layers only rebuilt when their inputs change */
+enum render_node_type {
+  RENDER_NODE_TYPE_BACKGROUND,
+  RENDER_NODE_TYPE_DIVIDER,
+  RENDER_NODE_TYPE_SCORES,
+  RENDER_NODE_TYPE_COUNT
+};
+
+struct render_node_inputs {
+  int window_width;
+  int window_height;
+  int score_left;
+  int score_right;
+};
+
+typedef void (* render_node_build_tf)
+(
+  const struct gameplay_dependencies_batcher * p_batcher,
+  const struct gameplay_dependencies_windowing * p_windowing
+);
+
+struct render_node {
+  const char * p_name;
+  int block_handle;
+  pong_bool_te built;
+  pong_bool_te depends_on_scores;
+  struct render_node_inputs built_inputs;
+  render_node_build_tf build;
+};
+
 /* Defines */
 #define SCORE_TEXT_MAX_LENGTH (16)
 
@@ -34,6 +65,16 @@ static const float PADDLE_PIXELS_PER_SECOND = 500.0f;
 static const float BALL_SPEED_PIXELS_PER_SECOND = 350.0f;
 const struct vec2f PADDLE_DIMENSIONS = { 5.0f, 80.0f };
 const int PADDLE_HIT_INSET = 50;
+static const struct color4ub PADDLE_LEFT_COLOR = { 255, 0, 0, 255 };
+static const struct color4ub PADDLE_RIGHT_COLOR = { 0, 255, 0, 255 };
+
+/* Particle emitters - Speeds in pixels per second, spreads in radians and lifetimes in seconds */
+static const float BALL_TRAIL_PARTICLES_PER_SECOND = 120.0f;
+static const int HIT_SPARK_PARTICLES = 48;
+static const int SCORE_BURST_PARTICLES = 800;
+static const struct particle_system_emitter PARTICLE_EMITTER_BALL_TRAIL = { 10.0f, 40.0f, 6.2831853f, 0.25f, 0.45f, 6.0f, { 255, 255, 255, 96 } };
+static const struct particle_system_emitter PARTICLE_EMITTER_HIT_SPARKS = { 150.0f, 450.0f, 2.2f, 0.3f, 0.7f, 5.0f, { 255, 255, 255, 255 } };
+static const struct particle_system_emitter PARTICLE_EMITTER_SCORE_BURST = { 200.0f, 900.0f, 3.0f, 0.6f, 1.4f, 7.0f, { 255, 255, 255, 255 } };
 
 /* Private helper function prototypes */
 struct ball make_ball(float center_x, float center_y, float diameter, float velocity_x, float velocity_y);
@@ -49,6 +90,12 @@ struct range2f project_region_onto_edge(const struct region2Df * p_region, const
 struct edge_collider make_edge_collider(float ax, float ay, float bx, float by, struct paddle * p_paddle);
 struct region2Df region_for_paddles(struct paddle * p_paddle);
 struct region2Df region_for_ball(struct ball * p_ball);
+static int ball_random(void);
+static void emit_hit_sparks(const struct particle_system_emitter * p_emitter, const struct edge_collider * p_collider);
+static void emit_score_burst(struct color4ub color, float origin_x, float origin_y, float direction_x);
+static void render_node_build_background(const struct gameplay_dependencies_batcher * p_batcher, const struct gameplay_dependencies_windowing * p_windowing);
+static void render_node_build_divider(const struct gameplay_dependencies_batcher * p_batcher, const struct gameplay_dependencies_windowing * p_windowing);
+static void render_node_build_scores(const struct gameplay_dependencies_batcher * p_batcher, const struct gameplay_dependencies_windowing * p_windowing);
 
 /* Private state */
 int score_paddle_left = 0;
@@ -58,16 +105,89 @@ struct paddle paddle_left;
 struct paddle paddle_right;
 struct edge_collider colliders[4];
 int collider_count;
+static const struct gameplay_dependencies_batcher * p_deps_batcher = NULL;
+static pong_bool_te music_stop_requested = PONG_FALSE;
+static struct particle_system particles;
+static float ball_trail_particles_owed = 0.0f;
+static Uint32 ball_random_state = 0x9e3779b9u;
+static struct render_node render_nodes[RENDER_NODE_TYPE_COUNT] = {
+  { "pong_background", BATCHER_INVALID_BLOCK, PONG_FALSE, PONG_FALSE, { 0 }, render_node_build_background },
+  { "pong_divider", BATCHER_INVALID_BLOCK, PONG_FALSE, PONG_FALSE, { 0 }, render_node_build_divider },
+  { "pong_scores", BATCHER_INVALID_BLOCK, PONG_FALSE, PONG_TRUE, { 0 }, render_node_build_scores }
+};
+
+/* Render node helpers */
+static pong_bool_te render_node_inputs_changed
+(
+  const struct render_node * p_node,
+  const struct render_node_inputs * p_inputs
+)
+{
+  /* Every node depends on the window dimensions */
+  if (
+    p_node->built_inputs.window_width != p_inputs->window_width ||
+    p_node->built_inputs.window_height != p_inputs->window_height
+  )
+    return PONG_TRUE;
+
+  if (!p_node->depends_on_scores)
+    return PONG_FALSE;
+
+  return (
+    p_node->built_inputs.score_left != p_inputs->score_left ||
+    p_node->built_inputs.score_right != p_inputs->score_right
+  ) ? PONG_TRUE : PONG_FALSE;
+}
+
+static void render_node_emit
+(
+  struct render_node * p_node,
+  const struct render_node_inputs * p_inputs,
+  const struct gameplay_dependencies_batcher * p_batcher,
+  const struct gameplay_dependencies_windowing * p_windowing
+)
+{
+  /* Re-emit the retained triangles while the node inputs are unchanged */
+  if (
+    p_node->built &&
+    !render_node_inputs_changed(p_node, p_inputs) &&
+    p_batcher->block_emit(p_node->block_handle)
+  )
+    return;
+
+  /* Rebuild the node - Still renders this frame when it cannot be retained */
+  if (p_node->block_handle == BATCHER_INVALID_BLOCK)
+    p_node->block_handle = p_batcher->block_create(p_node->p_name);
+
+  const pong_bool_te recording = p_batcher->block_record_begin(p_node->block_handle);
+  p_node->build(p_batcher, p_windowing);
+  p_node->built = recording ? p_batcher->block_record_end() : PONG_FALSE;
+  p_node->built_inputs = *p_inputs;
+}
 
 /* Function definitions */
-static void screen_initialize
+static void screen_prepare
 (
-	const struct gameplay_dependencies_windowing * p_windowing
+	const struct gameplay_dependencies_windowing * p_windowing,
+	Uint32 random_seed
 )
 {
   /* Reset scores */
   score_paddle_right = score_paddle_left = 0;
 
+  /* Ball directions follow from the seed - rand() is not safe on the preparation thread */
+  ball_random_state = random_seed ? random_seed : 0x9e3779b9u;
+
+  /* No particles left over from the last match */
+  particle_system_reset(&particles, random_seed ^ 0x5bd1e995u);
+  ball_trail_particles_owed = 0.0f;
+
+  /* Static render nodes are rebuilt on the first render */
+  for (int node_index = 0; node_index < RENDER_NODE_TYPE_COUNT; node_index++)
+  {
+    render_nodes[node_index].built = PONG_FALSE;
+  }
+
   /* Make the ball */
   ball = make_ball(
     p_windowing->window_width / 2.0f,
@@ -103,6 +223,14 @@ static void screen_initialize
   collider_count = sizeof(colliders) / sizeof(struct edge_collider);
 }
 
+static void screen_activate
+(
+	const struct gameplay_dependencies_windowing * p_windowing
+)
+{
+  music_stop_requested = PONG_FALSE;
+}
+
 static void screen_integrate
 (
 	double dt,
@@ -113,20 +241,27 @@ static void screen_integrate
 	screen_callback_change_request_tf change_request
 )
 {
-  /* Back to main menu */
+  /* The match plays without music */
+  if (!music_stop_requested)
+  {
+    p_audio->stop_music();
+    music_stop_requested = PONG_TRUE;
+  }
+
+  /* Pause the match - The match is suspended under the pause overlay */
   if (p_input->key_pressed(INPUT_MAPPER_KEY_TYPE_MENU_RETURN))
   {
     p_audio->play_sound_effect(AUDIO_PLAYER_SFX_TYPE_MENU_RETURN);
-    change_request(SCREEN_TYPE_MAIN_MENU);
+    change_request(SCREEN_TYPE_PAUSE);
   }
 
-  /* Left paddles */
-  if (p_input->key_held(INPUT_MAPPER_KEY_TYPE_LEFT_PADDLE_UP)) paddle_left.position.y += PADDLE_PIXELS_PER_SECOND * dt;
-  if (p_input->key_held(INPUT_MAPPER_KEY_TYPE_LEFT_PADDLE_DOWN)) paddle_left.position.y -= PADDLE_PIXELS_PER_SECOND * dt;
+  /* Left paddles - Moved for the fraction of the tick the keys were held or by the averaged stick deflection */
+  paddle_left.position.y += PADDLE_PIXELS_PER_SECOND * dt * p_input->key_amount(INPUT_MAPPER_KEY_TYPE_LEFT_PADDLE_UP);
+  paddle_left.position.y -= PADDLE_PIXELS_PER_SECOND * dt * p_input->key_amount(INPUT_MAPPER_KEY_TYPE_LEFT_PADDLE_DOWN);
 
   /* Right paddles */
-  if (p_input->key_held(INPUT_MAPPER_KEY_TYPE_RIGHT_PADDLE_UP)) paddle_right.position.y += PADDLE_PIXELS_PER_SECOND * dt;
-  if (p_input->key_held(INPUT_MAPPER_KEY_TYPE_RIGHT_PADDLE_DOWN)) paddle_right.position.y -= PADDLE_PIXELS_PER_SECOND * dt;
+  paddle_right.position.y += PADDLE_PIXELS_PER_SECOND * dt * p_input->key_amount(INPUT_MAPPER_KEY_TYPE_RIGHT_PADDLE_UP);
+  paddle_right.position.y -= PADDLE_PIXELS_PER_SECOND * dt * p_input->key_amount(INPUT_MAPPER_KEY_TYPE_RIGHT_PADDLE_DOWN);
 
   /* Cap vertical paddle movement */
   if (paddle_left.position.y + paddle_left.dimensions.y * 0.5f >= p_windowing->window_height) 
@@ -246,6 +381,11 @@ static void screen_integrate
           /* Deflect ball in a way that the player can influence the trajectory - For not perfect deflection */
           ball.velocity.x = ball.velocity.x + (2.0f * fabs(ball.velocity.x) * p_earliest_collider->surface_normal.x);
           ball.velocity.y = ball.velocity.y + (2.0f * fabs(ball.velocity.y) * p_earliest_collider->surface_normal.y);
+
+          /* Sparks in the color of the paddle */
+          struct particle_system_emitter paddle_sparks = PARTICLE_EMITTER_HIT_SPARKS;
+          paddle_sparks.color = (p_earliest_collider->p_associated_paddle == &paddle_left) ? PADDLE_LEFT_COLOR : PADDLE_RIGHT_COLOR;
+          emit_hit_sparks(&paddle_sparks, p_earliest_collider);
         }
       }
       else
@@ -253,6 +393,7 @@ static void screen_integrate
         /* Edge collision detection - Perfectly deflect the ball velocity on non-paddle surfaces */
         ball.velocity.x = ball.velocity.x + (2.0f * fabs(ball.velocity.x) * p_earliest_collider->surface_normal.x);
         ball.velocity.y = ball.velocity.y + (2.0f * fabs(ball.velocity.y) * p_earliest_collider->surface_normal.y);
+        emit_hit_sparks(&PARTICLE_EMITTER_HIT_SPARKS, p_earliest_collider);
       }
 
       /* Scale the deflected velocity to the time left in the frame */
@@ -271,6 +412,7 @@ static void screen_integrate
    {
      /* Left paddle scored - Right player is up next */
     p_audio->play_sound_effect(AUDIO_PLAYER_SFX_TYPE_SCORE);
+     emit_score_burst(PADDLE_LEFT_COLOR, p_windowing->window_width, ball.position.y, -1.0f);
      score_paddle_left++;
      set_ball_velocity(&ball, biased_random_ball_velocity(-1));
      ball.position = PLAYFIELD_CENTER;
@@ -279,10 +421,28 @@ static void screen_integrate
    {
      /* Right paddle scored */
      p_audio->play_sound_effect(AUDIO_PLAYER_SFX_TYPE_SCORE);
+     emit_score_burst(PADDLE_RIGHT_COLOR, 0.0f, ball.position.y, 1.0f);
      score_paddle_right++;
      set_ball_velocity(&ball, biased_random_ball_velocity(1));
      ball.position = PLAYFIELD_CENTER;
    }  
+
+  /* Trail behind the ball at a steady rate regardless of the tick length */
+  ball_trail_particles_owed += BALL_TRAIL_PARTICLES_PER_SECOND * dt;
+  const int ball_trail_particles = (int)ball_trail_particles_owed;
+  ball_trail_particles_owed -= ball_trail_particles;
+  particle_system_emit(
+    &particles,
+    &PARTICLE_EMITTER_BALL_TRAIL,
+    ball.position.x,
+    ball.position.y,
+    -ball.velocity.x,
+    -ball.velocity.y,
+    ball_trail_particles
+  );
+
+  /* Particles */
+  particle_system_update(&particles, dt);
 }
 
 static void screen_render
@@ -291,29 +451,23 @@ static void screen_render
 	const struct gameplay_dependencies_windowing * p_windowing
 )
 {
-  /* Background */
-  p_batcher->color(25, 75, 75, 255);
-  p_batcher->quadf(0, 0, 800, 600);
-
-  /* Playfield divider */
-  const int FIELD_DIV_LENGTH = p_windowing->window_height / 20;
-  const int FIELD_DIV_COUNT = 12;
-  const int FIELD_DIV_SPACE_COUNT = FIELD_DIV_COUNT - 1;
-  const int FIELD_DIV_SPACE_LENGTH = (p_windowing->window_height - (FIELD_DIV_COUNT * FIELD_DIV_LENGTH)) / FIELD_DIV_SPACE_COUNT;
-  const int FIELD_DIV_THICKNESS = 4;
-  const struct range2f FIELD_RANGE_HORI = {
-    (p_windowing->window_width * 0.5f) - (FIELD_DIV_THICKNESS * 0.5f),
-    (p_windowing->window_width * 0.5f) + (FIELD_DIV_THICKNESS * 0.5f)
+  /* Dependencies */
+  p_deps_batcher = p_batcher;
+
+  /* Inputs the static render nodes are built from */
+  const struct render_node_inputs node_inputs = {
+    p_windowing->window_width,
+    p_windowing->window_height,
+    score_paddle_left,
+    score_paddle_right
   };
-  for(int div_index = 0; div_index < FIELD_DIV_COUNT; div_index++)
-  {
-    const float DIV_BASE_HEIGHT = div_index * (FIELD_DIV_LENGTH + FIELD_DIV_SPACE_LENGTH);
-    batcher_color(255, 255, 255, 50);
-    batcher_quadf(
-      FIELD_RANGE_HORI.min, DIV_BASE_HEIGHT,
-      FIELD_RANGE_HORI.max, DIV_BASE_HEIGHT + FIELD_DIV_LENGTH
-    );  
-  }
+
+  /* Background and playfield divider */
+  render_node_emit(render_nodes + RENDER_NODE_TYPE_BACKGROUND, &node_inputs, p_batcher, p_windowing);
+  render_node_emit(render_nodes + RENDER_NODE_TYPE_DIVIDER, &node_inputs, p_batcher, p_windowing);
+
+  /* Particles behind the paddles and the ball - One streamed batch */
+  p_batcher->particles(particles.count, particles.positions_x, particles.positions_y, particles.sizes, particles.colors);
 
   /* Determine regions */
   const struct region2Df region_paddle_left = {
@@ -327,12 +481,12 @@ static void screen_render
   };
 
   /* Paddles */
-  batcher_color(255, 0, 0, 255);
+  batcher_color(PADDLE_LEFT_COLOR.red, PADDLE_LEFT_COLOR.green, PADDLE_LEFT_COLOR.blue, PADDLE_LEFT_COLOR.alpha);
   batcher_quadf(
     region_paddle_left.min.x, region_paddle_left.min.y,
     region_paddle_left.max.x, region_paddle_left.max.y
   );
-  batcher_color(0, 255, 0, 255);
+  batcher_color(PADDLE_RIGHT_COLOR.red, PADDLE_RIGHT_COLOR.green, PADDLE_RIGHT_COLOR.blue, PADDLE_RIGHT_COLOR.alpha);
   batcher_quadf(
     region_paddle_right.min.x, region_paddle_right.min.y,
     region_paddle_right.max.x, region_paddle_right.max.y
@@ -348,30 +502,93 @@ static void screen_render
   );
 
   /* Scores */
-  batcher_color(50, 150, 250, 255);
-  char score_text[SCORE_TEXT_MAX_LENGTH];
-  snprintf(score_text, SCORE_TEXT_MAX_LENGTH, "%d", score_paddle_left);
-  batcher_text(score_text, p_windowing->window_width * 0.2f, p_windowing->window_height - 50, 9 * 5);
-  snprintf(score_text, SCORE_TEXT_MAX_LENGTH, "%d", score_paddle_right);
-  batcher_text(score_text, p_windowing->window_width * 0.75f, p_windowing->window_height - 50, 9 * 5);
+  render_node_emit(render_nodes + RENDER_NODE_TYPE_SCORES, &node_inputs, p_batcher, p_windowing);
 }
 
-static void screen_cleanup(void)
+static void screen_deactivate(void)
 {
 }
 
+static void screen_release(void)
+{
+  /* Release the retained render node blocks */
+  for (int node_index = 0; node_index < RENDER_NODE_TYPE_COUNT; node_index++)
+  {
+    struct render_node * const p_node = render_nodes + node_index;
+    if (p_deps_batcher != NULL)
+      p_deps_batcher->block_destroy(p_node->block_handle);
+
+    p_node->block_handle = BATCHER_INVALID_BLOCK;
+    p_node->built = PONG_FALSE;
+  }
+}
+
 struct screen screen_pong_make(void)
 {
 	return screen_make
 	(
 		SCREEN_TYPE_PONG,
-		screen_initialize,
+		screen_prepare,
+		screen_activate,
 		screen_integrate,
 		screen_render,
-		screen_cleanup
+		screen_deactivate,
+		screen_release
 	);
 }
 
+/* Render node builders */
+static void render_node_build_background
+(
+  const struct gameplay_dependencies_batcher * p_batcher,
+  const struct gameplay_dependencies_windowing * p_windowing
+)
+{
+  p_batcher->color(25, 75, 75, 255);
+  p_batcher->quadf(0, 0, p_windowing->window_width, p_windowing->window_height);
+}
+
+static void render_node_build_divider
+(
+  const struct gameplay_dependencies_batcher * p_batcher,
+  const struct gameplay_dependencies_windowing * p_windowing
+)
+{
+  const int FIELD_DIV_LENGTH = p_windowing->window_height / 20;
+  const int FIELD_DIV_COUNT = 12;
+  const int FIELD_DIV_SPACE_COUNT = FIELD_DIV_COUNT - 1;
+  const int FIELD_DIV_SPACE_LENGTH = (p_windowing->window_height - (FIELD_DIV_COUNT * FIELD_DIV_LENGTH)) / FIELD_DIV_SPACE_COUNT;
+  const int FIELD_DIV_THICKNESS = 4;
+  const struct range2f FIELD_RANGE_HORI = {
+    (p_windowing->window_width * 0.5f) - (FIELD_DIV_THICKNESS * 0.5f),
+    (p_windowing->window_width * 0.5f) + (FIELD_DIV_THICKNESS * 0.5f)
+  };
+
+  p_batcher->color(255, 255, 255, 50);
+  for(int div_index = 0; div_index < FIELD_DIV_COUNT; div_index++)
+  {
+    const float DIV_BASE_HEIGHT = div_index * (FIELD_DIV_LENGTH + FIELD_DIV_SPACE_LENGTH);
+    p_batcher->quadf(
+      FIELD_RANGE_HORI.min, DIV_BASE_HEIGHT,
+      FIELD_RANGE_HORI.max, DIV_BASE_HEIGHT + FIELD_DIV_LENGTH
+    );
+  }
+}
+
+static void render_node_build_scores
+(
+  const struct gameplay_dependencies_batcher * p_batcher,
+  const struct gameplay_dependencies_windowing * p_windowing
+)
+{
+  p_batcher->color(50, 150, 250, 255);
+  char score_text[SCORE_TEXT_MAX_LENGTH];
+  snprintf(score_text, SCORE_TEXT_MAX_LENGTH, "%d", score_paddle_left);
+  p_batcher->text(score_text, p_windowing->window_width * 0.2f, p_windowing->window_height - 50, 9 * 5);
+  snprintf(score_text, SCORE_TEXT_MAX_LENGTH, "%d", score_paddle_right);
+  p_batcher->text(score_text, p_windowing->window_width * 0.75f, p_windowing->window_height - 50, 9 * 5);
+}
+
 /* Private helper function definitions */
 struct ball make_ball(float center_x, float center_y, float diameter, float velocity_x, float velocity_y)
 {
@@ -414,14 +631,14 @@ struct vec2f biased_random_ball_velocity(int horizontal_direction)
 {
   /* Chose a random horizontal direction when none specified */
   if (horizontal_direction == 0)
-    horizontal_direction = ((rand() % 2) == 0) ? - 1 : 1;
+    horizontal_direction = ((ball_random() % 2) == 0) ? - 1 : 1;
 
   /* Keep the angle to 45 degrees (or so) from the vertical divider */
-  const float random_offset_angle = (float)(rand() % 46);
+  const float random_offset_angle = (float)(ball_random() % 46);
   const int direction_left = (horizontal_direction <= 0) ? 1 : 0;
 
   /* Random vertical direction */
-  const int random_vertical = rand();
+  const int random_vertical = ball_random();
   float chosen_random_angle;
   if ((random_vertical % 2) == 0)
   {
@@ -565,4 +782,37 @@ struct region2Df region_for_ball(struct ball * p_ball)
   };
 
   return region_ball;
+}
+
+static int ball_random(void)
+{
+  /* Xorshift - Seeded per match in prepare */
+  Uint32 state = ball_random_state;
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  ball_random_state = state;
+  return (int)(state >> 1);
+}
+
+static void emit_hit_sparks(const struct particle_system_emitter * p_emitter, const struct edge_collider * p_collider)
+{
+  /* Off the contact point back into the playfield */
+  particle_system_emit(
+    &particles,
+    p_emitter,
+    ball.position.x - p_collider->surface_normal.x * ball.diameter * 0.5f,
+    ball.position.y - p_collider->surface_normal.y * ball.diameter * 0.5f,
+    p_collider->surface_normal.x,
+    p_collider->surface_normal.y,
+    HIT_SPARK_PARTICLES
+  );
+}
+
+static void emit_score_burst(struct color4ub color, float origin_x, float origin_y, float direction_x)
+{
+  /* Where the ball left the playfield in the color of the scoring paddle */
+  struct particle_system_emitter score_burst = PARTICLE_EMITTER_SCORE_BURST;
+  score_burst.color = color;
+  particle_system_emit(&particles, &score_burst, origin_x, origin_y, direction_x, 0.0f, SCORE_BURST_PARTICLES);
 }
\ No newline at end of file
@@ -3,16 +3,52 @@
 #include <pong_bool.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <SDL2/SDL.h>
 #include <screen_main_menu.h>
 #include <screen_pong.h>
 #include <screen_options.h>
+#include <screen_pause.h>
+
+/* Defines */
+#define SCREEN_STACK_MAX_DEPTH (4)
+
+/* Constants */
+static const char * SCREEN_STATE_MACHINE_REPORT_TRANSITIONS_VARIABLE = "PONG_REPORT_TRANSITIONS";
+#ifdef NDEBUG
+static const pong_bool_te SCREEN_STATE_MACHINE_REPORT_TRANSITIONS_DEFAULT = PONG_FALSE;
+#else
+static const pong_bool_te SCREEN_STATE_MACHINE_REPORT_TRANSITIONS_DEFAULT = PONG_TRUE;
+#endif
+
+/* Datatypes */
+enum transition_type {
+  TRANSITION_TYPE_REPLACE,
+  TRANSITION_TYPE_PUSH,
+  TRANSITION_TYPE_POP
+};
 
 /* Private state */
 static pong_bool_te screen_change_requested = PONG_FALSE;
 static enum screen_type latest_screen_type_requested;
-struct screen active_screen;
 struct screen * p_screen_type_instance_list;
 
+/* Screen stack - Only the top screen is active, the ones below are suspended */
+static struct screen screen_stack[SCREEN_STACK_MAX_DEPTH];
+static int screen_stack_depth = 0;
+
+/* Transition state - The next screen is prepared on a worker thread */
+static pong_bool_te transition_pending = PONG_FALSE;
+static enum transition_type pending_transition_type;
+static struct screen pending_screen;
+static pong_bool_te pending_screen_prepared_at_swap = PONG_FALSE;
+static struct gameplay_dependencies_windowing pending_windowing;
+static Uint32 pending_random_seed = 0;
+static SDL_Thread * p_preparation_thread = NULL;
+static SDL_atomic_t preparation_done;
+static Uint64 transition_requested_counter = 0;
+static double preparation_duration_in_milliseconds = 0.0;
+static pong_bool_te report_transitions = PONG_FALSE;
+
 /* Callbacks */
 static void screen_change_request(enum screen_type requested_screen_type)
 {
@@ -26,6 +62,181 @@ pong_bool_te screen_type_is_valid(enum screen_type screen_type)
   return (screen_type >= 0 && screen_type < SCREEN_TYPE_COUNT) ? PONG_TRUE : PONG_FALSE;
 }
 
+static struct screen * active_screen(void)
+{
+  return screen_stack + screen_stack_depth - 1;
+}
+
+static pong_bool_te screen_type_in_stack(enum screen_type screen_type)
+{
+  for (int stack_index = 0; stack_index < screen_stack_depth; stack_index++)
+  {
+    if (screen_stack[stack_index].type == screen_type)
+      return PONG_TRUE;
+  }
+
+  return PONG_FALSE;
+}
+
+static void release_screen_stack(void)
+{
+  /* Suspended screens were already deactivated */
+  if (screen_stack_depth > 0)
+    active_screen()->p_deactivate();
+
+  while (screen_stack_depth > 0)
+  {
+    active_screen()->p_release();
+    screen_stack_depth--;
+  }
+}
+
+static double counter_to_milliseconds(Uint64 counter_delta)
+{
+  return ((double)counter_delta * 1000.0) / (double)SDL_GetPerformanceFrequency();
+}
+
+static void prepare_pending_screen(void)
+{
+  const Uint64 preparation_start_counter = SDL_GetPerformanceCounter();
+  if (pending_screen.p_prepare != NULL)
+    pending_screen.p_prepare(&pending_windowing, pending_random_seed);
+
+  preparation_duration_in_milliseconds = counter_to_milliseconds(SDL_GetPerformanceCounter() - preparation_start_counter);
+}
+
+static int preparation_thread(void * p_data)
+{
+  /* Publish completion after the preparation results are written */
+  prepare_pending_screen();
+  SDL_AtomicSet(&preparation_done, 1);
+  return 0;
+}
+
+static void begin_transition
+(
+  enum transition_type transition_type,
+  enum screen_type next_screen_type,
+  const struct gameplay_dependencies_windowing * p_windowing
+)
+{
+  transition_pending = PONG_TRUE;
+  pending_transition_type = transition_type;
+  transition_requested_counter = SDL_GetPerformanceCounter();
+  preparation_duration_in_milliseconds = 0.0;
+
+  /* The worker only sees a copy of the windowing state and a seed taken here on the main thread */
+  pending_windowing = *p_windowing;
+  pending_random_seed = (Uint32)rand();
+  SDL_AtomicSet(&preparation_done, 0);
+
+  /* Resuming a suspended screen needs no preparation */
+  if (transition_type == TRANSITION_TYPE_POP)
+  {
+    pending_screen_prepared_at_swap = PONG_FALSE;
+    SDL_AtomicSet(&preparation_done, 1);
+    return;
+  }
+
+  /* Screens in the stack are still in use - Prepare them at the swap instead */
+  pending_screen = p_screen_type_instance_list[next_screen_type];
+  pending_screen_prepared_at_swap = screen_type_in_stack(next_screen_type);
+  if (pending_screen_prepared_at_swap)
+    return;
+
+  /* Prepare on a worker thread while the active screen keeps rendering */
+  p_preparation_thread = SDL_CreateThread(preparation_thread, "screen_preparation", NULL);
+  if (p_preparation_thread == NULL)
+  {
+    fprintf(stderr, "\n[Screen state machine] Could not create preparation thread - Preparing synchronously - Error: %s", SDL_GetError());
+    prepare_pending_screen();
+    SDL_AtomicSet(&preparation_done, 1);
+  }
+}
+
+static void join_preparation_thread(void)
+{
+  if (p_preparation_thread == NULL)
+    return;
+
+  SDL_WaitThread(p_preparation_thread, NULL);
+  p_preparation_thread = NULL;
+}
+
+static void complete_transition
+(
+  const struct gameplay_dependencies_batcher * p_batcher,
+  const struct gameplay_dependencies_windowing * p_windowing
+)
+{
+  join_preparation_thread();
+
+  switch (pending_transition_type)
+  {
+    case TRANSITION_TYPE_REPLACE:
+      /* Swap out every screen in the stack */
+      release_screen_stack();
+      break;
+    case TRANSITION_TYPE_PUSH:
+      /* Suspend the active screen - Its state stays in memory and its output is frozen */
+      active_screen()->p_deactivate();
+      p_batcher->backdrop_invalidate(screen_stack_depth - 1);
+      break;
+    case TRANSITION_TYPE_POP:
+      /* Close the overlay and resume the screen below */
+      active_screen()->p_deactivate();
+      active_screen()->p_release();
+      screen_stack_depth--;
+      break;
+  }
+
+  /* Swap in the prepared screen */
+  if (pending_transition_type != TRANSITION_TYPE_POP)
+  {
+    /* Screens that were in the stack are prepared after they were released */
+    if (pending_screen_prepared_at_swap)
+    {
+      pending_windowing = *p_windowing;
+      prepare_pending_screen();
+    }
+
+    screen_stack[screen_stack_depth++] = pending_screen;
+  }
+  active_screen()->p_activate(p_windowing);
+  transition_pending = PONG_FALSE;
+
+  /* Report the transition latency as seen by the player */
+  if (report_transitions)
+  {
+    printf(
+      "\n[Screen state machine] Transition to screen type %d took %.2f ms - Preparation %.2f ms",
+      active_screen()->type,
+      counter_to_milliseconds(SDL_GetPerformanceCounter() - transition_requested_counter),
+      preparation_duration_in_milliseconds
+    );
+  }
+}
+
+static void render_suspended_screen
+(
+  int stack_index,
+  const struct gameplay_dependencies_batcher * p_batcher,
+  const struct gameplay_dependencies_windowing * p_windowing
+)
+{
+  if (stack_index < 0)
+    return;
+
+  /* Draw the frozen output of the suspended screen */
+  if (p_batcher->backdrop(stack_index))
+    return;
+
+  /* Render it once more over its own backdrop and freeze the result */
+  render_suspended_screen(stack_index - 1, p_batcher, p_windowing);
+  screen_stack[stack_index].p_render(p_batcher, p_windowing);
+  p_batcher->backdrop_capture(stack_index);
+}
+
 /* Function definitions */
 pong_bool_te screen_state_machine_initialize
 (
@@ -35,9 +246,19 @@ pong_bool_te screen_state_machine_initialize
 {
   /* Prepare the state machine and report setup success */
   /* Check initial screen type */
-  if (!screen_type_is_valid(initial_screen_type) || initial_screen_type == SCREEN_TYPE_QUIT)
+  if (
+    !screen_type_is_valid(initial_screen_type) ||
+    initial_screen_type == SCREEN_TYPE_QUIT ||
+    initial_screen_type == SCREEN_TYPE_RESUME
+  )
     return PONG_FALSE;
 
+  /* Transition latency reports - On in developer builds, PONG_REPORT_TRANSITIONS=0 or 1 overrides */
+  const char * const p_report_transitions = SDL_getenv(SCREEN_STATE_MACHINE_REPORT_TRANSITIONS_VARIABLE);
+  report_transitions = (p_report_transitions != NULL && p_report_transitions[0] != '\0')
+    ? ((p_report_transitions[0] != '0') ? PONG_TRUE : PONG_FALSE)
+    : SCREEN_STATE_MACHINE_REPORT_TRANSITIONS_DEFAULT;
+
   /* Specify screen type to screen instance mapping */
   p_screen_type_instance_list = malloc(sizeof(struct screen) * SCREEN_TYPE_COUNT);
   if (p_screen_type_instance_list == NULL)
@@ -50,10 +271,13 @@ pong_bool_te screen_state_machine_initialize
   p_screen_type_instance_list[SCREEN_TYPE_MAIN_MENU] = screen_main_menu_make();
   p_screen_type_instance_list[SCREEN_TYPE_PONG] = screen_pong_make();
   p_screen_type_instance_list[SCREEN_TYPE_OPTIONS] = screen_options_make();
+  p_screen_type_instance_list[SCREEN_TYPE_PAUSE] = screen_pause_make();
 
-  /* Kick of with the provided screen and initialize it */
-  active_screen = p_screen_type_instance_list[initial_screen_type];
-  active_screen.p_initialize(p_windowing);
+  /* Kick of with the provided screen - Nothing to render meanwhile so prepare synchronously */
+  screen_stack_depth = 0;
+  screen_stack[screen_stack_depth++] = p_screen_type_instance_list[initial_screen_type];
+  active_screen()->p_prepare(p_windowing, (Uint32)rand());
+  active_screen()->p_activate(p_windowing);
 
   return PONG_TRUE;
 }
@@ -67,11 +291,16 @@ pong_bool_te screen_state_machine_tick
   const struct gameplay_dependencies_windowing * p_windowing
 )
 {
+  /* Swap to the prepared screen at the frame boundary */
+  if (transition_pending && (SDL_AtomicGet(&preparation_done) || pending_screen_prepared_at_swap))
+    complete_transition(p_batcher, p_windowing);
+
   /* Integrate and determine whether another screen is requested */
-  active_screen.p_integrate(dts, p_input, p_batcher, p_audio, p_windowing, screen_change_request);
+  active_screen()->p_integrate(dts, p_input, p_batcher, p_audio, p_windowing, screen_change_request);
 
-  /* Render the active screen */
-  active_screen.p_render(p_batcher, p_windowing);
+  /* Render the suspended screens as frozen backdrop and the active screen over it */
+  render_suspended_screen(screen_stack_depth - 2, p_batcher, p_windowing);
+  active_screen()->p_render(p_batcher, p_windowing);
 
   /* Contine when not screen change is was requested */
   if (!screen_change_requested)
@@ -80,25 +309,61 @@ pong_bool_te screen_state_machine_tick
   /* Reset request mechanism */
   screen_change_requested = PONG_FALSE;
 
-  /* Cleanup the active screen */
-  active_screen.p_cleanup();
-
   /* Requested screen type is invalid */
   if (!screen_type_is_valid(latest_screen_type_requested))
   {
     fprintf(stderr, "\n[Screen state machine] Invalid screen type requested");
+    join_preparation_thread();
+    release_screen_stack();
     return PONG_FALSE;
   }
 
   if (latest_screen_type_requested == SCREEN_TYPE_QUIT)
   {
-    /* Requested to close the screen state machine */
+    /* Requested to close the screen state machine - Wait for and drop any prepared screen */
+    join_preparation_thread();
+    release_screen_stack();
+    if (transition_pending && pending_transition_type != TRANSITION_TYPE_POP && !pending_screen_prepared_at_swap)
+      pending_screen.p_release();
+    transition_pending = PONG_FALSE;
     return PONG_FALSE;
   }
 
-  /* Switch to the new screen type and initialize before usage */
-  active_screen = p_screen_type_instance_list[latest_screen_type_requested];
-  active_screen.p_initialize(p_windowing);
+  /* Only one transition at a time */
+  if (transition_pending)
+  {
+    fprintf(stderr, "\n[Screen state machine] Ignoring screen change while a transition is pending");
+    return PONG_TRUE;
+  }
+
+  /* Resume the screen below the active overlay */
+  if (latest_screen_type_requested == SCREEN_TYPE_RESUME)
+  {
+    if (screen_stack_depth <= 1)
+    {
+      fprintf(stderr, "\n[Screen state machine] No suspended screen to resume");
+      return PONG_TRUE;
+    }
+
+    begin_transition(TRANSITION_TYPE_POP, latest_screen_type_requested, p_windowing);
+    return PONG_TRUE;
+  }
+
+  /* Overlays are pushed over the active screen - Everything else replaces the stack */
+  if (p_screen_type_instance_list[latest_screen_type_requested].overlay)
+  {
+    if (screen_stack_depth >= SCREEN_STACK_MAX_DEPTH || screen_type_in_stack(latest_screen_type_requested))
+    {
+      fprintf(stderr, "\n[Screen state machine] Cannot push overlay screen type %d", latest_screen_type_requested);
+      return PONG_TRUE;
+    }
+
+    begin_transition(TRANSITION_TYPE_PUSH, latest_screen_type_requested, p_windowing);
+    return PONG_TRUE;
+  }
+
+  /* Prepare the requested screen while the active one keeps ticking */
+  begin_transition(TRANSITION_TYPE_REPLACE, latest_screen_type_requested, p_windowing);
 
   /* Keep ticking the state machine */
   return PONG_TRUE;
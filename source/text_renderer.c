@@ -1,6 +1,9 @@
 /* Includes */
 #include <text_renderer.h>
 #include <texture_loader.h>
+#include <vec2f.h>
+#include <stdlib.h>
+#include <math.h>
 
 /* Defines */
 #define ASCII_CODE_RANGE_FLOOR (0)
@@ -19,7 +22,12 @@ struct ascii_glyph_info {
 /* Private state */
 static pong_bool_te text_renderer_initialized = PONG_FALSE;
 static struct ascii_glyph_info ascii_glyph_info_store[ASCII_CODE_RANGE_CEILING];
-static SDL_Surface * p_glyph_texture = NULL;
+static struct raw_texture glyph_texture;
+static pong_bool_te glyph_texture_ready = PONG_FALSE;
+static Uint8 * p_glyph_texture_data = NULL;
+static int glyph_texture_handle = ASSET_LOADER_INVALID_HANDLE;
+static struct raw_texture glyph_distance_field;
+static pong_bool_te glyph_distance_field_active = PONG_FALSE;
 
 /* Private helper functions */
 static pong_bool_te is_valid_ascii_code(int ascii_code)
@@ -43,36 +51,21 @@ static void register_printable_glyph(int ascii_code, int texture_grid_x, int tex
   /* Determine the glyph texcoords based on the texture grid region */
   /* TODO-GS: Compute from the actual texture dimensions */
   struct ascii_glyph_info * const p_info = ascii_glyph_info_store + ascii_code;
-  const float texture_glyph_span_x = (float)GLYPH_WIDTH_IN_PIXELS / (float)p_glyph_texture->w;
-  const float texture_glyph_span_y = (float)GLYPH_HEIGHT_IN_PIXELS / (float)p_glyph_texture->h;
+  const float texture_width = (float)glyph_texture.p_header->width;
+  const float texture_height = (float)glyph_texture.p_header->height;
+  const float texture_glyph_span_x = (float)GLYPH_WIDTH_IN_PIXELS / texture_width;
+  const float texture_glyph_span_y = (float)GLYPH_HEIGHT_IN_PIXELS / texture_height;
 
-  p_info->texcoords_region.min.x = ((texture_grid_x * (GLYPH_WIDTH_IN_PIXELS + 1)) + 1) / (float)p_glyph_texture->w;
-  p_info->texcoords_region.min.y = ((texture_grid_y * (GLYPH_HEIGHT_IN_PIXELS + 1)) + 1) / (float)p_glyph_texture->h;
+  p_info->texcoords_region.min.x = ((texture_grid_x * (GLYPH_WIDTH_IN_PIXELS + 1)) + 1) / texture_width;
+  p_info->texcoords_region.min.y = ((texture_grid_y * (GLYPH_HEIGHT_IN_PIXELS + 1)) + 1) / texture_height;
   p_info->texcoords_region.max.x = p_info->texcoords_region.min.x + texture_glyph_span_x;
   p_info->texcoords_region.max.y = p_info->texcoords_region.min.y + texture_glyph_span_y;
 
   p_info->is_printable = PONG_TRUE;
 }
 
-/* Function definitions */
-pong_bool_te text_renderer_initialize(void)
+static void register_glyphs(void)
 {
-  /* Initialize only on the first invocation */
-  if (text_renderer_initialized == PONG_TRUE)
-    return PONG_TRUE;
-
-  /* Make sure the texture loader is initialized */
-  if (texture_loader_initialize() == PONG_FALSE)
-    return PONG_FALSE;
-
-  /* Load the glyph texture for all text rendering */
-  p_glyph_texture = texture_loader_load_texture("font_5x9_glyph_texture.png");
-  if (p_glyph_texture == NULL)
-  {
-    fprintf(stderr, "\n[Pong] Could not load the required glyph texture for font rendering");
-    return PONG_FALSE;
-  }
-
   /* Initialize all glyphs to non-printable */
   for (int ascii_code = ASCII_CODE_RANGE_FLOOR; ascii_code < ASCII_CODE_RANGE_CEILING; ascii_code++)
   {
@@ -179,14 +172,87 @@ pong_bool_te text_renderer_initialize(void)
   register_printable_glyph('}', 9, 4);
   register_printable_glyph('~', 10, 4);
 
+  glyph_texture_ready = PONG_TRUE;
+}
+
+static void glyph_texture_loaded(int texture_handle, void * p_user_data)
+{
+  /* Fallback without a pre-decoded texture - Convert the decoded PNG once */
+  SDL_Surface * const p_glyph_surface = texture_loader_texture(texture_handle);
+  size_t glyph_texture_length = 0;
+  const pong_bool_te converted = (
+    p_glyph_surface != NULL &&
+    raw_texture_build(p_glyph_surface, &p_glyph_texture_data, &glyph_texture_length) &&
+    raw_texture_open_memory(p_glyph_texture_data, glyph_texture_length, &glyph_texture)
+  ) ? PONG_TRUE : PONG_FALSE;
+
+  /* The surface is not needed after the conversion */
+  texture_loader_destroy_texture(glyph_texture_handle);
+  glyph_texture_handle = ASSET_LOADER_INVALID_HANDLE;
+
+  if (!converted)
+  {
+    fprintf(stderr, "\n[Pong] Could not load the required glyph texture for font rendering");
+    return;
+  }
+
+  register_glyphs();
+}
+
+/* Function definitions */
+pong_bool_te text_renderer_initialize(void)
+{
+  /* Initialize only on the first invocation */
+  if (text_renderer_initialized == PONG_TRUE)
+    return PONG_TRUE;
+
+  /* Make sure the texture loader is initialized */
+  if (texture_loader_initialize() == PONG_FALSE)
+    return PONG_FALSE;
+
+  /* Pre-decoded glyph texture - Nothing to decode, the pixels are uploaded from the mapping as-is */
+  if (texture_loader_open_raw_texture("font_5x9_glyph_texture.rtex", &glyph_texture))
+  {
+    register_glyphs();
+    text_renderer_initialized = PONG_TRUE;
+    return PONG_TRUE;
+  }
+
+  /* Otherwise decode the PNG in the background - Glyphs are registered once it is decoded */
+  fprintf(stderr, "\n[Pong] No pre-decoded glyph texture - Decoding the PNG, the default build packs it: make compile");
+  glyph_texture_handle = texture_loader_load_texture("font_5x9_glyph_texture.png", glyph_texture_loaded, NULL);
+  if (glyph_texture_handle == ASSET_LOADER_INVALID_HANDLE)
+  {
+    fprintf(stderr, "\n[Pong] Could not request the required glyph texture for font rendering");
+    return PONG_FALSE;
+  }
+
   /* Initialization done */
   text_renderer_initialized = PONG_TRUE;
   return PONG_TRUE;
 }
 
-const SDL_Surface * text_renderer_texture_info(void)
+const struct raw_texture * text_renderer_texture_info(void)
 {
-  return p_glyph_texture;
+  /* Needed right away - Wait for the decode to finish */
+  if (!glyph_texture_ready && glyph_texture_handle != ASSET_LOADER_INVALID_HANDLE)
+    asset_loader_wait(glyph_texture_handle);
+
+  return glyph_texture_ready ? &glyph_texture : NULL;
+}
+
+const struct raw_texture * text_renderer_use_distance_field(void)
+{
+  if (glyph_distance_field_active)
+    return &glyph_distance_field;
+
+  /* Same layout as the bitmap sheet at a higher resolution - Glyph texcoords stay valid */
+  if (!text_renderer_initialized || !texture_loader_open_raw_texture("font_5x9_glyph_sdf.rtex", &glyph_distance_field))
+    return NULL;
+
+  /* From here on font heights are no longer rounded down to whole multiples */
+  glyph_distance_field_active = PONG_TRUE;
+  return &glyph_distance_field;
 }
 
 void text_renderer_text_info(
@@ -207,13 +273,15 @@ void text_renderer_text_info(
   if (p_text == NULL)
     return;
 
-  /* Determine font-size multiplier to keep glyphs rendered in the original ratio */
-  if (desired_font_height < GLYPH_HEIGHT_IN_PIXELS)
+  /* Determine font-size multiplier - Whole multiples keep bitmap glyphs in the original ratio, distance field glyphs scale freely */
+  if (!glyph_distance_field_active && desired_font_height < GLYPH_HEIGHT_IN_PIXELS)
     desired_font_height = GLYPH_HEIGHT_IN_PIXELS;
-  const int FONT_SCALE = desired_font_height / GLYPH_HEIGHT_IN_PIXELS;
+  const float FONT_SCALE = glyph_distance_field_active
+    ? (float)desired_font_height / GLYPH_HEIGHT_IN_PIXELS
+    : (float)(desired_font_height / GLYPH_HEIGHT_IN_PIXELS);
 
   /* Generate text glyph info */
-  struct vec2i glyph_cursor = { base_x, base_y };
+  struct vec2f glyph_cursor = { base_x, base_y };
   const char * p_text_char = NULL;
   for (p_text_char = p_text; *p_text_char; p_text_char++)
   {
@@ -226,8 +294,8 @@ void text_renderer_text_info(
 
     /* Discern between printing and control characters */
     const int SPACES_PER_TAB = 2;
-    const int SCALED_GLYPH_WIDTH = GLYPH_WIDTH_IN_PIXELS * FONT_SCALE;
-    const int SCALED_GLYPH_HEIGHT = GLYPH_HEIGHT_IN_PIXELS * FONT_SCALE;
+    const float SCALED_GLYPH_WIDTH = GLYPH_WIDTH_IN_PIXELS * FONT_SCALE;
+    const float SCALED_GLYPH_HEIGHT = GLYPH_HEIGHT_IN_PIXELS * FONT_SCALE;
     const char text_char = *p_text_char;
     if (text_char == '\n')
     {
@@ -245,11 +313,11 @@ void text_renderer_text_info(
       /* Generate textured quad rendering info */
       struct text_renderer_glyph_info * const p_info = p_cache->glyph_infos + p_cache->glyph_infos_generated++;
 
-      /* Rendering region */
-      p_info->render_region.min.x = glyph_cursor.x;
-      p_info->render_region.min.y = glyph_cursor.y - SCALED_GLYPH_HEIGHT;
-      p_info->render_region.max.x = glyph_cursor.x + SCALED_GLYPH_WIDTH;
-      p_info->render_region.max.y = glyph_cursor.y;
+      /* Rendering region - Snapped to whole pixels */
+      p_info->render_region.min.x = (int)lroundf(glyph_cursor.x);
+      p_info->render_region.min.y = (int)lroundf(glyph_cursor.y - SCALED_GLYPH_HEIGHT);
+      p_info->render_region.max.x = (int)lroundf(glyph_cursor.x + SCALED_GLYPH_WIDTH);
+      p_info->render_region.max.y = (int)lroundf(glyph_cursor.y);
 
       /* Texcoords region */
       p_info->texcoords_region = ascii_glyph_info_store[text_char].texcoords_region;
@@ -265,7 +333,15 @@ void text_renderer_text_info(
 
 void text_renderer_text_cleanup(void)
 {
-  texture_loader_destroy_texture(p_glyph_texture);
-  texture_loader_cleanup();
+  texture_loader_destroy_texture(glyph_texture_handle);
+  glyph_texture_handle = ASSET_LOADER_INVALID_HANDLE;
+
+  /* Unmapped - Or freed when converted from the PNG */
+  raw_texture_close(&glyph_texture);
+  raw_texture_close(&glyph_distance_field);
+  glyph_distance_field_active = PONG_FALSE;
+  free(p_glyph_texture_data);
+  p_glyph_texture_data = NULL;
+  glyph_texture_ready = PONG_FALSE;
   text_renderer_initialized = PONG_FALSE;
 }
@@ -0,0 +1,322 @@
+/* Includes */
+#include <texture_atlas.h>
+#include <SDL2/SDL_opengl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Defines */
+#define TEXTURE_ATLAS_CHANNELS (4)
+
+/* Datatypes */
+struct texture_atlas_skyline_node {
+  int x;
+  int y;
+  int width;
+};
+
+struct texture_atlas_page {
+  pong_bool_te in_use;
+  GLuint texture_handle;
+  enum texture_atlas_filter filter;
+  Uint8 * p_pixels;
+
+  /* Top edge of the packed rectangles from left to right */
+  int node_count;
+  struct texture_atlas_skyline_node nodes[TEXTURE_ATLAS_MAX_SKYLINE_NODES];
+
+  /* Rows changed since the last upload */
+  pong_bool_te dirty;
+  int dirty_min_y;
+  int dirty_max_y;
+};
+
+/* Private state */
+static pong_bool_te texture_atlas_initialized = PONG_FALSE;
+static struct texture_atlas_page pages[TEXTURE_ATLAS_MAX_PAGES];
+static struct texture_atlas_region regions[TEXTURE_ATLAS_MAX_REGIONS];
+static int region_count = 0;
+
+/* Private helper functions */
+static int skyline_fit(const struct texture_atlas_page * p_page, int node_index, int width, int height)
+{
+  /* Lowest y the rectangle rests at when its left edge starts at the node */
+  const int x = p_page->nodes[node_index].x;
+  if (x + width > TEXTURE_ATLAS_PAGE_SIZE)
+    return -1;
+
+  int y = 0;
+  int width_left = width;
+  for (int span_index = node_index; width_left > 0; span_index++)
+  {
+    const struct texture_atlas_skyline_node * const p_node = p_page->nodes + span_index;
+    y = (p_node->y > y) ? p_node->y : y;
+    if (y + height > TEXTURE_ATLAS_PAGE_SIZE)
+      return -1;
+
+    width_left -= p_node->width;
+  }
+
+  return y;
+}
+
+static void skyline_insert(struct texture_atlas_page * p_page, int node_index, int x, int y, int width, int height)
+{
+  /* New node on top of the rectangle */
+  memmove(
+    p_page->nodes + node_index + 1,
+    p_page->nodes + node_index,
+    sizeof(struct texture_atlas_skyline_node) * (p_page->node_count - node_index)
+  );
+  p_page->nodes[node_index] = (struct texture_atlas_skyline_node){ x, y + height, width };
+  p_page->node_count++;
+
+  /* Shrink or drop the nodes it now covers */
+  for (int covered_index = node_index + 1; covered_index < p_page->node_count; )
+  {
+    const struct texture_atlas_skyline_node * const p_previous = p_page->nodes + covered_index - 1;
+    struct texture_atlas_skyline_node * const p_node = p_page->nodes + covered_index;
+    const int overlap = p_previous->x + p_previous->width - p_node->x;
+    if (overlap <= 0)
+      break;
+
+    p_node->x += overlap;
+    p_node->width -= overlap;
+    if (p_node->width > 0)
+      break;
+
+    memmove(p_node, p_node + 1, sizeof(struct texture_atlas_skyline_node) * (p_page->node_count - covered_index - 1));
+    p_page->node_count--;
+  }
+
+  /* Merge neighbours at the same height */
+  for (int merge_index = 0; merge_index + 1 < p_page->node_count; )
+  {
+    struct texture_atlas_skyline_node * const p_node = p_page->nodes + merge_index;
+    if (p_node->y != p_node[1].y)
+    {
+      merge_index++;
+      continue;
+    }
+
+    p_node->width += p_node[1].width;
+    memmove(p_node + 1, p_node + 2, sizeof(struct texture_atlas_skyline_node) * (p_page->node_count - merge_index - 2));
+    p_page->node_count--;
+  }
+}
+
+static pong_bool_te page_pack(struct texture_atlas_page * p_page, int width, int height, int * p_out_x, int * p_out_y)
+{
+  /* Inserting may split a node */
+  if (p_page->node_count + 1 > TEXTURE_ATLAS_MAX_SKYLINE_NODES)
+    return PONG_FALSE;
+
+  /* Bottom-left - Lowest resting top edge, then the narrowest node */
+  int best_node_index = -1;
+  int best_top = TEXTURE_ATLAS_PAGE_SIZE + 1;
+  int best_width = TEXTURE_ATLAS_PAGE_SIZE + 1;
+  for (int node_index = 0; node_index < p_page->node_count; node_index++)
+  {
+    const int y = skyline_fit(p_page, node_index, width, height);
+    if (y < 0)
+      continue;
+
+    const int node_width = p_page->nodes[node_index].width;
+    if (y + height < best_top || (y + height == best_top && node_width < best_width))
+    {
+      best_node_index = node_index;
+      best_top = y + height;
+      best_width = node_width;
+    }
+  }
+  if (best_node_index < 0)
+    return PONG_FALSE;
+
+  *p_out_x = p_page->nodes[best_node_index].x;
+  *p_out_y = best_top - height;
+  skyline_insert(p_page, best_node_index, *p_out_x, *p_out_y, width, height);
+  return PONG_TRUE;
+}
+
+static struct texture_atlas_page * page_create(enum texture_atlas_filter filter)
+{
+  for (int page_index = 0; page_index < TEXTURE_ATLAS_MAX_PAGES; page_index++)
+  {
+    struct texture_atlas_page * const p_page = pages + page_index;
+    if (p_page->in_use)
+      continue;
+
+    /* Transparent until packed - Padding around every region stays that way */
+    p_page->p_pixels = calloc((size_t)TEXTURE_ATLAS_PAGE_SIZE * TEXTURE_ATLAS_PAGE_SIZE, TEXTURE_ATLAS_CHANNELS);
+    if (p_page->p_pixels == NULL)
+      return NULL;
+
+    glGenTextures(1, &p_page->texture_handle);
+    glBindTexture(GL_TEXTURE_2D, p_page->texture_handle);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, TEXTURE_ATLAS_PAGE_SIZE, TEXTURE_ATLAS_PAGE_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, p_page->p_pixels);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, (filter == TEXTURE_ATLAS_FILTER_LINEAR) ? GL_LINEAR : GL_NEAREST);
+
+    p_page->in_use = PONG_TRUE;
+    p_page->filter = filter;
+    p_page->node_count = 1;
+    p_page->nodes[0] = (struct texture_atlas_skyline_node){ 0, 0, TEXTURE_ATLAS_PAGE_SIZE };
+    p_page->dirty = PONG_FALSE;
+    printf(
+      "\n[Texture atlas] Created %s page %d of %dx%d",
+      (filter == TEXTURE_ATLAS_FILTER_LINEAR) ? "linear" : "nearest",
+      page_index,
+      TEXTURE_ATLAS_PAGE_SIZE,
+      TEXTURE_ATLAS_PAGE_SIZE
+    );
+    return p_page;
+  }
+
+  return NULL;
+}
+
+static void page_copy(struct texture_atlas_page * p_page, int x, int y, int width, int height, int channels, const Uint8 * p_pixels)
+{
+  /* Alpha-only images become white so the vertex color still tints them */
+  for (int row = 0; row < height; row++)
+  {
+    const Uint8 * const p_source = p_pixels + (size_t)row * width * channels;
+    Uint8 * const p_destination = p_page->p_pixels + ((size_t)(y + row) * TEXTURE_ATLAS_PAGE_SIZE + x) * TEXTURE_ATLAS_CHANNELS;
+    if (channels == TEXTURE_ATLAS_CHANNELS)
+    {
+      memcpy(p_destination, p_source, (size_t)width * TEXTURE_ATLAS_CHANNELS);
+      continue;
+    }
+
+    for (int column = 0; column < width; column++)
+    {
+      Uint8 * const p_texel = p_destination + column * TEXTURE_ATLAS_CHANNELS;
+      p_texel[0] = p_texel[1] = p_texel[2] = 255;
+      p_texel[3] = p_source[column];
+    }
+  }
+
+  /* Uploaded on the next upload */
+  p_page->dirty_min_y = (!p_page->dirty || y < p_page->dirty_min_y) ? y : p_page->dirty_min_y;
+  p_page->dirty_max_y = (!p_page->dirty || y + height > p_page->dirty_max_y) ? y + height : p_page->dirty_max_y;
+  p_page->dirty = PONG_TRUE;
+}
+
+/* Function definitions */
+pong_bool_te texture_atlas_initialize(void)
+{
+  if (texture_atlas_initialized)
+    return PONG_TRUE;
+
+  for (int page_index = 0; page_index < TEXTURE_ATLAS_MAX_PAGES; page_index++)
+    pages[page_index] = (struct texture_atlas_page){ 0 };
+  region_count = 0;
+
+  texture_atlas_initialized = PONG_TRUE;
+  return PONG_TRUE;
+}
+
+int texture_atlas_add(int width, int height, int channels, const Uint8 * p_pixels, enum texture_atlas_filter filter)
+{
+  if (!texture_atlas_initialized || p_pixels == NULL || width <= 0 || height <= 0 || (channels != 1 && channels != TEXTURE_ATLAS_CHANNELS))
+    return TEXTURE_ATLAS_INVALID_REGION;
+
+  if (region_count >= TEXTURE_ATLAS_MAX_REGIONS)
+  {
+    fprintf(stderr, "\n[Texture atlas] All %d regions in use", TEXTURE_ATLAS_MAX_REGIONS);
+    return TEXTURE_ATLAS_INVALID_REGION;
+  }
+
+  /* Padded so filtering never samples a neighbour */
+  const int padded_width = width + TEXTURE_ATLAS_PADDING * 2;
+  const int padded_height = height + TEXTURE_ATLAS_PADDING * 2;
+  if (padded_width > TEXTURE_ATLAS_PAGE_SIZE || padded_height > TEXTURE_ATLAS_PAGE_SIZE)
+  {
+    fprintf(stderr, "\n[Texture atlas] Image of %dx%d exceeds the page size of %d", width, height, TEXTURE_ATLAS_PAGE_SIZE);
+    return TEXTURE_ATLAS_INVALID_REGION;
+  }
+
+  /* First page with room and the same magnification filter - A new one only when all are full */
+  struct texture_atlas_page * p_page = NULL;
+  int x = 0;
+  int y = 0;
+  for (int page_index = 0; page_index < TEXTURE_ATLAS_MAX_PAGES && p_page == NULL; page_index++)
+  {
+    if (pages[page_index].in_use && pages[page_index].filter == filter && page_pack(pages + page_index, padded_width, padded_height, &x, &y))
+      p_page = pages + page_index;
+  }
+  if (p_page == NULL)
+  {
+    p_page = page_create(filter);
+    if (p_page == NULL || !page_pack(p_page, padded_width, padded_height, &x, &y))
+    {
+      fprintf(stderr, "\n[Texture atlas] No room for an image of %dx%d", width, height);
+      return TEXTURE_ATLAS_INVALID_REGION;
+    }
+  }
+
+  x += TEXTURE_ATLAS_PADDING;
+  y += TEXTURE_ATLAS_PADDING;
+  page_copy(p_page, x, y, width, height, channels, p_pixels);
+
+  const int region_handle = region_count++;
+  struct texture_atlas_region * const p_region = regions + region_handle;
+  p_region->texture_handle = p_page->texture_handle;
+  p_region->width = width;
+  p_region->height = height;
+  p_region->texcoords_region.min.x = (float)x / TEXTURE_ATLAS_PAGE_SIZE;
+  p_region->texcoords_region.min.y = (float)y / TEXTURE_ATLAS_PAGE_SIZE;
+  p_region->texcoords_region.max.x = (float)(x + width) / TEXTURE_ATLAS_PAGE_SIZE;
+  p_region->texcoords_region.max.y = (float)(y + height) / TEXTURE_ATLAS_PAGE_SIZE;
+  return region_handle;
+}
+
+const struct texture_atlas_region * texture_atlas_region(int region_handle)
+{
+  if (region_handle < 0 || region_handle >= region_count)
+    return NULL;
+
+  return regions + region_handle;
+}
+
+void texture_atlas_upload(void)
+{
+  /* Only the changed rows of every page */
+  for (int page_index = 0; page_index < TEXTURE_ATLAS_MAX_PAGES; page_index++)
+  {
+    struct texture_atlas_page * const p_page = pages + page_index;
+    if (!p_page->in_use || !p_page->dirty)
+      continue;
+
+    glBindTexture(GL_TEXTURE_2D, p_page->texture_handle);
+    glTexSubImage2D(
+      GL_TEXTURE_2D,
+      0,
+      0,
+      p_page->dirty_min_y,
+      TEXTURE_ATLAS_PAGE_SIZE,
+      p_page->dirty_max_y - p_page->dirty_min_y,
+      GL_RGBA,
+      GL_UNSIGNED_BYTE,
+      p_page->p_pixels + (size_t)p_page->dirty_min_y * TEXTURE_ATLAS_PAGE_SIZE * TEXTURE_ATLAS_CHANNELS
+    );
+    p_page->dirty = PONG_FALSE;
+  }
+}
+
+void texture_atlas_cleanup(void)
+{
+  for (int page_index = 0; page_index < TEXTURE_ATLAS_MAX_PAGES; page_index++)
+  {
+    struct texture_atlas_page * const p_page = pages + page_index;
+    if (!p_page->in_use)
+      continue;
+
+    glDeleteTextures(1, &p_page->texture_handle);
+    free(p_page->p_pixels);
+    *p_page = (struct texture_atlas_page){ 0 };
+  }
+
+  region_count = 0;
+  texture_atlas_initialized = PONG_FALSE;
+}
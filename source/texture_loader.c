@@ -1,60 +1,68 @@
 /* Includes */
 #include <texture_loader.h>
-#include <SDL2/SDL_image.h>
 
 /* Defines */
 #define MAX_PATH_LENGTH (512)
 
-/* Function definitions - TODO-GS: Split into headers and source files */
+/* Function definitions */
 pong_bool_te texture_loader_initialize(void)
 {
-  /* TODO-GS: Make sure the loader can be initialized but once */
-  const int required_image_flags = IMG_INIT_PNG;
-  if (!(IMG_Init(required_image_flags) & required_image_flags))
-  {
-    fprintf(stderr, "\n[Texture loader] %s\n", IMG_GetError());
-    return PONG_FALSE;
-  }
-
-  return PONG_TRUE;
+  /* Textures are decoded by the asset loader workers */
+  return asset_loader_initialize();
 }
 
-SDL_Surface * texture_loader_load_texture
+int texture_loader_load_texture
 (
-  const char * p_texture_name_with_extension
+  const char * p_texture_name_with_extension,
+  asset_loader_completion_tf completion,
+  void * p_user_data
 )
 {
   if (p_texture_name_with_extension == NULL)
-    return NULL;
+    return ASSET_LOADER_INVALID_HANDLE;
 
-  /* Determine the absolute path to the texture */
-  static char absolute_texture_path[MAX_PATH_LENGTH];
+  /* Determine the texture path relative to the resources - Local so concurrent requests do not clash */
+  char texture_path[MAX_PATH_LENGTH];
   snprintf(
-    absolute_texture_path,
+    texture_path,
     MAX_PATH_LENGTH,
-    "%s%s/%s",
-    SDL_GetBasePath(),
-    "../resources/images",
+    "%s/%s",
+    "images",
     p_texture_name_with_extension
   );
 
-  /* Attempt to load the texture as surface */
-  SDL_Surface * p_loaded_texture = IMG_Load(absolute_texture_path);
-  if (p_loaded_texture == NULL)
-  {
-    fprintf(stderr, "\n[SDL_Image] Could not load image '%s' - Error: %s\n", absolute_texture_path, IMG_GetError());
-  }
+  /* Decoded in the background - The completion runs on the GL thread */
+  return asset_loader_load(ASSET_LOADER_ASSET_TYPE_IMAGE, texture_path, completion, p_user_data);
+}
 
-  /* Success */
-  return p_loaded_texture;
+SDL_Surface * texture_loader_texture(int texture_handle)
+{
+  return asset_loader_image(texture_handle);
 }
 
-void texture_loader_destroy_texture(SDL_Surface * p_texture)
+pong_bool_te texture_loader_open_raw_texture(const char * p_texture_name_with_extension, struct raw_texture * p_out_texture)
 {
-  SDL_FreeSurface(p_texture);
+  if (p_texture_name_with_extension == NULL)
+    return PONG_FALSE;
+
+  char texture_path[MAX_PATH_LENGTH];
+  snprintf(texture_path, MAX_PATH_LENGTH, "%s/%s", "images", p_texture_name_with_extension);
+
+  /* Pre-decoded - Used in place from the resource pack */
+  const Uint8 * p_packed_texture = NULL;
+  size_t packed_texture_length = 0;
+  if (asset_loader_find_resource(texture_path, &p_packed_texture, &packed_texture_length))
+    return raw_texture_open_memory(p_packed_texture, packed_texture_length, p_out_texture);
+
+  /* Or mapped from the loose file */
+  char * const p_base_path = SDL_GetBasePath();
+  char absolute_texture_path[MAX_PATH_LENGTH];
+  snprintf(absolute_texture_path, MAX_PATH_LENGTH, "%s../resources/%s", p_base_path ? p_base_path : "", texture_path);
+  SDL_free(p_base_path);
+  return raw_texture_open(absolute_texture_path, p_out_texture);
 }
 
-void texture_loader_cleanup(void)
+void texture_loader_destroy_texture(int texture_handle)
 {
-  IMG_Quit();
+  asset_loader_release(texture_handle);
 }
@@ -3,29 +3,76 @@
 #include <SDL2/SDL_opengl.h>
 #include <GL/glu.h>
 #include <batcher.h>
+#include <post_process.h>
+#include <frame_governor.h>
+#include <frame_capture.h>
 #include <audio_player.h>
+#include <audio_mixer.h>
+#include <asset_loader.h>
+#include <text_renderer.h>
 #include <window_context.h>
 #include <time.h>
+#include <string.h>
 #include <stdint.h>
 #include <input_mapper.h>
+#include <input_bindings.h>
 #include <gameplay_dependencies.h>
 #include <vec2f.h>
 
 /* Defines */
 #define WINDOW_MAX_TITLE_LENGTH (64)
 #define SCORE_TEXT_MAX_LENGTH (16)
+#define WINDOW_CONTEXT_QUALITY_LEVEL_COUNT (4)
+
+/* Datatypes */
+struct window_context_quality_level {
+  float internal_scale;
+  pong_bool_te scanlines;
+};
 
 /* Constants */
 static const char * WINDOW_CONTEXT_TITLE = "Pong";
 static const int WINDOW_CONTEXT_WIDTH = 800;
 static const int WINDOW_CONTEXT_HEIGHT = 600;
+static const int WINDOW_CONTEXT_CANVAS_WIDTH = 800;
+static const int WINDOW_CONTEXT_CANVAS_HEIGHT = 600;
+static const pong_bool_te WINDOW_CONTEXT_CORE_PROFILE_DEFAULT = PONG_FALSE;
+static const char * WINDOW_CONTEXT_RENDERER_VARIABLE = "PONG_RENDERER";
+static const pong_bool_te WINDOW_CONTEXT_POST_PROCESS = PONG_TRUE;
+static const int WINDOW_CONTEXT_INTERNAL_WIDTH = 800;
+static const int WINDOW_CONTEXT_INTERNAL_HEIGHT = 600;
+static const enum post_process_filter WINDOW_CONTEXT_UPSCALE_FILTER = POST_PROCESS_FILTER_SHARP_BILINEAR;
+static const pong_bool_te WINDOW_CONTEXT_SCANLINES = PONG_FALSE;
+static const pong_bool_te WINDOW_CONTEXT_FRAME_GOVERNOR = PONG_TRUE;
+static const double WINDOW_CONTEXT_DEFAULT_REFRESH_RATE = 60.0;
+static const pong_bool_te WINDOW_CONTEXT_FRAME_CAPTURE = PONG_TRUE;
+static const enum frame_capture_format WINDOW_CONTEXT_CAPTURE_FORMAT = FRAME_CAPTURE_FORMAT_Y4M;
+static const char * WINDOW_CONTEXT_CAPTURE_PATH_PREFIX = "pong_capture";
+
+/* Quality levels the frame governor steps through - Effects go first, then internal resolution
+   Levels that differ only in a disabled effect are dropped when the table is built */
+static const struct window_context_quality_level WINDOW_CONTEXT_QUALITY_LEVELS[WINDOW_CONTEXT_QUALITY_LEVEL_COUNT] = {
+  { 1.0f, PONG_TRUE },
+  { 1.0f, PONG_FALSE },
+  { 0.75f, PONG_FALSE },
+  { 0.5f, PONG_FALSE }
+};
+static const pong_bool_te WINDOW_CONTEXT_AUDIO_OFFLINE = PONG_FALSE;
+static const char * WINDOW_CONTEXT_INPUT_BINDINGS_FILENAME = "input_bindings.cfg";
 
 /* Private state */
 static SDL_Window * p_window = NULL;
 static SDL_Surface * p_surface = NULL;
 static SDL_GLContext * p_opengl_context = NULL;
+static pong_bool_te renderer_core_profile = PONG_FALSE;
+static pong_bool_te frame_governor_enabled = PONG_FALSE;
+static struct window_context_quality_level quality_levels[WINDOW_CONTEXT_QUALITY_LEVEL_COUNT];
+static int quality_level_count = 0;
 pong_bool_te window_close_requested = PONG_FALSE;
 static struct input_mapper_instance input_mapper;
+static int output_window_width = 0;
+static int output_window_height = 0;
+static int output_viewport[4] = { 0, 0, 0, 0 };
 struct gameplay_dependencies_batcher dependency_batcher;
 struct gameplay_dependencies_audio dependency_audio;
 struct gameplay_dependencies_input dependency_input;
@@ -72,6 +119,16 @@ static pong_bool_te input_mapper_released_wrapper(enum input_mapper_key_type cus
   return input_mapper_custom_key_state_released(&input_mapper, custom_key_type);
 }
 
+static float input_mapper_held_fraction_wrapper(enum input_mapper_key_type custom_key_type)
+{
+  return input_mapper_custom_key_held_fraction(&input_mapper, custom_key_type);
+}
+
+static float input_mapper_amount_wrapper(enum input_mapper_key_type custom_key_type)
+{
+  return input_mapper_custom_key_amount(&input_mapper, custom_key_type);
+}
+
 /* Windowing dependency hook functions */
 static void hook_close_request(void)
 {
@@ -170,18 +227,94 @@ static void hook_window_set_display_mode(const SDL_DisplayMode * p_chosen_displa
 
 static void update_viewport_an_projection(int new_width, int new_height)
 {
-  /* Set projection and viewport */
-  glMatrixMode(GL_PROJECTION);
-  glLoadIdentity();
-  gluOrtho2D(0, new_width, 0, new_height);
-
-  /* Viewport */
-  glMatrixMode(GL_MODELVIEW);
-  glLoadIdentity();
-  glViewport(0, 0, new_width, new_height);
+  /* Projection always spans the virtual canvas - Gameplay never sees the window size */
+  if (!renderer_core_profile)
+  {
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    gluOrtho2D(0, WINDOW_CONTEXT_CANVAS_WIDTH, 0, WINDOW_CONTEXT_CANVAS_HEIGHT);
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+  }
+  batcher_canvas(WINDOW_CONTEXT_CANVAS_WIDTH, WINDOW_CONTEXT_CANVAS_HEIGHT);
+
+  /* Viewport - Canvas scaled uniformly to fit and centered, the remaining window shows the clear color */
+  const float canvas_scale = SDL_min(
+    (float)new_width / (float)WINDOW_CONTEXT_CANVAS_WIDTH,
+    (float)new_height / (float)WINDOW_CONTEXT_CANVAS_HEIGHT
+  );
+  const int viewport_width = (int)(WINDOW_CONTEXT_CANVAS_WIDTH * canvas_scale + 0.5f);
+  const int viewport_height = (int)(WINDOW_CONTEXT_CANVAS_HEIGHT * canvas_scale + 0.5f);
+  output_window_width = new_width;
+  output_window_height = new_height;
+  output_viewport[0] = (new_width - viewport_width) / 2;
+  output_viewport[1] = (new_height - viewport_height) / 2;
+  output_viewport[2] = viewport_width;
+  output_viewport[3] = viewport_height;
+  glViewport(output_viewport[0], output_viewport[1], output_viewport[2], output_viewport[3]);
   glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 }
 
+static void build_quality_levels(void)
+{
+  /* Scanlines only where configured at all - Every level left must change something */
+  quality_level_count = 0;
+  for (int level_index = 0; level_index < WINDOW_CONTEXT_QUALITY_LEVEL_COUNT; level_index++)
+  {
+    const struct window_context_quality_level level = {
+      WINDOW_CONTEXT_QUALITY_LEVELS[level_index].internal_scale,
+      WINDOW_CONTEXT_SCANLINES && WINDOW_CONTEXT_QUALITY_LEVELS[level_index].scanlines
+    };
+    const struct window_context_quality_level * const p_previous = quality_levels + quality_level_count - 1;
+    if (quality_level_count > 0 && p_previous->internal_scale == level.internal_scale && p_previous->scanlines == level.scanlines)
+      continue;
+
+    quality_levels[quality_level_count++] = level;
+  }
+}
+
+static pong_bool_te apply_quality_level(int quality_level)
+{
+  const struct window_context_quality_level * const p_level = quality_levels + quality_level;
+  const int internal_width = (int)(WINDOW_CONTEXT_INTERNAL_WIDTH * p_level->internal_scale + 0.5f);
+  const int internal_height = (int)(WINDOW_CONTEXT_INTERNAL_HEIGHT * p_level->internal_scale + 0.5f);
+
+  /* Same internal resolution - Keep the frame and only switch the effects */
+  if (post_process_active())
+  {
+    int frame_width;
+    int frame_height;
+    post_process_frame_size(&frame_width, &frame_height);
+    if (frame_width == internal_width && frame_height == internal_height)
+    {
+      post_process_set_scanlines(p_level->scanlines);
+      return PONG_TRUE;
+    }
+  }
+
+  /* Re-create the internal resolution frame */
+  return post_process_initialize(
+    internal_width,
+    internal_height,
+    WINDOW_CONTEXT_UPSCALE_FILTER,
+    p_level->scanlines,
+    renderer_core_profile
+  );
+}
+
+static void process_window_event(const SDL_Event * p_event)
+{
+  /* Closing the window */
+  if (p_event->type == SDL_QUIT)
+    window_close_requested = PONG_TRUE;
+
+  /* Re-sizing */
+  if (p_event->type == SDL_WINDOWEVENT && p_event->window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+  {
+    update_viewport_an_projection(p_event->window.data1, p_event->window.data2);
+  }
+}
+
 /* Function prototypes */
 pong_bool_te window_context_initialize(window_context_initialize_tf p_callback_initialize)
 {
@@ -191,15 +324,53 @@ pong_bool_te window_context_initialize(window_context_initialize_tf p_callback_i
   p_opengl_context = NULL;
 
   /* Initialize SDL subsystems */
-  if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER | SDL_INIT_AUDIO) < 0)
+  if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER | SDL_INIT_AUDIO | SDL_INIT_GAMECONTROLLER) < 0)
   {
     fprintf(stderr, "\n[SDL] Could not initialize subsystems - Error: %s\n", SDL_GetError());
     return PONG_FALSE;
   }
 
-  /* Specify SDL OpenGL window context attributes for window creation */
-  SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
-  SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
+  /* Queue the startup assets first - They decode on the loader workers while the window and GL context are created */
+  if (asset_loader_initialize() == PONG_FALSE)
+  {
+    fprintf(stderr, "\n[Pong] Could not initialize the asset loader");
+    return PONG_FALSE;
+  }
+
+  if (text_renderer_initialize() == PONG_FALSE)
+  {
+    fprintf(stderr, "\n[Pong] Could not request the text renderer assets");
+    return PONG_FALSE;
+  }
+
+  /* Initialize audio player */
+  if (audio_player_initialize(WINDOW_CONTEXT_AUDIO_OFFLINE) == PONG_FALSE)
+  {
+    fprintf(stderr, "\n[Pong] Could not initialize the audio player");
+    return PONG_FALSE;
+  }
+
+  /* Specify SDL OpenGL window context attributes for window creation - Core profile renderer or fixed function */
+  renderer_core_profile = WINDOW_CONTEXT_CORE_PROFILE_DEFAULT;
+  const char * const p_renderer = SDL_getenv(WINDOW_CONTEXT_RENDERER_VARIABLE);
+  if (p_renderer != NULL && strcmp(p_renderer, "core") == 0)
+    renderer_core_profile = PONG_TRUE;
+  else if (p_renderer != NULL && strcmp(p_renderer, "legacy") == 0)
+    renderer_core_profile = PONG_FALSE;
+  else if (p_renderer != NULL && p_renderer[0] != '\0')
+    fprintf(stderr, "\n[Pong] Unknown renderer '%s' in %s - Expected core or legacy", p_renderer, WINDOW_CONTEXT_RENDERER_VARIABLE);
+  if (renderer_core_profile)
+  {
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, SDL_GL_CONTEXT_FORWARD_COMPATIBLE_FLAG);
+  }
+  else
+  {
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
+  }
 
   /* Create the SDL rendering window */
   p_window = SDL_CreateWindow(
@@ -219,11 +390,28 @@ pong_bool_te window_context_initialize(window_context_initialize_tf p_callback_i
 
   /* Create OpenGL context for created window */
   p_opengl_context = SDL_GL_CreateContext(p_window);
+  if (p_opengl_context == NULL && renderer_core_profile)
+  {
+    /* No core profile - Retry with the fixed function context */
+    fprintf(stderr, "\n[SDL] Could not create a core profile context - Error: %s", SDL_GetError());
+    renderer_core_profile = PONG_FALSE;
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 1);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, 0);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, 0);
+    p_opengl_context = SDL_GL_CreateContext(p_window);
+  }
   if (p_opengl_context == NULL)
   {
     fprintf(stderr, "\n[SDL] Could not attribute OpenGL context to window - Error: %s\n", SDL_GetError());
     return PONG_FALSE;
   }
+  printf(
+    "\n[Pong] %s renderer - OpenGL %s - %s",
+    renderer_core_profile ? "GL 3.3 core profile" : "GL 2.1 fixed function",
+    glGetString(GL_VERSION),
+    glGetString(GL_RENDERER)
+  );
 
   /* Configure display sync option - TODO-GS: The call is correct, just not working under Ubuntu? */
   const int SDL_SYNC_NONE = 0;
@@ -235,32 +423,50 @@ pong_bool_te window_context_initialize(window_context_initialize_tf p_callback_i
   }
 
   /* Initialize OpenGL state */
-  glMatrixMode(GL_PROJECTION);
-  glLoadIdentity();
-  gluOrtho2D(0, WINDOW_CONTEXT_WIDTH, 0, WINDOW_CONTEXT_HEIGHT);
-
-  glMatrixMode(GL_MODELVIEW);
-  glLoadIdentity();
-
-  glViewport(0, 0, WINDOW_CONTEXT_WIDTH, WINDOW_CONTEXT_HEIGHT);
+  int window_width;
+  int window_height;
+  SDL_GetWindowSize(p_window, &window_width, &window_height);
+  update_viewport_an_projection(window_width, window_height);
   glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
   log_opengl_error("\nInitialization");
 
   /* Initialize batch renderer */
-  if (batcher_initialize() == PONG_FALSE)
+  if (batcher_initialize(renderer_core_profile) == PONG_FALSE)
   {
     fprintf(stderr, "\n[Pong] Could not initialize the batch renderer");
     return PONG_FALSE;
   }
 
-  /* Initialize audio player */
-  if (audio_player_initialize() == PONG_FALSE)
+  /* Render at a fixed internal resolution and upscale - Falls back to rendering at the window resolution */
+  if (WINDOW_CONTEXT_POST_PROCESS)
   {
-    fprintf(stderr, "\n[Pong] Could not initialize the audio player");
-    return PONG_FALSE;
+    build_quality_levels();
+    apply_quality_level(0);
+    log_opengl_error("\nPost process initialization");
+  }
+
+  /* Display refresh rate - Paces the frame governor and recorded videos */
+  SDL_DisplayMode display_mode;
+  const double refresh_rate = (SDL_GetWindowDisplayMode(p_window, &display_mode) == 0 && display_mode.refresh_rate > 0)
+    ? (double)display_mode.refresh_rate
+    : WINDOW_CONTEXT_DEFAULT_REFRESH_RATE;
+
+  /* Hold the display refresh interval by trading quality - Needs the internal resolution frame to scale */
+  frame_governor_enabled = WINDOW_CONTEXT_FRAME_GOVERNOR && post_process_active();
+  if (frame_governor_enabled)
+  {
+    frame_governor_initialize(
+      1000.0 / refresh_rate,
+      quality_level_count,
+      renderer_core_profile || SDL_GL_ExtensionSupported("GL_ARB_timer_query")
+    );
   }
 
+  /* Recording is toggled at runtime - Frames are written at the refresh rate they are rendered at */
+  if (WINDOW_CONTEXT_FRAME_CAPTURE && !frame_capture_initialize(WINDOW_CONTEXT_CAPTURE_FORMAT, WINDOW_CONTEXT_CAPTURE_PATH_PREFIX, (int)(refresh_rate + 0.5)))
+    fprintf(stderr, "\n[Pong] Could not initialize frame capture - Recording unavailable");
+
   /* Create input mapper */
   if (input_mapper_create(&input_mapper) == PONG_FALSE)
   {
@@ -268,6 +474,10 @@ pong_bool_te window_context_initialize(window_context_initialize_tf p_callback_i
     return PONG_FALSE;
   }
 
+  /* Bindings from the config - The built-in ones remain on failure */
+  if (!input_bindings_load(&input_mapper, WINDOW_CONTEXT_INPUT_BINDINGS_FILENAME))
+    fprintf(stderr, "\n[Pong] Could not load the input bindings - Using the defaults");
+
 	/* Set random time seed */
   srand(time(NULL));
 
@@ -276,19 +486,35 @@ pong_bool_te window_context_initialize(window_context_initialize_tf p_callback_i
   dependency_batcher.color = batcher_color;
   dependency_batcher.text = batcher_text;
   dependency_batcher.quadf = batcher_quadf;
+  dependency_batcher.sprite = batcher_sprite;
+  dependency_batcher.particles = batcher_particles;
   dependency_batcher.text_region = batcher_text_region;
+  dependency_batcher.block_create = batcher_block_create;
+  dependency_batcher.block_destroy = batcher_block_destroy;
+  dependency_batcher.block_record_begin = batcher_block_record_begin;
+  dependency_batcher.block_record_end = batcher_block_record_end;
+  dependency_batcher.block_emit = batcher_block_emit;
+  dependency_batcher.block_invalidate = batcher_block_invalidate;
+  dependency_batcher.backdrop_capture = batcher_backdrop_capture;
+  dependency_batcher.backdrop = batcher_backdrop;
+  dependency_batcher.backdrop_invalidate = batcher_backdrop_invalidate;
 
   /* Audio player */
   dependency_audio.play_sound_effect = audio_player_play_sound_effect;
+  dependency_audio.play_music = audio_player_play_music;
+  dependency_audio.stop_music = audio_player_stop_music;
 
   /* Input */
   dependency_input.key_none = input_mapper_none_wrapper;
   dependency_input.key_pressed = input_mapper_pressed_wrapper;
   dependency_input.key_held = input_mapper_held_wrapper;
   dependency_input.key_released = input_mapper_released_wrapper;
+  dependency_input.key_held_fraction = input_mapper_held_fraction_wrapper;
+  dependency_input.key_amount = input_mapper_amount_wrapper;
 
-  /* Windowing related */
-  SDL_GetWindowSize(p_window, &dependency_windowing.window_width, &dependency_windowing.window_height);
+  /* Windowing related - Screens lay out and simulate on the fixed canvas */
+  dependency_windowing.window_width = WINDOW_CONTEXT_CANVAS_WIDTH;
+  dependency_windowing.window_height = WINDOW_CONTEXT_CANVAS_HEIGHT;
   dependency_windowing.hook_close_window = hook_close_request;
   dependency_windowing.hook_window_is_fullscreen = hook_window_is_fullscreen;
   dependency_windowing.hook_window_set_fullscreen = hook_window_set_fullscreen; 
@@ -331,35 +557,98 @@ pong_bool_te window_context_run(window_context_gameplay_tick_tf p_callback_tick)
       );
       SDL_SetWindowTitle(p_window, fps_window_title);
 
+      /* Report the input to simulation latency over the last second */
+      const struct input_mapper_latency input_latency = input_mapper_take_latency(&input_mapper);
+      if (input_latency.samples > 0)
+      {
+        printf(
+          "\n[Pong] Input latency - Average %.2f ms - Max %u ms - Samples %d",
+          (double)input_latency.sum / (double)input_latency.samples,
+          input_latency.max,
+          input_latency.samples
+        );
+      }
+
+      /* Report the sound effect request to playback latency over the last second */
+      const struct audio_mixer_latency audio_latency = audio_mixer_take_latency();
+      if (audio_latency.samples > 0)
+      {
+        printf(
+          "\n[Pong] Audio latency - Average %.2f ms - Max %.2f ms - Samples %d",
+          audio_latency.sum_in_milliseconds / (double)audio_latency.samples,
+          audio_latency.max_in_milliseconds,
+          audio_latency.samples
+        );
+      }
+
+      /* Report how sound effects were fitted into the voice pool */
+      const struct audio_mixer_voice_stats voice_stats = audio_mixer_take_voice_stats();
+      if (voice_stats.merged > 0 || voice_stats.stolen > 0 || voice_stats.dropped > 0)
+      {
+        printf(
+          "\n[Pong] Audio voices - Started %d - Merged %d - Stolen %d - Dropped %d",
+          voice_stats.started,
+          voice_stats.merged,
+          voice_stats.stolen,
+          voice_stats.dropped
+        );
+      }
+
+      /* Report what recording cost the game loop over the last second */
+      const struct frame_capture_stats capture_stats = frame_capture_take_stats();
+      if (capture_stats.frames > 0 || capture_stats.dropped > 0)
+      {
+        printf(
+          "\n[Pong] Frame capture - Average %.3f ms - Max %.3f ms - Frames %d - Dropped %d",
+          (capture_stats.frames > 0) ? capture_stats.sum_in_milliseconds / (double)capture_stats.frames : 0.0,
+          capture_stats.max_in_milliseconds,
+          capture_stats.frames,
+          capture_stats.dropped
+        );
+      }
+
       /* Reset counter */
       list_time_in_seconds_for_fps_counter = new_time_in_seconds;
       frames_per_second = 0;
     }
     frames_per_second++;
 
+    /* Finish assets decoded in the background - Completions run here on the GL thread */
+    asset_loader_poll();
+
     /* Process input */
     SDL_Event event;
     while (SDL_PollEvent(&event))
     {
-      /* Closing the window */
-      if (event.type == SDL_QUIT)
-        window_close_requested = PONG_TRUE;
+      process_window_event(&event);
 
-      /* Re-sizing */
-      if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
-      {
-        update_viewport_an_projection(event.window.data1, event.window.data2);
-      }
+      /* Keys held while the window was unfocused produce no events */
+      if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_FOCUS_GAINED)
+        input_mapper_sync_keyboard_state(&input_mapper, SDL_GetKeyboardState(NULL), event.window.timestamp);
+
+      /* Timestamped key and game controller input */
+      input_mapper_process_event(&input_mapper, &event);
     }
 
-    /* Determine intermediate input state for all required keyboard keys */
-    const uint8_t * p_keyboard_state = SDL_GetKeyboardState(NULL);
-    input_mapper_set_intermediate_state(&input_mapper, p_keyboard_state);
+    /* Determine intermediate input state for all required keyboard keys up to now */
+    input_mapper_set_intermediate_state(&input_mapper, SDL_GetTicks());
 
     /* Dev close the window using escape */
     if (input_mapper_custom_key_state_pressed(&input_mapper, INPUT_MAPPER_KEY_TYPE_QUIT_APPLICATION))
       window_close_requested = PONG_TRUE;
 
+    /* Dev toggle recording using F3 */
+    if (input_mapper_custom_key_state_pressed(&input_mapper, INPUT_MAPPER_KEY_TYPE_DEV_3))
+    {
+      if (frame_capture_recording())
+        frame_capture_stop();
+      else
+        frame_capture_start();
+    }
+
+    /* Target the internal resolution frame before the tick - Backdrop captures compare against its viewport */
+    post_process_begin();
+
     /* Tick the pong game */
 		const pong_bool_te keep_gameloop_alive = p_callback_tick(
       dts,
@@ -371,10 +660,46 @@ pong_bool_te window_context_run(window_context_gameplay_tick_tf p_callback_tick)
     if (!keep_gameloop_alive)
       break;
 
+    /* Offline audio follows the simulation clock instead of a device */
+    audio_player_advance(dts);
+
     /* Clear buffers and render accumulated batches */
+    if (frame_governor_enabled)
+      frame_governor_gpu_begin();
     glClear(GL_COLOR_BUFFER_BIT);
     batcher_render();
 
+    /* Read the frame back for recording before the upscale - Videos keep the internal resolution */
+    if (post_process_active())
+    {
+      int frame_width, frame_height;
+      post_process_frame_size(&frame_width, &frame_height);
+      frame_capture_read(0, 0, frame_width, frame_height);
+    }
+    else
+      frame_capture_read(output_viewport[0], output_viewport[1], output_viewport[2], output_viewport[3]);
+
+    /* Upscale the internal resolution frame into the letterboxed window viewport */
+    post_process_present(
+      output_window_width,
+      output_window_height,
+      output_viewport[0],
+      output_viewport[1],
+      output_viewport[2],
+      output_viewport[3]
+    );
+
+    /* Trade quality for frame time - Measured up to the swap so waiting on vsync does not count */
+    if (frame_governor_enabled)
+    {
+      frame_governor_gpu_end();
+
+      /* Losing the internal resolution frame leaves nothing to scale */
+      int quality_level;
+      if (frame_governor_frame((time_in_seconds() - new_time_in_seconds) * 1000.0, &quality_level) && !apply_quality_level(quality_level))
+        frame_governor_enabled = PONG_FALSE;
+    }
+
     /* Check OpenGL errors */
     log_opengl_error("\nAfter rendering");
 
@@ -383,8 +708,12 @@ pong_bool_te window_context_run(window_context_gameplay_tick_tf p_callback_tick)
   }
 
   /* Cleanup */
+  frame_capture_cleanup();
+  frame_governor_cleanup();
+  post_process_cleanup();
   batcher_cleanup();
   audio_player_cleanup();
+  asset_loader_cleanup();
   input_mapper_destroy(&input_mapper);
   SDL_DestroyWindow(p_window);
   SDL_Quit();
@@ -0,0 +1,106 @@
+/* Includes */
+#include <audio_bank.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+	Offline audio bank packer - Converts every WAV into the mixer output format and packs them into one bank.
+	Build and run with: make audio_bank
+	Usage: audio_bank_packer <output bank> <input wav>...
+*/
+
+/* Datatypes */
+struct packer_sample {
+	Uint8 * p_samples;
+	Uint32 length;
+};
+
+/* Helpers */
+static const char * base_name(const char * p_path)
+{
+	const char * const p_separator = strrchr(p_path, '/');
+	return (p_separator != NULL) ? p_separator + 1 : p_path;
+}
+
+static Uint32 align_offset(Uint32 offset)
+{
+	return (offset + AUDIO_BANK_ALIGNMENT - 1) & ~(AUDIO_BANK_ALIGNMENT - 1);
+}
+
+int main(int argc, char * argv[])
+{
+	if (argc < 3)
+	{
+		fprintf(stderr, "\nUsage: %s <output bank> <input wav>...\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	const Uint32 entry_count = (Uint32)(argc - 2);
+	struct audio_bank_entry * const p_entries = calloc(entry_count, sizeof(struct audio_bank_entry));
+	struct packer_sample * const p_samples = calloc(entry_count, sizeof(struct packer_sample));
+	if (p_entries == NULL || p_samples == NULL)
+		return EXIT_FAILURE;
+
+	/* Convert every effect and lay them out after the entry table */
+	Uint32 offset = align_offset(sizeof(struct audio_bank_header) + entry_count * sizeof(struct audio_bank_entry));
+	for (Uint32 entry_index = 0; entry_index < entry_count; entry_index++)
+	{
+		const char * const p_path = argv[entry_index + 2];
+		if (strlen(base_name(p_path)) >= AUDIO_BANK_MAX_NAME_LENGTH)
+		{
+			fprintf(stderr, "\n[Audio bank packer] Name too long: %s", base_name(p_path));
+			return EXIT_FAILURE;
+		}
+		if (!audio_bank_load_converted_wav(p_path, &p_samples[entry_index].p_samples, &p_samples[entry_index].length))
+			return EXIT_FAILURE;
+
+		strcpy(p_entries[entry_index].name, base_name(p_path));
+		p_entries[entry_index].offset = offset;
+		p_entries[entry_index].length = p_samples[entry_index].length;
+		offset = align_offset(offset + p_samples[entry_index].length);
+	}
+
+	FILE * const p_file = fopen(argv[1], "wb");
+	if (p_file == NULL)
+	{
+		fprintf(stderr, "\n[Audio bank packer] Could not open output: %s", argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	/* Header and entry table */
+	const struct audio_bank_header header = {
+		AUDIO_BANK_MAGIC,
+		AUDIO_BANK_VERSION,
+		AUDIO_BANK_FREQUENCY,
+		AUDIO_BANK_FORMAT,
+		AUDIO_BANK_CHANNELS,
+		entry_count,
+		0
+	};
+	pong_bool_te written = fwrite(&header, sizeof(header), 1, p_file) == 1;
+	written = written && fwrite(p_entries, sizeof(struct audio_bank_entry), entry_count, p_file) == entry_count;
+
+	/* Aligned sample data */
+	static const Uint8 padding[AUDIO_BANK_ALIGNMENT] = { 0 };
+	for (Uint32 entry_index = 0; entry_index < entry_count && written; entry_index++)
+	{
+		const long padding_length = (long)p_entries[entry_index].offset - ftell(p_file);
+		written = fwrite(padding, 1, (size_t)padding_length, p_file) == (size_t)padding_length;
+		written = written && fwrite(p_samples[entry_index].p_samples, 1, p_samples[entry_index].length, p_file) == p_samples[entry_index].length;
+		printf("\n[Audio bank packer] %-24s %8u bytes at offset %8u", p_entries[entry_index].name, p_entries[entry_index].length, p_entries[entry_index].offset);
+	}
+
+	if (fclose(p_file) != 0 || !written)
+	{
+		fprintf(stderr, "\n[Audio bank packer] Could not write: %s", argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	printf("\n[Audio bank packer] Wrote %u effects to %s\n", entry_count, argv[1]);
+	for (Uint32 entry_index = 0; entry_index < entry_count; entry_index++)
+		free(p_samples[entry_index].p_samples);
+	free(p_samples);
+	free(p_entries);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,184 @@
+/* Includes */
+#include <audio_mixer.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+  Offline mixer regression and throughput benchmark - Needs no audio device.
+  The scripted match is rendered at the simulation rate and checksummed,
+  pass the expected checksum to fail on any change in the mixed output.
+  Build and run with: make bench_audio_mixer
+*/
+
+/* Defines */
+#define BENCH_TICKS_PER_SECOND (60)
+#define BENCH_MATCH_SECONDS (120)
+#define BENCH_STRESS_SECONDS (60)
+#define BENCH_BUFFER_FRAMES (256)
+#define BENCH_RENDER_FRAMES (4096)
+
+/* Datatypes */
+enum bench_sound_type {
+	BENCH_SOUND_TYPE_HIT,
+	BENCH_SOUND_TYPE_SCORE,
+	BENCH_SOUND_TYPE_MENU,
+	BENCH_SOUND_TYPE_STRESS,
+	BENCH_SOUND_TYPE_COUNT
+};
+
+/* Private state */
+static Sint16 * p_sound_samples[BENCH_SOUND_TYPE_COUNT];
+static struct audio_mixer_sound sounds[BENCH_SOUND_TYPE_COUNT];
+static struct audio_mixer_sound stress_sounds[AUDIO_MIXER_MAX_VOICES];
+static Sint16 render_output[BENCH_RENDER_FRAMES * AUDIO_MIXER_CHANNELS];
+
+/* Private helper functions */
+static double seconds_since(Uint64 start_counter)
+{
+	return (double)(SDL_GetPerformanceCounter() - start_counter) / (double)SDL_GetPerformanceFrequency();
+}
+
+static pong_bool_te make_sound
+(
+	enum bench_sound_type sound_type,
+	Uint32 frame_count,
+	int period_frames,
+	int max_instances,
+	enum audio_mixer_priority priority
+)
+{
+	Sint16 * const p_samples = malloc(sizeof(Sint16) * frame_count * AUDIO_MIXER_CHANNELS);
+	if (p_samples == NULL)
+		return PONG_FALSE;
+
+	/* Integer triangle wave with a linear decay - Identical on every platform */
+	for (Uint32 frame_index = 0; frame_index < frame_count; frame_index++)
+	{
+		const int phase = (int)(frame_index % (Uint32)period_frames);
+		const int triangle = (phase < period_frames / 2) ? phase : period_frames - phase;
+		const int amplitude = (int)(((Sint64)12000 * (frame_count - frame_index)) / frame_count);
+		const int sample = ((triangle * 4 - period_frames) * amplitude) / period_frames;
+		p_samples[frame_index * AUDIO_MIXER_CHANNELS] = (Sint16)sample;
+		p_samples[frame_index * AUDIO_MIXER_CHANNELS + 1] = (Sint16)(-sample / 2);
+	}
+
+	p_sound_samples[sound_type] = p_samples;
+	sounds[sound_type] = (struct audio_mixer_sound){ p_samples, frame_count, max_instances, priority };
+	return PONG_TRUE;
+}
+
+static Uint64 render(double dt, Uint64 checksum, Uint64 * p_rendered_frames)
+{
+	int rendered_frames;
+	while ((rendered_frames = audio_mixer_render(dt, render_output, BENCH_RENDER_FRAMES)) > 0)
+	{
+		checksum = audio_mixer_checksum(checksum, render_output, rendered_frames * AUDIO_MIXER_CHANNELS);
+		*p_rendered_frames += rendered_frames;
+		dt = 0.0;
+	}
+
+	return checksum;
+}
+
+static Uint64 run_match(void)
+{
+	const double dt = 1.0 / BENCH_TICKS_PER_SECOND;
+	Uint64 checksum = AUDIO_MIXER_CHECKSUM_SEED;
+	Uint64 rendered_frames = 0;
+
+	/* Scripted events per simulation tick - Rallies speed up, some ticks bounce the ball several times */
+	for (int tick = 0; tick < BENCH_MATCH_SECONDS * BENCH_TICKS_PER_SECOND; tick++)
+	{
+		const int rally_tick = tick % (10 * BENCH_TICKS_PER_SECOND);
+		const int hit_interval = 30 - rally_tick / 30;
+		if (rally_tick > 0 && rally_tick % hit_interval == 0)
+		{
+			const float pan = ((tick / hit_interval) % 2) ? -0.8f : 0.8f;
+			const int bounces = (tick % 7 == 0) ? 5 : 1;
+			for (int bounce = 0; bounce < bounces; bounce++)
+				audio_mixer_play(sounds + BENCH_SOUND_TYPE_HIT, 1.0f, pan);
+		}
+		if (rally_tick == 0 && tick > 0)
+			audio_mixer_play(sounds + BENCH_SOUND_TYPE_SCORE, 0.8f, 0.0f);
+		if (tick % 97 == 0)
+			audio_mixer_play(sounds + BENCH_SOUND_TYPE_MENU, 0.5f, 0.0f);
+
+		checksum = render(dt, checksum, &rendered_frames);
+	}
+
+	const struct audio_mixer_voice_stats voice_stats = audio_mixer_take_voice_stats();
+	printf(
+		"\n[Audio mixer bench] Match of %d s - %llu frames - Started %d - Merged %d - Stolen %d - Dropped %d",
+		BENCH_MATCH_SECONDS,
+		(unsigned long long)rendered_frames,
+		voice_stats.started,
+		voice_stats.merged,
+		voice_stats.stolen,
+		voice_stats.dropped
+	);
+	return checksum;
+}
+
+static void run_stress(void)
+{
+	/* Keep every voice busy for the whole run - Separate sounds so the requests are not merged */
+	for (int voice_index = 0; voice_index < AUDIO_MIXER_MAX_VOICES; voice_index++)
+	{
+		stress_sounds[voice_index] = sounds[BENCH_SOUND_TYPE_STRESS];
+		audio_mixer_play(stress_sounds + voice_index, 0.05f, (float)voice_index / AUDIO_MIXER_MAX_VOICES * 2.0f - 1.0f);
+	}
+
+	Uint64 rendered_frames = 0;
+	const Uint64 start_counter = SDL_GetPerformanceCounter();
+	const Uint64 checksum = render(BENCH_STRESS_SECONDS, AUDIO_MIXER_CHECKSUM_SEED, &rendered_frames);
+	const double elapsed_in_seconds = seconds_since(start_counter);
+
+	/* One voice buffer is one voice mixed over one device buffer */
+	const double voice_buffers = (double)rendered_frames / BENCH_BUFFER_FRAMES * AUDIO_MIXER_MAX_VOICES;
+	printf(
+		"\n[Audio mixer bench] Stress of %d voices for %d s - %.2f ms - %.1f voice buffers per ms - %.0fx realtime - Checksum %016llx",
+		AUDIO_MIXER_MAX_VOICES,
+		BENCH_STRESS_SECONDS,
+		elapsed_in_seconds * 1000.0,
+		voice_buffers / (elapsed_in_seconds * 1000.0),
+		BENCH_STRESS_SECONDS / elapsed_in_seconds,
+		(unsigned long long)checksum
+	);
+}
+
+int main(int argc, char * argv[])
+{
+	if (
+		!make_sound(BENCH_SOUND_TYPE_HIT, AUDIO_MIXER_FREQUENCY / 8, 100, 4, AUDIO_MIXER_PRIORITY_LOW) ||
+		!make_sound(BENCH_SOUND_TYPE_SCORE, AUDIO_MIXER_FREQUENCY, 220, 1, AUDIO_MIXER_PRIORITY_HIGH) ||
+		!make_sound(BENCH_SOUND_TYPE_MENU, AUDIO_MIXER_FREQUENCY / 4, 150, 2, AUDIO_MIXER_PRIORITY_NORMAL) ||
+		!make_sound(BENCH_SOUND_TYPE_STRESS, AUDIO_MIXER_FREQUENCY * BENCH_STRESS_SECONDS, 150, 0, AUDIO_MIXER_PRIORITY_NORMAL)
+	)
+		return EXIT_FAILURE;
+
+	/* Reproducible match render */
+	if (!audio_mixer_open_offline(BENCH_BUFFER_FRAMES))
+		return EXIT_FAILURE;
+	const Uint64 match_checksum = run_match();
+	audio_mixer_close();
+	printf("\n[Audio mixer bench] Match checksum %016llx", (unsigned long long)match_checksum);
+
+	/* Throughput with every voice active */
+	if (!audio_mixer_open_offline(BENCH_BUFFER_FRAMES))
+		return EXIT_FAILURE;
+	run_stress();
+	audio_mixer_close();
+	printf("\n");
+
+	for (int sound_type = 0; sound_type < BENCH_SOUND_TYPE_COUNT; sound_type++)
+		free(p_sound_samples[sound_type]);
+
+	/* Regression check against a known good render */
+	if (argc > 1 && strtoull(argv[1], NULL, 16) != match_checksum)
+	{
+		fprintf(stderr, "\n[Audio mixer bench] Match checksum differs from expected %s\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,186 @@
+/* Includes */
+#include <input_mapper.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+  Microbenchmark of the packed key masks against the previous per-key state array.
+  Build and run with: make bench_input_mapper
+*/
+
+/* Defines */
+#define BENCH_TICKS (200000)
+#define BENCH_QUERIES_PER_TICK (64)
+
+/* Baseline - Per-key state enum array behind bounds checked queries */
+enum baseline_key_state {
+	BASELINE_KEY_STATE_NONE,
+	BASELINE_KEY_STATE_PRESSED,
+	BASELINE_KEY_STATE_HELD,
+	BASELINE_KEY_STATE_RELEASED
+};
+
+struct baseline_key_mapping {
+	enum input_mapper_key_type custom_key_type;
+	SDL_Scancode associated_scancode;
+	pong_bool_te usable;
+};
+
+struct baseline_instance {
+	struct baseline_key_mapping * p_mappings;
+	enum baseline_key_state * p_states;
+};
+
+static struct baseline_instance baseline;
+static struct input_mapper_instance packed;
+
+static pong_bool_te baseline_custom_key_in_state(enum input_mapper_key_type custom_key_type, enum baseline_key_state requested_state)
+{
+	if (baseline.p_mappings == NULL || baseline.p_states == NULL)
+		return PONG_FALSE;
+	if (custom_key_type < 0 || custom_key_type >= INPUT_MAPPER_KEY_TYPE_COUNT)
+		return PONG_FALSE;
+
+	return (baseline.p_states[custom_key_type] == requested_state) ? PONG_TRUE : PONG_FALSE;
+}
+
+static pong_bool_te baseline_pressed(enum input_mapper_key_type custom_key_type)
+{
+	return baseline_custom_key_in_state(custom_key_type, BASELINE_KEY_STATE_PRESSED);
+}
+
+static pong_bool_te baseline_held(enum input_mapper_key_type custom_key_type)
+{
+	return baseline_custom_key_in_state(custom_key_type, BASELINE_KEY_STATE_HELD);
+}
+
+static void baseline_gather(const Uint8 * p_keyboard_state)
+{
+	for (int mapping_index = 0; mapping_index < INPUT_MAPPER_KEY_TYPE_COUNT; mapping_index++)
+	{
+		const struct baseline_key_mapping * const p_mapping = baseline.p_mappings + mapping_index;
+		if (!p_mapping->usable)
+			continue;
+
+		enum baseline_key_state * const p_state = baseline.p_states + p_mapping->custom_key_type;
+		if (p_keyboard_state[p_mapping->associated_scancode])
+		{
+			if (*p_state == BASELINE_KEY_STATE_NONE || *p_state == BASELINE_KEY_STATE_RELEASED)
+				*p_state = BASELINE_KEY_STATE_PRESSED;
+			else
+				*p_state = BASELINE_KEY_STATE_HELD;
+		}
+		else
+		{
+			if (*p_state == BASELINE_KEY_STATE_PRESSED || *p_state == BASELINE_KEY_STATE_HELD)
+				*p_state = BASELINE_KEY_STATE_RELEASED;
+			else
+				*p_state = BASELINE_KEY_STATE_NONE;
+		}
+	}
+}
+
+/* Packed - The game reaches the queries through the same kind of function pointers */
+static pong_bool_te packed_pressed(enum input_mapper_key_type custom_key_type)
+{
+	return input_mapper_custom_key_state_pressed(&packed, custom_key_type);
+}
+
+static pong_bool_te packed_held(enum input_mapper_key_type custom_key_type)
+{
+	return input_mapper_custom_key_state_held(&packed, custom_key_type);
+}
+
+static void packed_gather(const Uint8 * p_keyboard_state)
+{
+	/* Same tick update as the event path minus the transition buffers */
+	packed.keys_down = input_mapper_gather_keyboard_state(&packed, p_keyboard_state);
+	packed.keys_previous = packed.keys_current;
+	packed.keys_current = packed.keys_down;
+	packed.keys_pressed = packed.keys_current & ~packed.keys_previous;
+}
+
+/* Helpers */
+static double counter_to_nanoseconds(Uint64 counter_delta)
+{
+	return ((double)counter_delta * 1000000000.0) / (double)SDL_GetPerformanceFrequency();
+}
+
+static void fill_keyboard_state(Uint8 * p_keyboard_state, int tick)
+{
+	/* Toggle every mapped key with a different period */
+	for (int custom_key_type = 0; custom_key_type < INPUT_MAPPER_KEY_TYPE_COUNT; custom_key_type++)
+		p_keyboard_state[packed.bindings[custom_key_type][0].code] = ((tick >> (custom_key_type % 5)) & 1) ? 1 : 0;
+}
+
+static void run
+(
+	const char * p_name,
+	void (* p_gather)(const Uint8 *),
+	pong_bool_te (* volatile p_pressed)(enum input_mapper_key_type),
+	pong_bool_te (* volatile p_held)(enum input_mapper_key_type),
+	Uint8 keyboard_states[][SDL_NUM_SCANCODES]
+)
+{
+	Uint64 gather_counter = 0;
+	Uint64 query_counter = 0;
+	unsigned int checksum = 0;
+
+	for (int tick = 0; tick < BENCH_TICKS; tick++)
+	{
+		const Uint64 gather_start = SDL_GetPerformanceCounter();
+		p_gather(keyboard_states[tick & 15]);
+		const Uint64 query_start = SDL_GetPerformanceCounter();
+		for (int query_index = 0; query_index < BENCH_QUERIES_PER_TICK; query_index++)
+		{
+			const enum input_mapper_key_type custom_key_type = query_index % INPUT_MAPPER_KEY_TYPE_COUNT;
+			checksum = checksum * 31u + p_pressed(custom_key_type) + 2u * p_held(custom_key_type);
+		}
+		const Uint64 query_end = SDL_GetPerformanceCounter();
+
+		gather_counter += query_start - gather_start;
+		query_counter += query_end - query_start;
+	}
+
+	printf(
+		"\n[Input mapper bench] %-8s gather %7.2f ns/tick - query %6.2f ns/query - checksum %08x",
+		p_name,
+		counter_to_nanoseconds(gather_counter) / BENCH_TICKS,
+		counter_to_nanoseconds(query_counter) / ((double)BENCH_TICKS * BENCH_QUERIES_PER_TICK * 2.0),
+		checksum
+	);
+}
+
+int main(int argc, char * argv[])
+{
+	if (!input_mapper_create(&packed))
+		return EXIT_FAILURE;
+
+	/* Mirror the first built-in key binding of every custom key in the baseline layout */
+	baseline.p_mappings = malloc(sizeof(struct baseline_key_mapping) * INPUT_MAPPER_KEY_TYPE_COUNT);
+	baseline.p_states = malloc(sizeof(enum baseline_key_state) * INPUT_MAPPER_KEY_TYPE_COUNT);
+	if (baseline.p_mappings == NULL || baseline.p_states == NULL)
+		return EXIT_FAILURE;
+
+	for (int custom_key_type = 0; custom_key_type < INPUT_MAPPER_KEY_TYPE_COUNT; custom_key_type++)
+	{
+		baseline.p_mappings[custom_key_type].custom_key_type = custom_key_type;
+		baseline.p_mappings[custom_key_type].associated_scancode = packed.bindings[custom_key_type][0].code;
+		baseline.p_mappings[custom_key_type].usable = PONG_TRUE;
+		baseline.p_states[custom_key_type] = BASELINE_KEY_STATE_NONE;
+	}
+
+	/* Pre-built keyboard states so both runs see the same input */
+	static Uint8 keyboard_states[16][SDL_NUM_SCANCODES];
+	for (int tick = 0; tick < 16; tick++)
+		fill_keyboard_state(keyboard_states[tick], tick);
+
+	run("baseline", baseline_gather, baseline_pressed, baseline_held, keyboard_states);
+	run("packed", packed_gather, packed_pressed, packed_held, keyboard_states);
+	printf("\n");
+
+	free(baseline.p_states);
+	free(baseline.p_mappings);
+	input_mapper_destroy(&packed);
+	return EXIT_SUCCESS;
+}
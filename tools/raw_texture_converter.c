@@ -0,0 +1,72 @@
+/* Includes */
+#include <raw_texture.h>
+#include <SDL2/SDL_image.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+	Offline raw texture converter - Decodes an image once and writes its pixels,
+	alpha-only when every visible pixel is white, ready to be uploaded from the mapped file.
+	Build and run with: make raw_textures
+	Usage: raw_texture_converter <input image> <output raw texture>
+*/
+
+int main(int argc, char * argv[])
+{
+	if (argc != 3)
+	{
+		fprintf(stderr, "\nUsage: %s <input image> <output raw texture>\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	SDL_Surface * const p_surface = IMG_Load(argv[1]);
+	if (p_surface == NULL)
+	{
+		fprintf(stderr, "\n[Raw texture converter] Could not load: %s - Error: %s", argv[1], IMG_GetError());
+		return EXIT_FAILURE;
+	}
+
+	Uint8 * p_data = NULL;
+	size_t length = 0;
+	const pong_bool_te built = raw_texture_build(p_surface, &p_data, &length);
+	const size_t decoded_size = (size_t)p_surface->w * (size_t)p_surface->h * 4;
+	SDL_FreeSurface(p_surface);
+	if (!built)
+		return EXIT_FAILURE;
+
+	FILE * const p_file = fopen(argv[2], "wb");
+	if (p_file == NULL)
+	{
+		fprintf(stderr, "\n[Raw texture converter] Could not open output: %s", argv[2]);
+		free(p_data);
+		return EXIT_FAILURE;
+	}
+
+	const pong_bool_te written = fwrite(p_data, 1, length, p_file) == length;
+	if (fclose(p_file) != 0 || !written)
+	{
+		fprintf(stderr, "\n[Raw texture converter] Could not write: %s", argv[2]);
+		free(p_data);
+		return EXIT_FAILURE;
+	}
+
+	/* Sizes of what ends up on the GPU */
+	struct raw_texture texture;
+	if (raw_texture_open_memory(p_data, length, &texture))
+	{
+		printf(
+			"\n[Raw texture converter] %s: %ux%u %s - %zu bytes - Was %zu bytes RGBA\n",
+			argv[2],
+			texture.p_header->width,
+			texture.p_header->height,
+			(texture.p_header->format == RAW_TEXTURE_FORMAT_ALPHA8) ? "alpha" : "rgba",
+			raw_texture_size(&texture),
+			decoded_size
+		);
+		raw_texture_close(&texture);
+	}
+
+	free(p_data);
+	return EXIT_SUCCESS;
+}
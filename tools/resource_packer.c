@@ -0,0 +1,200 @@
+/* Includes */
+#include <resource_pack.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+/*
+	Offline resource packer - Packs every file below the resource directory into one pack,
+	named by their path relative to it. Excluded subdirectories stay loose files.
+	Build and run with: make resource_pack
+	Usage: resource_packer <output pack> <resource dir> [excluded subdir]...
+*/
+
+/* Defines */
+#define PACKER_MAX_RESOURCES (256)
+#define PACKER_MAX_PATH_LENGTH (512)
+
+/* Datatypes */
+struct packer_resource {
+	char name[RESOURCE_PACK_MAX_NAME_LENGTH];
+	char path[PACKER_MAX_PATH_LENGTH];
+	Uint64 length;
+	Uint32 bucket_index;
+};
+
+/* Private state */
+static struct packer_resource resources[PACKER_MAX_RESOURCES];
+static Uint32 resource_count = 0;
+
+/* Helpers */
+static Uint64 align_offset(Uint64 offset)
+{
+	return (offset + RESOURCE_PACK_ALIGNMENT - 1) & ~(Uint64)(RESOURCE_PACK_ALIGNMENT - 1);
+}
+
+static pong_bool_te excluded(const char * p_name, int excluded_count, char * p_excluded[])
+{
+	for (int excluded_index = 0; excluded_index < excluded_count; excluded_index++)
+	{
+		if (strcmp(p_name, p_excluded[excluded_index]) == 0)
+			return PONG_TRUE;
+	}
+
+	return PONG_FALSE;
+}
+
+static pong_bool_te collect(const char * p_directory, const char * p_prefix, int excluded_count, char * p_excluded[])
+{
+	DIR * const p_dir = opendir(p_directory);
+	if (p_dir == NULL)
+	{
+		fprintf(stderr, "\n[Resource packer] Could not open directory: %s", p_directory);
+		return PONG_FALSE;
+	}
+
+	pong_bool_te collected = PONG_TRUE;
+	struct dirent * p_dir_entry;
+	while (collected && (p_dir_entry = readdir(p_dir)) != NULL)
+	{
+		if (p_dir_entry->d_name[0] == '.')
+			continue;
+
+		char path[PACKER_MAX_PATH_LENGTH];
+		char name[PACKER_MAX_PATH_LENGTH];
+		snprintf(path, PACKER_MAX_PATH_LENGTH, "%s/%s", p_directory, p_dir_entry->d_name);
+		snprintf(name, PACKER_MAX_PATH_LENGTH, "%s%s", p_prefix, p_dir_entry->d_name);
+
+		struct stat file_stat;
+		if (stat(path, &file_stat) != 0)
+		{
+			fprintf(stderr, "\n[Resource packer] Could not stat: %s", path);
+			collected = PONG_FALSE;
+		}
+		else if (S_ISDIR(file_stat.st_mode))
+		{
+			if (excluded(name, excluded_count, p_excluded))
+				continue;
+
+			char prefix[PACKER_MAX_PATH_LENGTH];
+			snprintf(prefix, PACKER_MAX_PATH_LENGTH, "%s/", name);
+			collected = collect(path, prefix, excluded_count, p_excluded);
+		}
+		else if (S_ISREG(file_stat.st_mode))
+		{
+			if (strlen(name) >= RESOURCE_PACK_MAX_NAME_LENGTH || resource_count >= PACKER_MAX_RESOURCES)
+			{
+				fprintf(stderr, "\n[Resource packer] Name too long or too many resources: %s", name);
+				collected = PONG_FALSE;
+				continue;
+			}
+
+			struct packer_resource * const p_resource = resources + resource_count++;
+			strcpy(p_resource->name, name);
+			strcpy(p_resource->path, path);
+			p_resource->length = (Uint64)file_stat.st_size;
+		}
+	}
+
+	closedir(p_dir);
+	return collected;
+}
+
+static pong_bool_te copy_file(const char * p_path, FILE * p_output)
+{
+	FILE * const p_input = fopen(p_path, "rb");
+	if (p_input == NULL)
+		return PONG_FALSE;
+
+	Uint8 buffer[RESOURCE_PACK_ALIGNMENT];
+	size_t read_length;
+	pong_bool_te copied = PONG_TRUE;
+	while (copied && (read_length = fread(buffer, 1, sizeof(buffer), p_input)) > 0)
+		copied = fwrite(buffer, 1, read_length, p_output) == read_length;
+
+	copied = copied && !ferror(p_input);
+	fclose(p_input);
+	return copied;
+}
+
+int main(int argc, char * argv[])
+{
+	if (argc < 3)
+	{
+		fprintf(stderr, "\nUsage: %s <output pack> <resource dir> [excluded subdir]...\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (!collect(argv[2], "", argc - 3, argv + 3))
+		return EXIT_FAILURE;
+
+	/* At most half full so probe sequences stay short */
+	Uint32 bucket_count = 1;
+	while (bucket_count < resource_count * 2 || bucket_count <= resource_count)
+		bucket_count *= 2;
+
+	struct resource_pack_entry * const p_buckets = calloc(bucket_count, sizeof(struct resource_pack_entry));
+	if (p_buckets == NULL)
+		return EXIT_FAILURE;
+
+	/* Lay the resources out after the table of contents */
+	Uint64 offset = align_offset(sizeof(struct resource_pack_header) + (Uint64)bucket_count * sizeof(struct resource_pack_entry));
+	for (Uint32 resource_index = 0; resource_index < resource_count; resource_index++)
+	{
+		struct packer_resource * const p_resource = resources + resource_index;
+		const Uint64 name_hash = resource_pack_hash(p_resource->name);
+
+		Uint32 bucket_index = (Uint32)name_hash & (bucket_count - 1);
+		while (p_buckets[bucket_index].name_hash != RESOURCE_PACK_EMPTY_BUCKET)
+			bucket_index = (bucket_index + 1) & (bucket_count - 1);
+
+		p_resource->bucket_index = bucket_index;
+		struct resource_pack_entry * const p_entry = p_buckets + bucket_index;
+		p_entry->name_hash = name_hash;
+		p_entry->offset = offset;
+		p_entry->length = p_resource->length;
+		strcpy(p_entry->name, p_resource->name);
+		offset = align_offset(offset + p_resource->length);
+	}
+
+	FILE * const p_file = fopen(argv[1], "wb");
+	if (p_file == NULL)
+	{
+		fprintf(stderr, "\n[Resource packer] Could not open output: %s", argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	/* Header and table of contents */
+	const struct resource_pack_header header = {
+		RESOURCE_PACK_MAGIC,
+		RESOURCE_PACK_VERSION,
+		bucket_count,
+		resource_count
+	};
+	pong_bool_te written = fwrite(&header, sizeof(header), 1, p_file) == 1;
+	written = written && fwrite(p_buckets, sizeof(struct resource_pack_entry), bucket_count, p_file) == bucket_count;
+
+	/* Aligned resource data */
+	static const Uint8 padding[RESOURCE_PACK_ALIGNMENT] = { 0 };
+	for (Uint32 resource_index = 0; resource_index < resource_count && written; resource_index++)
+	{
+		const struct packer_resource * const p_resource = resources + resource_index;
+		const struct resource_pack_entry * const p_entry = p_buckets + p_resource->bucket_index;
+		const long padding_length = (long)p_entry->offset - ftell(p_file);
+		written = written && fwrite(padding, 1, (size_t)padding_length, p_file) == (size_t)padding_length;
+		written = written && copy_file(p_resource->path, p_file);
+		printf("\n[Resource packer] %-40s %8llu bytes at offset %8llu", p_entry->name, (unsigned long long)p_entry->length, (unsigned long long)p_entry->offset);
+	}
+
+	if (fclose(p_file) != 0 || !written)
+	{
+		fprintf(stderr, "\n[Resource packer] Could not write: %s", argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	printf("\n[Resource packer] Wrote %u resources in %u buckets to %s\n", resource_count, bucket_count, argv[1]);
+	free(p_buckets);
+	return EXIT_SUCCESS;
+}
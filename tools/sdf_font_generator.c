@@ -0,0 +1,115 @@
+/* Includes */
+#include <raw_texture.h>
+#include <SDL2/SDL_image.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+	Offline signed distance field generator for bitmap glyph sheets - Every sheet pixel becomes
+	SDF_SCALE x SDF_SCALE texels storing the distance to the nearest glyph edge in the alpha channel,
+	0.5 on the edge and above inside. The layout keeps the sheet proportions so glyph texcoords stay valid.
+	Build and run with: make raw_textures
+	Usage: sdf_font_generator <input glyph sheet> <output raw texture>
+*/
+
+/* Defines */
+#define SDF_SCALE (3)
+#define SDF_SPREAD_IN_PIXELS (1.5f)
+
+/* Helpers */
+static pong_bool_te sheet_inside(const SDL_Surface * p_sheet, int x, int y)
+{
+	if (x < 0 || y < 0 || x >= p_sheet->w || y >= p_sheet->h)
+		return PONG_FALSE;
+
+	const Uint8 * const p_pixel = (const Uint8 *)p_sheet->pixels + y * p_sheet->pitch + x * 4;
+	return (p_pixel[3] > 127) ? PONG_TRUE : PONG_FALSE;
+}
+
+static float distance_to_pixel(float point_x, float point_y, int pixel_x, int pixel_y)
+{
+	const float dx = fmaxf(fmaxf(pixel_x - point_x, 0.0f), point_x - (pixel_x + 1));
+	const float dy = fmaxf(fmaxf(pixel_y - point_y, 0.0f), point_y - (pixel_y + 1));
+	return sqrtf(dx * dx + dy * dy);
+}
+
+static Uint8 signed_distance(const SDL_Surface * p_sheet, float point_x, float point_y)
+{
+	/* Nearest sheet pixel of the other kind within the spread - Exact for the square pixels of a bitmap font */
+	const int center_x = (int)point_x;
+	const int center_y = (int)point_y;
+	const pong_bool_te inside = sheet_inside(p_sheet, center_x, center_y);
+	const int search_radius = (int)ceilf(SDF_SPREAD_IN_PIXELS) + 1;
+
+	float nearest = SDF_SPREAD_IN_PIXELS;
+	for (int y = center_y - search_radius; y <= center_y + search_radius; y++)
+	{
+		for (int x = center_x - search_radius; x <= center_x + search_radius; x++)
+		{
+			if (sheet_inside(p_sheet, x, y) != inside)
+				nearest = fminf(nearest, distance_to_pixel(point_x, point_y, x, y));
+		}
+	}
+
+	const float signed_nearest = inside ? nearest : -nearest;
+	const float encoded = 0.5f + signed_nearest / (2.0f * SDF_SPREAD_IN_PIXELS);
+	return (Uint8)lroundf(fminf(fmaxf(encoded, 0.0f), 1.0f) * 255.0f);
+}
+
+int main(int argc, char * argv[])
+{
+	if (argc != 3)
+	{
+		fprintf(stderr, "\nUsage: %s <input glyph sheet> <output raw texture>\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	SDL_Surface * const p_loaded_sheet = IMG_Load(argv[1]);
+	SDL_Surface * const p_sheet = (p_loaded_sheet != NULL) ? SDL_ConvertSurfaceFormat(p_loaded_sheet, SDL_PIXELFORMAT_RGBA32, 0) : NULL;
+	if (p_sheet == NULL)
+	{
+		fprintf(stderr, "\n[SDF font generator] Could not load: %s - Error: %s", argv[1], IMG_GetError());
+		return EXIT_FAILURE;
+	}
+	SDL_FreeSurface(p_loaded_sheet);
+
+	/* White texels with the distance as alpha - Stored alpha-only */
+	SDL_Surface * const p_field = SDL_CreateRGBSurfaceWithFormat(0, p_sheet->w * SDF_SCALE, p_sheet->h * SDF_SCALE, 32, SDL_PIXELFORMAT_RGBA32);
+	if (p_field == NULL)
+		return EXIT_FAILURE;
+
+	for (int y = 0; y < p_field->h; y++)
+	{
+		for (int x = 0; x < p_field->w; x++)
+		{
+			/* Texel center in sheet pixels */
+			Uint8 * const p_texel = (Uint8 *)p_field->pixels + y * p_field->pitch + x * 4;
+			p_texel[0] = p_texel[1] = p_texel[2] = 255;
+			p_texel[3] = signed_distance(p_sheet, (x + 0.5f) / SDF_SCALE, (y + 0.5f) / SDF_SCALE);
+		}
+	}
+	SDL_FreeSurface(p_sheet);
+
+	const int field_width = p_field->w;
+	const int field_height = p_field->h;
+	Uint8 * p_data = NULL;
+	size_t length = 0;
+	const pong_bool_te built = raw_texture_build(p_field, &p_data, &length);
+	SDL_FreeSurface(p_field);
+	if (!built)
+		return EXIT_FAILURE;
+
+	FILE * const p_file = fopen(argv[2], "wb");
+	const pong_bool_te written = p_file != NULL && fwrite(p_data, 1, length, p_file) == length;
+	if (p_file == NULL || fclose(p_file) != 0 || !written)
+	{
+		fprintf(stderr, "\n[SDF font generator] Could not write: %s", argv[2]);
+		free(p_data);
+		return EXIT_FAILURE;
+	}
+
+	printf("\n[SDF font generator] %s: %dx%d distance field in %zu bytes\n", argv[2], field_width, field_height, length);
+	free(p_data);
+	return EXIT_SUCCESS;
+}